@@ -76,6 +76,45 @@ int32_t SoftBusDecryptData(AesGcmCipherKey *key, const unsigned char *input, uin
 int32_t SoftBusDecryptDataWithSeq(AesGcmCipherKey *cipherKey, const unsigned char *input, uint32_t inLen,
     unsigned char *encryptData, uint32_t *encryptLen, int32_t seqNum);
 
+/*
+ * Expanded AES-GCM key of one session key, set up once and shared by every packet of its owner.
+ * Reference counted: whoever hands the context to another thread takes a reference for it.
+ */
+typedef struct SoftBusCipherCtx SoftBusCipherCtx;
+
+SoftBusCipherCtx *SoftBusCreateCipherCtx(const unsigned char *key, uint32_t keyLen);
+
+void SoftBusAcquireCipherCtx(SoftBusCipherCtx *ctx);
+
+/* drops one reference, the last one wipes the key schedule */
+void SoftBusReleaseCipherCtx(SoftBusCipherCtx *ctx);
+
+/*
+ * Same wire format as SoftBusEncryptDataWithSeq. *outLen holds the capacity of output on entry and the
+ * sealed length on return. input may sit at output + GCM_IV_LEN to seal in place.
+ */
+int32_t SoftBusCipherCtxSeal(SoftBusCipherCtx *ctx, int32_t seqNum, const unsigned char *input, uint32_t inLen,
+    unsigned char *output, uint32_t *outLen);
+
+/* *outLen as for SoftBusCipherCtxSeal, output may be input + GCM_IV_LEN to open in place */
+int32_t SoftBusCipherCtxOpen(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *output, uint32_t *outLen);
+
+typedef struct {
+    int32_t seqNum; /* seal only */
+    const unsigned char *input;
+    uint32_t inLen;
+    unsigned char *output;
+    uint32_t outLen; /* capacity on entry, result length on return */
+} SoftBusCipherBatchItem;
+
+/*
+ * Seal or open every item in order with one lock round on ctx, each item as its single call would.
+ * Stops at the first failing item and returns its error, that item and the ones after it get outLen 0.
+ */
+int32_t SoftBusCipherCtxSealBatch(SoftBusCipherCtx *ctx, SoftBusCipherBatchItem *items, uint32_t num);
+int32_t SoftBusCipherCtxOpenBatch(SoftBusCipherCtx *ctx, SoftBusCipherBatchItem *items, uint32_t num);
+
 #endif
 
 #ifdef __cplusplus
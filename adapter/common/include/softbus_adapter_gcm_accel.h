@@ -0,0 +1,54 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOFTBUS_ADAPTER_GCM_ACCEL_H
+#define SOFTBUS_ADAPTER_GCM_ACCEL_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/*
+ * AES-GCM on the AES and carry-less multiply instructions of the cpu (AES-NI/PCLMULQDQ on x86_64,
+ * the ARMv8 Crypto Extensions on aarch64). Built with SOFTBUS_CRYPTO_ACCEL, softbus_adapter_crypto.c
+ * picks it over mbedtls for SoftBusCipherCtx when SoftBusGcmAccelSupported() is true.
+ */
+typedef struct SoftBusGcmAccelKey SoftBusGcmAccelKey;
+
+/* cpu features are probed on the first call only */
+bool SoftBusGcmAccelSupported(void);
+
+/* a key seals or opens, never both; one key must not be used by two threads at once */
+SoftBusGcmAccelKey *SoftBusGcmAccelCreateKey(const unsigned char *key, uint32_t keyLen, bool seal);
+void SoftBusGcmAccelDestroyKey(SoftBusGcmAccelKey *key);
+
+/* iv is GCM_IV_LEN and tag TAG_LEN bytes, input and output may be the same buffer */
+int32_t SoftBusGcmAccelSeal(SoftBusGcmAccelKey *key, const unsigned char *iv, const unsigned char *input,
+    uint32_t inLen, unsigned char *output, unsigned char *tag);
+int32_t SoftBusGcmAccelOpen(SoftBusGcmAccelKey *key, const unsigned char *iv, const unsigned char *input,
+    uint32_t inLen, const unsigned char *tag, unsigned char *output);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* SOFTBUS_ADAPTER_GCM_ACCEL_H */
@@ -21,8 +21,13 @@
 #include "mbedtls/entropy.h"
 #include "mbedtls/gcm.h"
 #include "softbus_adapter_log.h"
+#include "softbus_adapter_mem.h"
 #include "softbus_errcode.h"
 
+#ifdef SOFTBUS_CRYPTO_ACCEL
+#include "softbus_adapter_gcm_accel.h"
+#endif
+
 #ifndef MBEDTLS_CTR_DRBG_C
 #define MBEDTLS_CTR_DRBG_C
 #endif
@@ -33,6 +38,22 @@
 
 static pthread_mutex_t g_randomLock = PTHREAD_MUTEX_INITIALIZER;
 
+#define IV_SEQ_LEN sizeof(int32_t)
+
+struct SoftBusCipherCtx {
+    pthread_mutex_t sealLock; /* also guards refCount */
+    mbedtls_gcm_context sealCtx;
+    uint64_t ivCounter;
+    int32_t refCount;
+    pthread_mutex_t openLock;
+    mbedtls_gcm_context openCtx;
+#ifdef SOFTBUS_CRYPTO_ACCEL
+    /* set instead of the mbedtls contexts when the cpu accelerates AES-GCM, guarded by the same locks */
+    SoftBusGcmAccelKey *sealAccel;
+    SoftBusGcmAccelKey *openAccel;
+#endif
+};
+
 static int32_t MbedAesGcmEncrypt(const AesGcmCipherKey *cipherkey, const unsigned char *plainText,
     uint32_t plainTextSize, unsigned char *cipherText, uint32_t cipherTextLen)
 {
@@ -237,4 +258,239 @@ int32_t SoftBusDecryptDataWithSeq(AesGcmCipherKey *cipherKey, const unsigned cha
     unsigned char *decryptData, uint32_t *decryptLen, int32_t seqNum)
 {
     return SoftBusDecryptData(cipherKey, input, inLen, decryptData, decryptLen);
-}
\ No newline at end of file
+}
+
+static void FreeCipherCtx(SoftBusCipherCtx *ctx)
+{
+    mbedtls_gcm_free(&ctx->sealCtx);
+    mbedtls_gcm_free(&ctx->openCtx);
+#ifdef SOFTBUS_CRYPTO_ACCEL
+    SoftBusGcmAccelDestroyKey(ctx->sealAccel);
+    SoftBusGcmAccelDestroyKey(ctx->openAccel);
+#endif
+    (void)pthread_mutex_destroy(&ctx->sealLock);
+    (void)pthread_mutex_destroy(&ctx->openLock);
+    (void)memset_s(ctx, sizeof(SoftBusCipherCtx), 0, sizeof(SoftBusCipherCtx));
+    SoftBusFree(ctx);
+}
+
+SoftBusCipherCtx *SoftBusCreateCipherCtx(const unsigned char *key, uint32_t keyLen)
+{
+    if (key == NULL || (keyLen * KEY_BITS_UNIT != GCM_KEY_BITS_LEN_128 &&
+        keyLen * KEY_BITS_UNIT != GCM_KEY_BITS_LEN_256)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "create cipher ctx invalid para");
+        return NULL;
+    }
+    SoftBusCipherCtx *ctx = (SoftBusCipherCtx *)SoftBusCalloc(sizeof(SoftBusCipherCtx));
+    if (ctx == NULL) {
+        return NULL;
+    }
+    mbedtls_gcm_init(&ctx->sealCtx);
+    mbedtls_gcm_init(&ctx->openCtx);
+    (void)pthread_mutex_init(&ctx->sealLock, NULL);
+    (void)pthread_mutex_init(&ctx->openLock, NULL);
+    ctx->refCount = 1;
+    /* a random start keeps the counter half of the iv unique across contexts sharing a key */
+    if (SoftBusGenerateRandomArray((unsigned char *)&ctx->ivCounter, sizeof(ctx->ivCounter)) != SOFTBUS_OK) {
+        FreeCipherCtx(ctx);
+        return NULL;
+    }
+#ifdef SOFTBUS_CRYPTO_ACCEL
+    if (SoftBusGcmAccelSupported()) {
+        ctx->sealAccel = SoftBusGcmAccelCreateKey(key, keyLen, true);
+        ctx->openAccel = SoftBusGcmAccelCreateKey(key, keyLen, false);
+        if (ctx->sealAccel == NULL || ctx->openAccel == NULL) {
+            HILOG_ERROR(SOFTBUS_HILOG_ID, "create cipher ctx accel key fail");
+            FreeCipherCtx(ctx);
+            return NULL;
+        }
+        return ctx;
+    }
+#endif
+    if (mbedtls_gcm_setkey(&ctx->sealCtx, MBEDTLS_CIPHER_ID_AES, key, keyLen * KEY_BITS_UNIT) != 0 ||
+        mbedtls_gcm_setkey(&ctx->openCtx, MBEDTLS_CIPHER_ID_AES, key, keyLen * KEY_BITS_UNIT) != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "create cipher ctx setkey fail");
+        FreeCipherCtx(ctx);
+        return NULL;
+    }
+    return ctx;
+}
+
+void SoftBusAcquireCipherCtx(SoftBusCipherCtx *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&ctx->sealLock);
+    ctx->refCount++;
+    (void)pthread_mutex_unlock(&ctx->sealLock);
+}
+
+void SoftBusReleaseCipherCtx(SoftBusCipherCtx *ctx)
+{
+    if (ctx == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&ctx->sealLock);
+    int32_t refCount = --ctx->refCount;
+    (void)pthread_mutex_unlock(&ctx->sealLock);
+    if (refCount == 0) {
+        FreeCipherCtx(ctx);
+    }
+}
+
+static bool IsSealParaValid(const unsigned char *input, uint32_t inLen, const unsigned char *output,
+    const uint32_t *outLen)
+{
+    return input != NULL && inLen != 0 && output != NULL && outLen != NULL &&
+        inLen <= UINT32_MAX - OVERHEAD_LEN && *outLen >= inLen + OVERHEAD_LEN;
+}
+
+static bool IsOpenParaValid(const unsigned char *input, uint32_t inLen, const unsigned char *output,
+    const uint32_t *outLen)
+{
+    return input != NULL && inLen > OVERHEAD_LEN && output != NULL && outLen != NULL &&
+        *outLen >= inLen - OVERHEAD_LEN;
+}
+
+/* caller holds sealLock and has taken counter from ivCounter */
+static int32_t SealLocked(SoftBusCipherCtx *ctx, int32_t seqNum, uint64_t counter, const unsigned char *input,
+    uint32_t inLen, unsigned char *output, uint32_t *outLen)
+{
+    /* seq first as SoftBusEncryptDataWithSeq does, a per context counter instead of fresh randomness after it */
+    unsigned char iv[GCM_IV_LEN];
+    if (memcpy_s(iv, sizeof(iv), &seqNum, IV_SEQ_LEN) != EOK ||
+        memcpy_s(iv + IV_SEQ_LEN, sizeof(iv) - IV_SEQ_LEN, &counter, sizeof(counter)) != EOK) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    int32_t ret;
+#ifdef SOFTBUS_CRYPTO_ACCEL
+    if (ctx->sealAccel != NULL) {
+        ret = SoftBusGcmAccelSeal(ctx->sealAccel, iv, input, inLen, output + GCM_IV_LEN,
+            output + GCM_IV_LEN + inLen);
+    } else
+#endif
+    {
+        ret = mbedtls_gcm_crypt_and_tag(&ctx->sealCtx, MBEDTLS_GCM_ENCRYPT, inLen, iv, GCM_IV_LEN, NULL, 0,
+            input, output + GCM_IV_LEN, TAG_LEN, output + GCM_IV_LEN + inLen);
+    }
+    if (ret != 0 || memcpy_s(output, *outLen, iv, GCM_IV_LEN) != EOK) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "seal fail.[%d]", ret);
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    *outLen = inLen + OVERHEAD_LEN;
+    return SOFTBUS_OK;
+}
+
+/* caller holds openLock */
+static int32_t OpenLocked(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *output, uint32_t *outLen)
+{
+    uint32_t plainLen = inLen - OVERHEAD_LEN;
+    int32_t ret;
+#ifdef SOFTBUS_CRYPTO_ACCEL
+    if (ctx->openAccel != NULL) {
+        ret = SoftBusGcmAccelOpen(ctx->openAccel, input, input + GCM_IV_LEN, plainLen,
+            input + GCM_IV_LEN + plainLen, output);
+    } else
+#endif
+    {
+        ret = mbedtls_gcm_auth_decrypt(&ctx->openCtx, plainLen, input, GCM_IV_LEN, NULL, 0,
+            input + GCM_IV_LEN + plainLen, TAG_LEN, input + GCM_IV_LEN, output);
+    }
+    if (ret != 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "open fail.[%d]", ret);
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    *outLen = plainLen;
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusCipherCtxSeal(SoftBusCipherCtx *ctx, int32_t seqNum, const unsigned char *input, uint32_t inLen,
+    unsigned char *output, uint32_t *outLen)
+{
+    if (ctx == NULL || !IsSealParaValid(input, inLen, output, outLen)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "seal invalid para");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    (void)pthread_mutex_lock(&ctx->sealLock);
+    int32_t ret = SealLocked(ctx, seqNum, ctx->ivCounter++, input, inLen, output, outLen);
+    (void)pthread_mutex_unlock(&ctx->sealLock);
+    return ret;
+}
+
+int32_t SoftBusCipherCtxOpen(SoftBusCipherCtx *ctx, const unsigned char *input, uint32_t inLen,
+    unsigned char *output, uint32_t *outLen)
+{
+    if (ctx == NULL || !IsOpenParaValid(input, inLen, output, outLen)) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "open invalid para");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    (void)pthread_mutex_lock(&ctx->openLock);
+    int32_t ret = OpenLocked(ctx, input, inLen, output, outLen);
+    (void)pthread_mutex_unlock(&ctx->openLock);
+    return ret;
+}
+
+static void ClearBatchOutLen(SoftBusCipherBatchItem *items, uint32_t from, uint32_t num)
+{
+    for (uint32_t i = from; i < num; i++) {
+        items[i].outLen = 0;
+    }
+}
+
+int32_t SoftBusCipherCtxSealBatch(SoftBusCipherCtx *ctx, SoftBusCipherBatchItem *items, uint32_t num)
+{
+    if (ctx == NULL || items == NULL || num == 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "seal batch invalid para");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        if (!IsSealParaValid(items[i].input, items[i].inLen, items[i].output, &items[i].outLen)) {
+            HILOG_ERROR(SOFTBUS_HILOG_ID, "seal batch invalid item %u", i);
+            ClearBatchOutLen(items, 0, num);
+            return SOFTBUS_INVALID_PARAM;
+        }
+    }
+    int32_t ret = SOFTBUS_OK;
+    (void)pthread_mutex_lock(&ctx->sealLock);
+    /* one lock round and one contiguous run of iv counters for the whole batch */
+    uint64_t counter = ctx->ivCounter;
+    ctx->ivCounter += num;
+    for (uint32_t i = 0; i < num; i++) {
+        ret = SealLocked(ctx, items[i].seqNum, counter + i, items[i].input, items[i].inLen,
+            items[i].output, &items[i].outLen);
+        if (ret != SOFTBUS_OK) {
+            ClearBatchOutLen(items, i, num);
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&ctx->sealLock);
+    return ret;
+}
+
+int32_t SoftBusCipherCtxOpenBatch(SoftBusCipherCtx *ctx, SoftBusCipherBatchItem *items, uint32_t num)
+{
+    if (ctx == NULL || items == NULL || num == 0) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "open batch invalid para");
+        return SOFTBUS_INVALID_PARAM;
+    }
+    for (uint32_t i = 0; i < num; i++) {
+        if (!IsOpenParaValid(items[i].input, items[i].inLen, items[i].output, &items[i].outLen)) {
+            HILOG_ERROR(SOFTBUS_HILOG_ID, "open batch invalid item %u", i);
+            ClearBatchOutLen(items, 0, num);
+            return SOFTBUS_INVALID_PARAM;
+        }
+    }
+    int32_t ret = SOFTBUS_OK;
+    (void)pthread_mutex_lock(&ctx->openLock);
+    for (uint32_t i = 0; i < num; i++) {
+        ret = OpenLocked(ctx, items[i].input, items[i].inLen, items[i].output, &items[i].outLen);
+        if (ret != SOFTBUS_OK) {
+            ClearBatchOutLen(items, i, num);
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&ctx->openLock);
+    return ret;
+}
@@ -0,0 +1,151 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softbus_adapter_gcm_accel.h"
+
+#include <pthread.h>
+
+#include <openssl/evp.h>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <cpuid.h>
+#elif defined(__aarch64__)
+#include <asm/hwcap.h>
+#include <sys/auxv.h>
+#endif
+
+#include "softbus_adapter_crypto.h"
+#include "softbus_adapter_log.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_errcode.h"
+
+#define CPUID_FEATURE_LEAF 1
+
+struct SoftBusGcmAccelKey {
+    EVP_CIPHER_CTX *evp;
+    bool seal;
+};
+
+static pthread_once_t g_probeOnce = PTHREAD_ONCE_INIT;
+static bool g_accelSupported = false;
+
+static void ProbeCpuFeatures(void)
+{
+#if defined(__x86_64__) || defined(__i386__)
+    unsigned int eax = 0;
+    unsigned int ebx = 0;
+    unsigned int ecx = 0;
+    unsigned int edx = 0;
+    if (__get_cpuid(CPUID_FEATURE_LEAF, &eax, &ebx, &ecx, &edx) != 0) {
+        g_accelSupported = ((ecx & bit_AES) != 0) && ((ecx & bit_PCLMUL) != 0);
+    }
+#elif defined(__aarch64__)
+    unsigned long hwcap = getauxval(AT_HWCAP);
+    g_accelSupported = ((hwcap & HWCAP_AES) != 0) && ((hwcap & HWCAP_PMULL) != 0);
+#endif
+    HILOG_INFO(SOFTBUS_HILOG_ID, "aes-gcm cpu acceleration %s", g_accelSupported ? "on" : "off");
+}
+
+bool SoftBusGcmAccelSupported(void)
+{
+    (void)pthread_once(&g_probeOnce, ProbeCpuFeatures);
+    return g_accelSupported;
+}
+
+SoftBusGcmAccelKey *SoftBusGcmAccelCreateKey(const unsigned char *key, uint32_t keyLen, bool seal)
+{
+    const EVP_CIPHER *cipher = NULL;
+    if (key == NULL) {
+        return NULL;
+    }
+    if (keyLen * KEY_BITS_UNIT == GCM_KEY_BITS_LEN_128) {
+        cipher = EVP_aes_128_gcm();
+    } else if (keyLen * KEY_BITS_UNIT == GCM_KEY_BITS_LEN_256) {
+        cipher = EVP_aes_256_gcm();
+    } else {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "accel key invalid len %u", keyLen);
+        return NULL;
+    }
+    SoftBusGcmAccelKey *accelKey = (SoftBusGcmAccelKey *)SoftBusCalloc(sizeof(SoftBusGcmAccelKey));
+    if (accelKey == NULL) {
+        return NULL;
+    }
+    accelKey->seal = seal;
+    accelKey->evp = EVP_CIPHER_CTX_new();
+    if (accelKey->evp == NULL) {
+        SoftBusFree(accelKey);
+        return NULL;
+    }
+    /* the key schedule is expanded here once, every packet only sets its iv */
+    int32_t ret = seal ? EVP_EncryptInit_ex(accelKey->evp, cipher, NULL, NULL, NULL) :
+        EVP_DecryptInit_ex(accelKey->evp, cipher, NULL, NULL, NULL);
+    if (ret != 1 || EVP_CIPHER_CTX_ctrl(accelKey->evp, EVP_CTRL_GCM_SET_IVLEN, GCM_IV_LEN, NULL) != 1 ||
+        (seal ? EVP_EncryptInit_ex(accelKey->evp, NULL, NULL, key, NULL) :
+        EVP_DecryptInit_ex(accelKey->evp, NULL, NULL, key, NULL)) != 1) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "accel key init fail");
+        SoftBusGcmAccelDestroyKey(accelKey);
+        return NULL;
+    }
+    return accelKey;
+}
+
+void SoftBusGcmAccelDestroyKey(SoftBusGcmAccelKey *key)
+{
+    if (key == NULL) {
+        return;
+    }
+    /* EVP_CIPHER_CTX_free cleanses the expanded key */
+    EVP_CIPHER_CTX_free(key->evp);
+    SoftBusFree(key);
+}
+
+int32_t SoftBusGcmAccelSeal(SoftBusGcmAccelKey *key, const unsigned char *iv, const unsigned char *input,
+    uint32_t inLen, unsigned char *output, unsigned char *tag)
+{
+    if (key == NULL || !key->seal || iv == NULL || input == NULL || output == NULL || tag == NULL ||
+        inLen > INT32_MAX) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    int32_t len = 0;
+    int32_t finalLen = 0;
+    if (EVP_EncryptInit_ex(key->evp, NULL, NULL, NULL, iv) != 1 ||
+        EVP_EncryptUpdate(key->evp, output, &len, input, (int32_t)inLen) != 1 ||
+        EVP_EncryptFinal_ex(key->evp, output + len, &finalLen) != 1 ||
+        (uint32_t)(len + finalLen) != inLen ||
+        EVP_CIPHER_CTX_ctrl(key->evp, EVP_CTRL_GCM_GET_TAG, TAG_LEN, tag) != 1) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "accel seal fail");
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return SOFTBUS_OK;
+}
+
+int32_t SoftBusGcmAccelOpen(SoftBusGcmAccelKey *key, const unsigned char *iv, const unsigned char *input,
+    uint32_t inLen, const unsigned char *tag, unsigned char *output)
+{
+    if (key == NULL || key->seal || iv == NULL || input == NULL || output == NULL || tag == NULL ||
+        inLen > INT32_MAX) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    int32_t len = 0;
+    int32_t finalLen = 0;
+    if (EVP_DecryptInit_ex(key->evp, NULL, NULL, NULL, iv) != 1 ||
+        EVP_DecryptUpdate(key->evp, output, &len, input, (int32_t)inLen) != 1 ||
+        EVP_CIPHER_CTX_ctrl(key->evp, EVP_CTRL_GCM_SET_TAG, TAG_LEN, (void *)tag) != 1 ||
+        EVP_DecryptFinal_ex(key->evp, output + len, &finalLen) != 1) {
+        HILOG_ERROR(SOFTBUS_HILOG_ID, "accel open fail");
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    return SOFTBUS_OK;
+}
@@ -73,17 +73,16 @@ int32_t __attribute__ ((weak)) OpenAuthServer(void)
 
 static int32_t EventInLooper(int64_t authId)
 {
-    SoftBusMessage *msgDelay = (SoftBusMessage *)SoftBusMalloc(sizeof(SoftBusMessage));
+    SoftBusMessage *msgDelay = MallocMessage();
     if (msgDelay == NULL) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusMalloc failed");
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "MallocMessage failed");
         return SOFTBUS_ERR;
     }
-    (void)memset_s(msgDelay, sizeof(SoftBusMessage), 0, sizeof(SoftBusMessage));
     msgDelay->arg1 = (uint64_t)authId;
     msgDelay->handler = &g_authHandler;
     if (g_authHandler.looper == NULL || g_authHandler.looper->PostMessageDelay == NULL) {
         SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "softbus handler is null");
-        SoftBusFree(msgDelay);
+        FreeMessage(msgDelay);
         return SOFTBUS_ERR;
     }
     g_authHandler.looper->PostMessageDelay(g_authHandler.looper, msgDelay, AUTH_DELAY_MS);
@@ -33,6 +33,13 @@ void AuthSessionKeyListInit(void)
     ListInit(&g_sessionKeyListHead);
 }
 
+static void AuthFreeSessionKey(SessionKeyList *sessionKeyList)
+{
+    SoftBusReleaseCipherCtx(sessionKeyList->cipherCtx);
+    (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
+    SoftBusFree(sessionKeyList);
+}
+
 void AuthSetLocalSessionKey(const NecessaryDevInfo *devInfo, const char *peerUdid,
     const uint8_t *sessionKey, uint32_t sessionKeyLen)
 {
@@ -49,9 +56,8 @@ void AuthSetLocalSessionKey(const NecessaryDevInfo *devInfo, const char *peerUdi
     if (listSize == MAX_KEY_LIST_SIZE) {
         item = GET_LIST_TAIL(&g_sessionKeyListHead);
         sessionKeyList = LIST_ENTRY(item, SessionKeyList, node);
-        (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
         ListDelete(&sessionKeyList->node);
-        SoftBusFree(sessionKeyList);
+        AuthFreeSessionKey(sessionKeyList);
         sessionKeyList = NULL;
     }
     sessionKeyList = (SessionKeyList *)SoftBusMalloc(sizeof(SessionKeyList));
@@ -80,6 +86,12 @@ void AuthSetLocalSessionKey(const NecessaryDevInfo *devInfo, const char *peerUdi
         return;
     }
     sessionKeyList->sessionKeyLen = sessionKeyLen;
+    sessionKeyList->cipherCtx = SoftBusCreateCipherCtx(sessionKeyList->sessionKey, SESSION_KEY_LENGTH);
+    if (sessionKeyList->cipherCtx == NULL) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "create cipher ctx failed");
+        AuthFreeSessionKey(sessionKeyList);
+        return;
+    }
     SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_INFO, "auth add sessionkey, seq is:%d", sessionKeyList->seq);
     ListNodeInsert(&g_sessionKeyListHead, &sessionKeyList->node);
 }
@@ -214,15 +226,10 @@ int32_t AuthEncryptBySeq(int32_t seq, AuthSideFlag *side, uint8_t *data, uint32_
         SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusEncryptDataWithSeq(&cipherKey, data, len, outBuf->buf + MESSAGE_INDEX_LEN,
-        &outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusEncryptDataWithSeq failed");
+    outLen = outBuf->bufLen - MESSAGE_INDEX_LEN;
+    if (SoftBusCipherCtxSeal(sessionKeyList->cipherCtx, sessionKeyList->seq, data, len,
+        outBuf->buf + MESSAGE_INDEX_LEN, &outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusCipherCtxSeal failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     outBuf->outLen = outLen + MESSAGE_INDEX_LEN;
@@ -258,15 +265,10 @@ int32_t AuthEncrypt(const ConnectOption *option, AuthSideFlag *side, uint8_t *da
         SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusEncryptDataWithSeq(&cipherKey, data, len, outBuf->buf + MESSAGE_INDEX_LEN,
-        &outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusEncryptDataWithSeq failed");
+    outLen = outBuf->bufLen - MESSAGE_INDEX_LEN;
+    if (SoftBusCipherCtxSeal(sessionKeyList->cipherCtx, sessionKeyList->seq, data, len,
+        outBuf->buf + MESSAGE_INDEX_LEN, &outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusCipherCtxSeal failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     outBuf->outLen = outLen + MESSAGE_INDEX_LEN;
@@ -303,15 +305,9 @@ int32_t AuthDecrypt(const ConnectOption *option, AuthSideFlag side, uint8_t *dat
         return SOFTBUS_ENCRYPT_ERR;
     }
 
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKeyList->sessionKey, sessionKeyList->sessionKeyLen) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "memcpy_s failed");
-        return SOFTBUS_ENCRYPT_ERR;
-    }
-    if (SoftBusDecryptDataWithSeq(&cipherKey, data, len, outBuf->buf,
-        &outBuf->outLen, sessionKeyList->seq) != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusDecryptDataWithSeq failed");
+    outBuf->outLen = outBuf->bufLen;
+    if (SoftBusCipherCtxOpen(sessionKeyList->cipherCtx, data, len, outBuf->buf, &outBuf->outLen) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_AUTH, SOFTBUS_LOG_ERROR, "SoftBusCipherCtxOpen failed");
         return SOFTBUS_ENCRYPT_ERR;
     }
     return SOFTBUS_OK;
@@ -334,9 +330,8 @@ void AuthClearSessionKeyBySeq(int32_t seq)
     LIST_FOR_EACH_SAFE(item, tmp, &g_sessionKeyListHead) {
         sessionKeyList = LIST_ENTRY(item, SessionKeyList, node);
         if (sessionKeyList->seq == seq) {
-            (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
             ListDelete(&sessionKeyList->node);
-            SoftBusFree(sessionKeyList);
+            AuthFreeSessionKey(sessionKeyList);
             sessionKeyList = NULL;
         }
     }
@@ -352,9 +347,8 @@ void AuthClearAllSessionKey(void)
     ListNode *tmp = NULL;
     LIST_FOR_EACH_SAFE(item, tmp, &g_sessionKeyListHead) {
         sessionKeyList = LIST_ENTRY(item, SessionKeyList, node);
-        (void)memset_s(sessionKeyList->sessionKey, SESSION_KEY_LENGTH, 0, SESSION_KEY_LENGTH);
         ListDelete(&sessionKeyList->node);
-        SoftBusFree(sessionKeyList);
+        AuthFreeSessionKey(sessionKeyList);
         sessionKeyList = NULL;
     }
     ListInit(&g_sessionKeyListHead);
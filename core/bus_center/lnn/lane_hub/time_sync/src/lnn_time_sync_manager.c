@@ -402,7 +402,7 @@ static void TimeSyncMessageHandler(SoftBusMessage *msg)
 
 static SoftBusMessage *CreateTimeSyncMessage(int32_t msgType, void *para)
 {
-    SoftBusMessage *msg = (SoftBusMessage *)SoftBusCalloc(sizeof(SoftBusMessage));
+    SoftBusMessage *msg = MallocMessage();
     if (msg == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "malloc time sync message failed");
         return NULL;
@@ -116,7 +116,7 @@ static void NetBuilderConfigInit(void)
 
 static SoftBusMessage *CreateNetBuilderMessage(int32_t msgType, void *para)
 {
-    SoftBusMessage *msg = (SoftBusMessage *)SoftBusCalloc(sizeof(SoftBusMessage));
+    SoftBusMessage *msg = MallocMessage();
     if (msg == NULL) {
         SoftBusLog(SOFTBUS_LOG_LNN, SOFTBUS_LOG_ERROR, "malloc softbus message failed");
         return NULL;
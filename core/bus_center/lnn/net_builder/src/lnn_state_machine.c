@@ -50,8 +50,8 @@ static void FreeFsmHandleMsg(SoftBusMessage *msg)
     if (msg != NULL) {
         if (msg->obj != NULL) {
             SoftBusFree(msg->obj);
+            msg->obj = NULL;
         }
-        SoftBusFree(msg);
     }
 }
 
@@ -72,7 +72,7 @@ static SoftBusMessage *CreateFsmHandleMsg(FsmStateMachine *fsm,
     SoftBusMessage *msg = NULL;
     FsmCtrlMsgObj *ctrlMsgObj = NULL;
 
-    msg = SoftBusCalloc(sizeof(*msg));
+    msg = MallocMessage();
     if (msg == NULL) {
         return NULL;
     }
@@ -84,7 +84,7 @@ static SoftBusMessage *CreateFsmHandleMsg(FsmStateMachine *fsm,
 
     ctrlMsgObj = SoftBusMalloc(sizeof(*ctrlMsgObj));
     if (ctrlMsgObj == NULL) {
-        SoftBusFree(msg);
+        FreeMessage(msg);
         return NULL;
     }
     ctrlMsgObj->fsm = fsm;
@@ -60,6 +60,7 @@ enum SoftBusErrNo {
     SOFTBUS_TRANS_UDP_START_STREAM_SERVER_FAILED,
     SOFTBUS_TRANS_UDP_START_STREAM_CLIENT_FAILED,
     SOFTBUS_TRANS_UDP_SEND_STREAM_FAILED,
+    SOFTBUS_TRANS_PENDING_CHANNEL_CLOSED,
 
     SOFTBUS_AUTH_ERR_BASE = (-9000),
     SOFTBUS_AUTH_VERIFIED,
@@ -0,0 +1,56 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOFTBUS_TIMER_WHEEL_H
+#define SOFTBUS_TIMER_WHEEL_H
+
+#include <stdint.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+/*
+ * Hierarchical timing wheel on the TIMER_TIMEOUT tick of softbus_utils. Timers are keyed by the
+ * SoftBusTimerFunEnum id of their owner and an owner chosen key (a channel or session id), so the owner
+ * never hands out pointers to objects it may free. A tick costs O(expired), arming and cancelling O(1).
+ *
+ * An owner that sees traffic far more often than its deadline should not re-arm per packet: it stamps
+ * TimerWheelNow() on the object and, when the timer fires, re-arms for whatever is left of the deadline.
+ */
+typedef void (*TimerWheelExpireCb)(uint32_t key);
+
+/* cb runs on the timer thread without any wheel lock held, it may arm or cancel timers itself */
+int32_t TimerWheelRegister(int32_t timerFunId, TimerWheelExpireCb cb);
+
+/* (re)schedules key to fire ticks from now, a timer already armed for key is moved */
+int32_t TimerWheelArm(int32_t timerFunId, uint32_t key, uint32_t ticks);
+void TimerWheelCancel(int32_t timerFunId, uint32_t key);
+
+/* ticks since start, wraps; compare with unsigned subtraction only */
+uint32_t TimerWheelNow(void);
+
+/* advances the wheel one tick and runs what expired, driven by the softbus timer */
+void TimerWheelTick(void);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* SOFTBUS_TIMER_WHEEL_H */
@@ -45,6 +45,7 @@ typedef enum {
     SOFTBUS_TCP_DIRECTCHANNEL_TIMER_FUN,
     SOFTBUS_UDP_CHANNEL_TIMER_FUN,
     SOFTBUS_TIME_SYNC_TIMER_FUN,
+    SOFTBUS_PENDING_PKT_TIMER_FUN,
     SOFTBUS_MAX_TIMER_FUN_NUM
 } SoftBusTimerFunEnum;
 
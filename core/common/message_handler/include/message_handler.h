@@ -51,8 +51,18 @@ struct SoftBusMessage {
     void *obj;
     SoftBusHandler *handler;
     void (*FreeMessage)(SoftBusMessage *msg);
+    // on a looper group, messages with the same handler and affinity are handled in post order
+    uint32_t affinity;
+    // owned by the looper while the message is queued, do not touch
+    SoftBusMessage *next;
+    uint64_t seq;
+    uint64_t enqueueTime;
+    uint8_t pooled; // set by MallocMessage
 };
 
+// MallocMessage reuses messages released by FreeMessage or by the looper before falling back to the heap.
+// The FreeMessage callback of such a message releases obj only, the message itself goes back to the pool;
+// a message allocated by its owner has FreeMessage release all of it.
 SoftBusMessage *MallocMessage(void);
 
 void FreeMessage(SoftBusMessage *msg);
@@ -72,8 +82,47 @@ void LooperDeinit(void);
 
 void DumpLooper(const SoftBusLooper *looper);
 
+#define LOOPER_STATS_NAME_LEN 32
+// upper bounds in microseconds: 100us, 1ms, 5ms, 10ms, 50ms, 100ms, 500ms, 1s, and one bucket above 1s
+#define LOOPER_HISTOGRAM_BUCKET_NUM 9
+
+typedef struct {
+    uint64_t count;
+    uint64_t totalMicros;
+    uint64_t maxMicros;
+    uint64_t buckets[LOOPER_HISTOGRAM_BUCKET_NUM];
+} SoftBusLatencyHistogram;
+
+typedef struct {
+    char name[LOOPER_STATS_NAME_LEN];
+    uint32_t queueDepth;
+    uint32_t queueDepthHighWater;
+    uint64_t postCount;
+    uint64_t dispatchCount;
+    uint64_t removeCount; // removed by RemoveMessage/RemoveMessageCustom before dispatch
+    SoftBusLatencyHistogram dispatchLatency; // from the time a message is posted until it is dispatched
+} SoftBusLooperStats;
+
+typedef struct {
+    char handlerName[LOOPER_STATS_NAME_LEN];
+    int32_t what;
+    SoftBusLatencyHistogram execTime;
+} SoftBusHandlerStats;
+
+// a looper group reports the sum of its members, except for the high-water mark of its own total depth
+int GetLooperStats(const SoftBusLooper *looper, SoftBusLooperStats *stats);
+
+// num is the capacity of stats on input and the number of entries filled on output
+int GetLooperHandlerStats(const SoftBusLooper *looper, SoftBusHandlerStats *stats, uint32_t *num);
+
+// writes the stats of every running looper to fd
+void DumpLooperStats(int fd);
+
 SoftBusLooper *CreateNewLooper(const char *name);
 
+// threadNum worker threads behind one looper, messages are spread by (handler, affinity)
+SoftBusLooper *CreateNewLooperGroup(const char *name, uint32_t threadNum);
+
 void DestroyLooper(SoftBusLooper *looper);
 
 #ifdef __cplusplus
@@ -15,8 +15,9 @@
 
 #include "message_handler.h"
 
-#include <sys/time.h>
+#include <stdarg.h>
 #include <sys/types.h>
+#include <time.h>
 
 #include "common_list.h"
 #include "securec.h"
@@ -28,17 +29,59 @@
 
 #define LOOP_NAME_LEN 16
 #define TIME_THOUSANDS_MULTIPLIER 1000LL
+#define MSG_HEAP_INIT_CAPACITY 16
+#define MSG_HEAP_GROW_FACTOR 2
+#define MSG_POOL_MAX_FREE 64
+#define LOOPER_GROUP_MAX_THREAD 8
+#define LOOPER_GROUP_INDEX_LEN 3
+#define HANDLER_STATS_SLOT_NUM 64 // the last slot collects whatever does not fit
+#define HANDLER_STATS_OTHERS_WHAT (-1)
+#define STATS_LINE_LEN 256
 
 static int8_t g_isNeedDestroy = 0;
 static int8_t g_isThreadStarted = 0;
 
+/* messages posted without delay, linked through SoftBusMessage.next */
 typedef struct {
-    SoftBusMessage *msg;
-    ListNode node;
-} SoftBusMessageNode;
+    SoftBusMessage *head;
+    SoftBusMessage *tail;
+} SoftBusMessageQueue;
+
+/* min-heap of delayed messages, ordered by (time, seq) */
+typedef struct {
+    SoftBusMessage **msgs;
+    unsigned int size;
+    unsigned int capacity;
+} SoftBusMessageHeap;
+
+typedef struct {
+    pthread_mutex_t lock;
+    SoftBusMessage *freeList;
+    unsigned int freeCnt;
+} SoftBusMessagePool;
+
+static SoftBusMessagePool g_msgPool = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .freeList = NULL,
+    .freeCnt = 0,
+};
+
+typedef struct {
+    const SoftBusHandler *handler;
+    SoftBusHandlerStats stats;
+} HandlerStatsSlot;
+
+static const uint64_t g_histogramBounds[LOOPER_HISTOGRAM_BUCKET_NUM - 1] = {
+    100, 1000, 5000, 10000, 50000, 100000, 500000, 1000000
+};
+
+static LIST_HEAD(g_looperList);
+static pthread_mutex_t g_looperListLock = PTHREAD_MUTEX_INITIALIZER;
 
 struct SoftBusLooperContext {
-    ListNode msgHead;
+    SoftBusMessageQueue msgQueue;
+    SoftBusMessageHeap delayHeap;
+    uint64_t postSeq;
     char name[LOOP_NAME_LEN];
     volatile unsigned char stop; // destroys looper, stop =1, and running =0
     volatile unsigned char running;
@@ -48,36 +91,89 @@ struct SoftBusLooperContext {
     pthread_mutexattr_t attr;
     pthread_cond_t cond;
     pthread_cond_t condRunning;
+    SoftBusLooper **members; // looper group only, each member runs one worker thread
+    uint32_t memberNum;
+    SoftBusLooperContext *group; // group member only, the group whose depth counts this member's messages
+    uint32_t groupDepth; // looper group only, messages queued over all members, atomic
+    uint32_t groupDepthHighWater; // looper group only, atomic
+    ListNode node; // in g_looperList while the looper thread is alive
+    SoftBusLooperStats stats;
+    HandlerStatsSlot handlerStats[HANDLER_STATS_SLOT_NUM];
+    uint32_t handlerStatsNum;
 };
 
 static uint64_t UptimeMicros(void)
 {
-    struct timeval t;
+    struct timespec t;
     t.tv_sec = 0;
-    t.tv_usec = 0;
-    gettimeofday(&t, NULL);
+    t.tv_nsec = 0;
+    clock_gettime(CLOCK_MONOTONIC, &t);
     uint64_t when = ((uint64_t)(t.tv_sec)) * TIME_THOUSANDS_MULTIPLIER * TIME_THOUSANDS_MULTIPLIER +
-        (uint64_t)t.tv_usec;
+        (uint64_t)t.tv_nsec / TIME_THOUSANDS_MULTIPLIER;
     return when;
 }
 
+static void RecycleMessage(SoftBusMessage *msg)
+{
+    if (pthread_mutex_lock(&g_msgPool.lock) == 0) {
+        if (g_msgPool.freeCnt < MSG_POOL_MAX_FREE) {
+            msg->next = g_msgPool.freeList;
+            g_msgPool.freeList = msg;
+            g_msgPool.freeCnt++;
+            (void)pthread_mutex_unlock(&g_msgPool.lock);
+            return;
+        }
+        (void)pthread_mutex_unlock(&g_msgPool.lock);
+    }
+    SoftBusFree(msg);
+}
+
+static void DrainMessagePool(void)
+{
+    (void)pthread_mutex_lock(&g_msgPool.lock);
+    SoftBusMessage *msg = g_msgPool.freeList;
+    g_msgPool.freeList = NULL;
+    g_msgPool.freeCnt = 0;
+    (void)pthread_mutex_unlock(&g_msgPool.lock);
+    while (msg != NULL) {
+        SoftBusMessage *next = msg->next;
+        SoftBusFree(msg);
+        msg = next;
+    }
+}
+
 static void FreeSoftBusMsg(SoftBusMessage *msg)
 {
     if (msg->FreeMessage == NULL) {
-        SoftBusFree(msg);
-    } else {
-        msg->FreeMessage(msg);
+        RecycleMessage(msg);
+        return;
+    }
+    msg->FreeMessage(msg);
+    if (msg->pooled != 0) {
+        RecycleMessage(msg);
     }
 }
 
 SoftBusMessage *MallocMessage(void)
 {
-    SoftBusMessage *msg = (SoftBusMessage *)SoftBusMalloc(sizeof(SoftBusMessage));
+    SoftBusMessage *msg = NULL;
+    if (pthread_mutex_lock(&g_msgPool.lock) == 0) {
+        msg = g_msgPool.freeList;
+        if (msg != NULL) {
+            g_msgPool.freeList = msg->next;
+            g_msgPool.freeCnt--;
+        }
+        (void)pthread_mutex_unlock(&g_msgPool.lock);
+    }
+    if (msg == NULL) {
+        msg = (SoftBusMessage *)SoftBusMalloc(sizeof(SoftBusMessage));
+    }
     if (msg == NULL) {
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "malloc SoftBusMessage failed");
         return NULL;
     }
     (void)memset_s(msg, sizeof(SoftBusMessage), 0, sizeof(SoftBusMessage));
+    msg->pooled = 1;
     return msg;
 }
 
@@ -88,6 +184,267 @@ void FreeMessage(SoftBusMessage *msg)
     }
 }
 
+static void QueuePush(SoftBusMessageQueue *queue, SoftBusMessage *msg)
+{
+    msg->next = NULL;
+    if (queue->tail == NULL) {
+        queue->head = msg;
+    } else {
+        queue->tail->next = msg;
+    }
+    queue->tail = msg;
+}
+
+static SoftBusMessage *QueuePop(SoftBusMessageQueue *queue)
+{
+    SoftBusMessage *msg = queue->head;
+    if (msg != NULL) {
+        queue->head = msg->next;
+        if (queue->head == NULL) {
+            queue->tail = NULL;
+        }
+        msg->next = NULL;
+    }
+    return msg;
+}
+
+static bool MsgBefore(const SoftBusMessage *a, const SoftBusMessage *b)
+{
+    if (a->time != b->time) {
+        return a->time < b->time;
+    }
+    return a->seq < b->seq;
+}
+
+static void HeapSwap(SoftBusMessageHeap *heap, unsigned int i, unsigned int j)
+{
+    SoftBusMessage *tmp = heap->msgs[i];
+    heap->msgs[i] = heap->msgs[j];
+    heap->msgs[j] = tmp;
+}
+
+static void HeapSiftUp(SoftBusMessageHeap *heap, unsigned int index)
+{
+    while (index > 0) {
+        unsigned int parent = (index - 1) / 2;
+        if (!MsgBefore(heap->msgs[index], heap->msgs[parent])) {
+            break;
+        }
+        HeapSwap(heap, index, parent);
+        index = parent;
+    }
+}
+
+static void HeapSiftDown(SoftBusMessageHeap *heap, unsigned int index)
+{
+    for (;;) {
+        unsigned int left = index * 2 + 1;
+        unsigned int right = left + 1;
+        unsigned int smallest = index;
+        if (left < heap->size && MsgBefore(heap->msgs[left], heap->msgs[smallest])) {
+            smallest = left;
+        }
+        if (right < heap->size && MsgBefore(heap->msgs[right], heap->msgs[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            return;
+        }
+        HeapSwap(heap, index, smallest);
+        index = smallest;
+    }
+}
+
+static int HeapPush(SoftBusMessageHeap *heap, SoftBusMessage *msg)
+{
+    if (heap->size == heap->capacity) {
+        unsigned int newCapacity = (heap->capacity == 0) ? MSG_HEAP_INIT_CAPACITY :
+            heap->capacity * MSG_HEAP_GROW_FACTOR;
+        SoftBusMessage **newMsgs = (SoftBusMessage **)SoftBusMalloc(newCapacity * sizeof(SoftBusMessage *));
+        if (newMsgs == NULL) {
+            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "grow message heap failed");
+            return -1;
+        }
+        if (heap->size > 0 && memcpy_s(newMsgs, newCapacity * sizeof(SoftBusMessage *), heap->msgs,
+            heap->size * sizeof(SoftBusMessage *)) != EOK) {
+            SoftBusFree(newMsgs);
+            return -1;
+        }
+        SoftBusFree(heap->msgs);
+        heap->msgs = newMsgs;
+        heap->capacity = newCapacity;
+    }
+    heap->msgs[heap->size] = msg;
+    heap->size++;
+    HeapSiftUp(heap, heap->size - 1);
+    return 0;
+}
+
+static SoftBusMessage *HeapTop(const SoftBusMessageHeap *heap)
+{
+    return (heap->size == 0) ? NULL : heap->msgs[0];
+}
+
+static SoftBusMessage *HeapPop(SoftBusMessageHeap *heap)
+{
+    if (heap->size == 0) {
+        return NULL;
+    }
+    SoftBusMessage *top = heap->msgs[0];
+    heap->size--;
+    if (heap->size > 0) {
+        heap->msgs[0] = heap->msgs[heap->size];
+        HeapSiftDown(heap, 0);
+    }
+    return top;
+}
+
+static void HeapBuild(SoftBusMessageHeap *heap)
+{
+    for (unsigned int i = heap->size / 2; i > 0; i--) {
+        HeapSiftDown(heap, i - 1);
+    }
+}
+
+static bool IsLooperEmptyLocked(const SoftBusLooperContext *context)
+{
+    return context->msgQueue.head == NULL && context->delayHeap.size == 0;
+}
+
+/* the earliest message is either the FIFO head or the heap top, whichever is due first */
+static SoftBusMessage *PeekNextMessageLocked(const SoftBusLooperContext *context)
+{
+    SoftBusMessage *delayMsg = HeapTop(&context->delayHeap);
+    SoftBusMessage *fifoMsg = context->msgQueue.head;
+    if (fifoMsg == NULL || (delayMsg != NULL && MsgBefore(delayMsg, fifoMsg))) {
+        return delayMsg;
+    }
+    return fifoMsg;
+}
+
+static void ReleaseQueueDepthLocked(SoftBusLooperContext *context)
+{
+    context->msgSize--;
+    if (context->group != NULL) {
+        (void)__atomic_sub_fetch(&context->group->groupDepth, 1, __ATOMIC_RELAXED);
+    }
+}
+
+static void TakeMessageLocked(SoftBusLooperContext *context, const SoftBusMessage *msg)
+{
+    if (msg == context->msgQueue.head) {
+        (void)QueuePop(&context->msgQueue);
+    } else {
+        (void)HeapPop(&context->delayHeap);
+    }
+    ReleaseQueueDepthLocked(context);
+}
+
+static void HistogramAdd(SoftBusLatencyHistogram *histogram, uint64_t micros)
+{
+    uint32_t i = 0;
+    while (i < LOOPER_HISTOGRAM_BUCKET_NUM - 1 && micros > g_histogramBounds[i]) {
+        i++;
+    }
+    histogram->buckets[i]++;
+    histogram->count++;
+    histogram->totalMicros += micros;
+    if (micros > histogram->maxMicros) {
+        histogram->maxMicros = micros;
+    }
+}
+
+static void HistogramMerge(SoftBusLatencyHistogram *dst, const SoftBusLatencyHistogram *src)
+{
+    for (uint32_t i = 0; i < LOOPER_HISTOGRAM_BUCKET_NUM; i++) {
+        dst->buckets[i] += src->buckets[i];
+    }
+    dst->count += src->count;
+    dst->totalMicros += src->totalMicros;
+    if (src->maxMicros > dst->maxMicros) {
+        dst->maxMicros = src->maxMicros;
+    }
+}
+
+static void CopyStatsName(char *dst, const char *src)
+{
+    if (src == NULL) {
+        return;
+    }
+    size_t len = strlen(src);
+    if (len >= LOOPER_STATS_NAME_LEN) {
+        len = LOOPER_STATS_NAME_LEN - 1;
+    }
+    (void)memcpy_s(dst, LOOPER_STATS_NAME_LEN, src, len);
+    dst[len] = '\0';
+}
+
+static void RecordQueueDepthLocked(SoftBusLooperContext *context)
+{
+    context->msgSize++;
+    context->stats.postCount++;
+    if (context->msgSize > context->stats.queueDepthHighWater) {
+        context->stats.queueDepthHighWater = context->msgSize;
+    }
+    SoftBusLooperContext *group = context->group;
+    if (group == NULL) {
+        return;
+    }
+    // members post under their own locks, so the group depth and its peak are kept with atomics
+    uint32_t depth = __atomic_add_fetch(&group->groupDepth, 1, __ATOMIC_RELAXED);
+    uint32_t highWater = __atomic_load_n(&group->groupDepthHighWater, __ATOMIC_RELAXED);
+    while (depth > highWater && !__atomic_compare_exchange_n(&group->groupDepthHighWater, &highWater, depth,
+        true, __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+    }
+}
+
+/* open addressing on (handler, what); once the table is full new pairs are folded into the last slot */
+static HandlerStatsSlot *FindHandlerStatsLocked(SoftBusLooperContext *context, const SoftBusHandler *handler,
+    int32_t what)
+{
+#define HANDLER_STATS_HASH_MUL 0x9e3779b1U
+    const uint32_t tableSize = HANDLER_STATS_SLOT_NUM - 1;
+    uint32_t index = ((uint32_t)(uintptr_t)handler ^ ((uint32_t)what * HANDLER_STATS_HASH_MUL)) % tableSize;
+    for (uint32_t probe = 0; probe < tableSize; probe++) {
+        HandlerStatsSlot *slot = &context->handlerStats[(index + probe) % tableSize];
+        if (slot->handler == handler && slot->stats.what == what) {
+            return slot;
+        }
+        if (slot->handler == NULL) {
+            slot->handler = handler;
+            slot->stats.what = what;
+            CopyStatsName(slot->stats.handlerName, handler->name);
+            context->handlerStatsNum++;
+            return slot;
+        }
+    }
+    HandlerStatsSlot *others = &context->handlerStats[HANDLER_STATS_SLOT_NUM - 1];
+    if (others->handler == NULL) {
+        others->handler = handler;
+        others->stats.what = HANDLER_STATS_OTHERS_WHAT;
+        CopyStatsName(others->stats.handlerName, "others");
+        context->handlerStatsNum++;
+    }
+    return others;
+}
+
+static int InitLooperCond(pthread_cond_t *cond)
+{
+#ifdef __LITEOS_M__
+    return pthread_cond_init(cond, NULL);
+#else
+    // delayed messages are timed against CLOCK_MONOTONIC, so the condvar has to wait on the same clock
+    pthread_condattr_t condAttr;
+    if (pthread_condattr_init(&condAttr) != 0) {
+        return -1;
+    }
+    (void)pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    int ret = pthread_cond_init(cond, &condAttr);
+    (void)pthread_condattr_destroy(&condAttr);
+    return ret;
+#endif
+}
+
 static void *LoopTask(void *arg)
 {
     SoftBusLooper *looper = arg;
@@ -120,7 +477,7 @@ static void *LoopTask(void *arg)
             break;
         }
 
-        if (IsListEmpty(&context->msgHead)) {
+        if (IsLooperEmptyLocked(context)) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s] wait msg list empty", context->name);
             pthread_cond_wait(&context->cond, &context->lock);
             (void)pthread_mutex_unlock(&context->lock);
@@ -128,15 +485,14 @@ static void *LoopTask(void *arg)
         }
 
         uint64_t now = UptimeMicros();
-        ListNode *item = context->msgHead.next;
         SoftBusMessage *msg = NULL;
-        SoftBusMessageNode *itemNode = CONTAINER_OF(item, SoftBusMessageNode, node);
-        uint64_t time = itemNode->msg->time;
+        SoftBusMessage *nextMsg = PeekNextMessageLocked(context);
+        uint64_t time = nextMsg->time;
         if (now >= time) {
-            msg = itemNode->msg;
-            ListDelete(item);
-            SoftBusFree(itemNode);
-            context->msgSize--;
+            msg = nextMsg;
+            TakeMessageLocked(context, msg);
+            context->stats.dispatchCount++;
+            HistogramAdd(&context->stats.dispatchLatency, now - msg->enqueueTime);
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s], get message. handle=%s,what=%d,msgSize=%u",
                 context->name, msg->handler->name, msg->what, context->msgSize);
         } else {
@@ -163,12 +519,17 @@ static void *LoopTask(void *arg)
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s], HandleMessage message. handle=%s,what=%d",
             context->name, msg->handler->name, msg->what);
 
+        const SoftBusHandler *handler = msg->handler;
+        int32_t what = msg->what;
+        uint64_t execStart = UptimeMicros();
         if (msg->handler->HandleMessage != NULL) {
             msg->handler->HandleMessage(msg);
         }
+        uint64_t execTime = UptimeMicros() - execStart;
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "LoopTask[%s], after HandleMessage message. handle=%s,what=%d",
             context->name, msg->handler->name, msg->what);
         (void)pthread_mutex_lock(&context->lock);
+        HistogramAdd(&FindHandlerStatsLocked(context, handler, what)->stats.execTime, execTime);
         FreeSoftBusMsg(msg);
         context->currentMsg = NULL;
         (void)pthread_mutex_unlock(&context->lock);
@@ -202,16 +563,22 @@ static int StartNewLooperThread(SoftBusLooper *looper)
     return 0;
 }
 
+static void DumpMessage(int index, const SoftBusMessage *msg)
+{
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG,
+        "DumpLooper. i=%d,handler=%s,what =%d,arg1=%llu arg2=%llu, time=%lld",
+        index, msg->handler->name, msg->what, msg->arg1, msg->arg2, msg->time);
+}
+
 static void DumpLooperLocked(const SoftBusLooperContext *context)
 {
     int i = 0;
-    ListNode *item = NULL;
-    LIST_FOR_EACH(item, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
-        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_DBG,
-            "DumpLooper. i=%d,handler=%s,what =%d,arg1=%llu arg2=%llu, time=%lld",
-            i, msg->handler->name, msg->what, msg->arg1, msg->arg2, msg->time);
+    for (const SoftBusMessage *msg = context->msgQueue.head; msg != NULL; msg = msg->next) {
+        DumpMessage(i, msg);
+        i++;
+    }
+    for (unsigned int j = 0; j < context->delayHeap.size; j++) {
+        DumpMessage(i, context->delayHeap.msgs[j]);
         i++;
     }
 }
@@ -222,6 +589,12 @@ void DumpLooper(const SoftBusLooper *looper)
         return;
     }
     SoftBusLooperContext *context = looper->context;
+    if (context->members != NULL) {
+        for (uint32_t i = 0; i < context->memberNum; i++) {
+            DumpLooper(context->members[i]);
+        }
+        return;
+    }
     if (pthread_mutex_lock(&context->lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
         return;
@@ -230,7 +603,134 @@ void DumpLooper(const SoftBusLooper *looper)
     (void)pthread_mutex_unlock(&context->lock);
 }
 
-static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPost)
+static void CollectLooperStats(SoftBusLooperContext *context, SoftBusLooperStats *stats)
+{
+    if (pthread_mutex_lock(&context->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    stats->queueDepth += context->msgSize;
+    if (context->stats.queueDepthHighWater > stats->queueDepthHighWater) {
+        stats->queueDepthHighWater = context->stats.queueDepthHighWater;
+    }
+    stats->postCount += context->stats.postCount;
+    stats->dispatchCount += context->stats.dispatchCount;
+    stats->removeCount += context->stats.removeCount;
+    HistogramMerge(&stats->dispatchLatency, &context->stats.dispatchLatency);
+    (void)pthread_mutex_unlock(&context->lock);
+}
+
+static uint32_t CollectHandlerStats(SoftBusLooperContext *context, SoftBusHandlerStats *stats, uint32_t capacity)
+{
+    uint32_t num = 0;
+    if (pthread_mutex_lock(&context->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
+        return 0;
+    }
+    for (uint32_t i = 0; i < HANDLER_STATS_SLOT_NUM && num < capacity; i++) {
+        if (context->handlerStats[i].handler != NULL) {
+            stats[num++] = context->handlerStats[i].stats;
+        }
+    }
+    (void)pthread_mutex_unlock(&context->lock);
+    return num;
+}
+
+int GetLooperStats(const SoftBusLooper *looper, SoftBusLooperStats *stats)
+{
+    if (looper == NULL || looper->context == NULL || stats == NULL) {
+        return -1;
+    }
+    SoftBusLooperContext *context = looper->context;
+    (void)memset_s(stats, sizeof(SoftBusLooperStats), 0, sizeof(SoftBusLooperStats));
+    CopyStatsName(stats->name, context->name);
+    if (context->members == NULL) {
+        CollectLooperStats(context, stats);
+        return 0;
+    }
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        CollectLooperStats(context->members[i]->context, stats);
+    }
+    stats->queueDepthHighWater = __atomic_load_n(&context->groupDepthHighWater, __ATOMIC_RELAXED);
+    return 0;
+}
+
+int GetLooperHandlerStats(const SoftBusLooper *looper, SoftBusHandlerStats *stats, uint32_t *num)
+{
+    if (looper == NULL || looper->context == NULL || stats == NULL || num == NULL) {
+        return -1;
+    }
+    SoftBusLooperContext *context = looper->context;
+    if (context->members == NULL) {
+        *num = CollectHandlerStats(context, stats, *num);
+        return 0;
+    }
+    uint32_t filled = 0;
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        filled += CollectHandlerStats(context->members[i]->context, stats + filled, *num - filled);
+    }
+    *num = filled;
+    return 0;
+}
+
+static void StatsPrint(int fd, const char *fmt, ...)
+{
+    char line[STATS_LINE_LEN] = {0};
+    va_list args;
+    va_start(args, fmt);
+    int len = vsprintf_s(line, sizeof(line), fmt, args);
+    va_end(args);
+    if (len <= 0) {
+        return;
+    }
+    if (fd < 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "%s", line);
+        return;
+    }
+    (void)write(fd, line, (size_t)len);
+}
+
+static void DumpHistogram(int fd, const char *title, const SoftBusLatencyHistogram *histogram)
+{
+    uint64_t avg = (histogram->count == 0) ? 0 : histogram->totalMicros / histogram->count;
+    const uint64_t *b = histogram->buckets;
+    StatsPrint(fd, "  %s: count=%llu avg=%lluus max=%lluus "
+        "[<=100us:%llu <=1ms:%llu <=5ms:%llu <=10ms:%llu <=50ms:%llu <=100ms:%llu <=500ms:%llu <=1s:%llu >1s:%llu]\n",
+        title, histogram->count, avg, histogram->maxMicros,
+        b[0], b[1], b[2], b[3], b[4], b[5], b[6], b[7], b[8]);
+}
+
+void DumpLooperStats(int fd)
+{
+    SoftBusHandlerStats *handlerStats = (SoftBusHandlerStats *)SoftBusCalloc(
+        HANDLER_STATS_SLOT_NUM * sizeof(SoftBusHandlerStats));
+    if (handlerStats == NULL) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "malloc handler stats failed");
+        return;
+    }
+    (void)pthread_mutex_lock(&g_looperListLock);
+    SoftBusLooperContext *context = NULL;
+    LIST_FOR_EACH_ENTRY(context, &g_looperList, SoftBusLooperContext, node) {
+        SoftBusLooperStats stats = {0};
+        CollectLooperStats(context, &stats);
+        StatsPrint(fd, "looper[%s] depth=%u highWater=%u post=%llu dispatch=%llu remove=%llu\n", context->name,
+            stats.queueDepth, stats.queueDepthHighWater, stats.postCount, stats.dispatchCount, stats.removeCount);
+        DumpHistogram(fd, "dispatch latency", &stats.dispatchLatency);
+        uint32_t num = CollectHandlerStats(context, handlerStats, HANDLER_STATS_SLOT_NUM);
+        for (uint32_t i = 0; i < num; i++) {
+            char title[STATS_LINE_LEN] = {0};
+            if (sprintf_s(title, sizeof(title), "handler[%s] what=%d exec", handlerStats[i].handlerName,
+                handlerStats[i].what) == -1) {
+                continue;
+            }
+            DumpHistogram(fd, title, &handlerStats[i].execTime);
+        }
+    }
+    (void)pthread_mutex_unlock(&g_looperListLock);
+    SoftBusFree(handlerStats);
+}
+
+static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPost, bool isDelayed)
 {
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]PostMessageAtTime what =%d time=%lld us",
         looper->context->name, msgPost->what, msgPost->time);
@@ -240,46 +740,34 @@ static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPo
             looper->context->name);
         return;
     }
-    SoftBusMessageNode *newNode = (SoftBusMessageNode *)SoftBusMalloc(sizeof(SoftBusMessageNode));
-    if (newNode == NULL) {
-        FreeSoftBusMsg(msgPost);
-        return;
-    }
-    ListInit(&newNode->node);
-    newNode->msg = msgPost;
     SoftBusLooperContext *context = looper->context;
     if (pthread_mutex_lock(&context->lock) != 0) {
-        SoftBusFree(newNode);
         FreeSoftBusMsg(msgPost);
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "lock failed");
         return;
     }
     if (context->stop == 1) {
-        SoftBusFree(newNode);
         FreeSoftBusMsg(msgPost);
         (void)pthread_mutex_unlock(&context->lock);
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "[%s]PostMessageAtTime. running=%d,stop=%d",
             context->name, context->running, context->stop);
         return;
     }
-    ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    bool insert = false;
-    LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
-        if (msg->time > msgPost->time) {
-            ListTailInsert(item, &(newNode->node));
-            insert = true;
-            break;
+    msgPost->seq = context->postSeq++;
+    msgPost->enqueueTime = UptimeMicros();
+    if (isDelayed) {
+        if (HeapPush(&context->delayHeap, msgPost) != 0) {
+            FreeSoftBusMsg(msgPost);
+            (void)pthread_mutex_unlock(&context->lock);
+            return;
         }
+    } else {
+        // stamp under the lock so the FIFO stays ordered by time
+        msgPost->time = msgPost->enqueueTime;
+        QueuePush(&context->msgQueue, msgPost);
     }
-    if (!insert) {
-        ListTailInsert(&(context->msgHead), &(newNode->node));
-    }
-    context->msgSize++;
+    RecordQueueDepthLocked(context);
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]PostMessageAtTime. insert", context->name);
-    DumpLooperLocked(context);
 
     pthread_cond_broadcast(&context->cond);
     (void)pthread_mutex_unlock(&context->lock);
@@ -288,13 +776,13 @@ static void PostMessageAtTime(const SoftBusLooper *looper, SoftBusMessage *msgPo
 static void LooperPostMessage(const SoftBusLooper *looper, SoftBusMessage *msg)
 {
     msg->time = UptimeMicros();
-    PostMessageAtTime(looper, msg);
+    PostMessageAtTime(looper, msg, false);
 }
 
 static void LooperPostMessageDelay(const SoftBusLooper *looper, SoftBusMessage *msg, uint64_t delayMillis)
 {
     msg->time = UptimeMicros() + delayMillis * TIME_THOUSANDS_MULTIPLIER;
-    PostMessageAtTime(looper, msg);
+    PostMessageAtTime(looper, msg, delayMillis != 0);
 }
 
 static int WhatRemoveFunc(const SoftBusMessage *msg, void *args)
@@ -318,19 +806,47 @@ static void LoopRemoveMessageCustom(const SoftBusLooper *looper, const SoftBusHa
         (void)pthread_mutex_unlock(&context->lock);
         return;
     }
-    ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-        SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-        SoftBusMessage *msg = itemNode->msg;
+    SoftBusMessageQueue *queue = &context->msgQueue;
+    SoftBusMessage *prev = NULL;
+    SoftBusMessage *msg = queue->head;
+    while (msg != NULL) {
+        SoftBusMessage *next = msg->next;
         if (msg->handler == handler && customFunc(msg, args) == 0) {
             SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]LooperRemoveMessage. handler=%s, what =%d",
                 context->name, handler->name, msg->what);
+            if (prev == NULL) {
+                queue->head = next;
+            } else {
+                prev->next = next;
+            }
+            if (queue->tail == msg) {
+                queue->tail = prev;
+            }
             FreeSoftBusMsg(msg);
-            ListDelete(&itemNode->node);
-            SoftBusFree(itemNode);
-            context->msgSize--;
+            ReleaseQueueDepthLocked(context);
+            context->stats.removeCount++;
+        } else {
+            prev = msg;
         }
+        msg = next;
+    }
+    SoftBusMessageHeap *heap = &context->delayHeap;
+    unsigned int kept = 0;
+    for (unsigned int i = 0; i < heap->size; i++) {
+        msg = heap->msgs[i];
+        if (msg->handler == handler && customFunc(msg, args) == 0) {
+            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]LooperRemoveMessage. handler=%s, what =%d",
+                context->name, handler->name, msg->what);
+            FreeSoftBusMsg(msg);
+            ReleaseQueueDepthLocked(context);
+            context->stats.removeCount++;
+            continue;
+        }
+        heap->msgs[kept++] = msg;
+    }
+    if (kept != heap->size) {
+        heap->size = kept;
+        HeapBuild(heap);
     }
     (void)pthread_mutex_unlock(&context->lock);
 }
@@ -358,11 +874,10 @@ SoftBusLooper *CreateNewLooper(const char *name)
         SoftBusFree(context);
         return NULL;
     }
-    ListInit(&context->msgHead);
     // init context
 
     pthread_mutex_init(&context->lock, NULL);
-    pthread_cond_init(&context->cond, NULL);
+    (void)InitLooperCond(&context->cond);
     pthread_cond_init(&context->condRunning, NULL);
 
     // init looper
@@ -371,17 +886,138 @@ SoftBusLooper *CreateNewLooper(const char *name)
     looper->PostMessageDelay = LooperPostMessageDelay;
     looper->RemoveMessage = LooperRemoveMessage;
     looper->RemoveMessageCustom = LoopRemoveMessageCustom;
+    // counted as running from here, so a DestroyLooper racing the thread start waits for the thread to exit
+    context->running = 1;
     int ret = StartNewLooperThread(looper);
     if (ret != 0) {
         SoftBusFree(looper);
         SoftBusFree(context);
         return NULL;
     }
+    (void)pthread_mutex_lock(&g_looperListLock);
+    ListTailInsert(&g_looperList, &context->node);
+    (void)pthread_mutex_unlock(&g_looperListLock);
 
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]wait looper start ok", context->name);
     return looper;
 }
 
+static uint32_t AffinityHash(const SoftBusMessage *msg)
+{
+#define AFFINITY_HASH_SHIFT 33
+#define AFFINITY_HASH_MUL 0xff51afd7ed558ccdULL
+    uint64_t key = (uint64_t)(uintptr_t)msg->handler ^ ((uint64_t)msg->affinity << (AFFINITY_HASH_SHIFT - 1));
+    key ^= key >> AFFINITY_HASH_SHIFT;
+    key *= AFFINITY_HASH_MUL;
+    key ^= key >> AFFINITY_HASH_SHIFT;
+    return (uint32_t)key;
+}
+
+static const SoftBusLooper *SelectGroupMember(const SoftBusLooper *group, const SoftBusMessage *msg)
+{
+    const SoftBusLooperContext *context = group->context;
+    return context->members[AffinityHash(msg) % context->memberNum];
+}
+
+static void GroupPostMessage(const SoftBusLooper *looper, SoftBusMessage *msg)
+{
+    const SoftBusLooper *member = SelectGroupMember(looper, msg);
+    member->PostMessage(member, msg);
+}
+
+static void GroupPostMessageDelay(const SoftBusLooper *looper, SoftBusMessage *msg, uint64_t delayMillis)
+{
+    const SoftBusLooper *member = SelectGroupMember(looper, msg);
+    member->PostMessageDelay(member, msg, delayMillis);
+}
+
+static void GroupRemoveMessageCustom(const SoftBusLooper *looper, const SoftBusHandler *handler,
+    int (*customFunc)(const SoftBusMessage*, void*), void *args)
+{
+    // the affinity of a queued message is not known here, so every member is searched
+    const SoftBusLooperContext *context = looper->context;
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        const SoftBusLooper *member = context->members[i];
+        member->RemoveMessageCustom(member, handler, customFunc, args);
+    }
+}
+
+static void GroupRemoveMessage(const SoftBusLooper *looper, const SoftBusHandler *handler, int32_t what)
+{
+    const SoftBusLooperContext *context = looper->context;
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        const SoftBusLooper *member = context->members[i];
+        member->RemoveMessage(member, handler, what);
+    }
+}
+
+static void DestroyGroupMembers(SoftBusLooperContext *context)
+{
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        DestroyLooper(context->members[i]);
+    }
+    SoftBusFree(context->members);
+    context->members = NULL;
+    context->memberNum = 0;
+}
+
+SoftBusLooper *CreateNewLooperGroup(const char *name, uint32_t threadNum)
+{
+    if (name == NULL || threadNum == 0 || threadNum > LOOPER_GROUP_MAX_THREAD) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "invalid looper group param");
+        return NULL;
+    }
+    SoftBusLooper *looper = (SoftBusLooper *)SoftBusCalloc(sizeof(SoftBusLooper));
+    if (looper == NULL) {
+        return NULL;
+    }
+    SoftBusLooperContext *context = SoftBusCalloc(sizeof(SoftBusLooperContext));
+    if (context == NULL) {
+        SoftBusFree(looper);
+        return NULL;
+    }
+    context->members = (SoftBusLooper **)SoftBusCalloc(threadNum * sizeof(SoftBusLooper *));
+    if (context->members == NULL ||
+        memcpy_s(context->name, sizeof(context->name), name, strlen(name)) != EOK) {
+        SoftBusFree(context->members);
+        SoftBusFree(context);
+        SoftBusFree(looper);
+        return NULL;
+    }
+    pthread_mutex_init(&context->lock, NULL);
+    for (uint32_t i = 0; i < threadNum; i++) {
+        char memberName[LOOP_NAME_LEN] = {0};
+        if (sprintf_s(memberName, sizeof(memberName), "%.*s-%u",
+            (int)(LOOP_NAME_LEN - 1 - LOOPER_GROUP_INDEX_LEN), name, i) == -1) {
+            break;
+        }
+        context->members[i] = CreateNewLooper(memberName);
+        if (context->members[i] == NULL) {
+            break;
+        }
+        context->memberNum++;
+    }
+    if (context->memberNum != threadNum) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "[%s]create looper group member failed", context->name);
+        DestroyGroupMembers(context);
+        pthread_mutex_destroy(&context->lock);
+        SoftBusFree(context);
+        SoftBusFree(looper);
+        return NULL;
+    }
+    for (uint32_t i = 0; i < context->memberNum; i++) {
+        context->members[i]->context->group = context;
+    }
+    looper->context = context;
+    looper->PostMessage = GroupPostMessage;
+    looper->PostMessageDelay = GroupPostMessageDelay;
+    looper->RemoveMessage = GroupRemoveMessage;
+    looper->RemoveMessageCustom = GroupRemoveMessageCustom;
+    SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]looper group start ok, threadNum=%u", context->name,
+        threadNum);
+    return looper;
+}
+
 struct LoopConfigItem {
     int type;
     SoftBusLooper *looper;
@@ -433,7 +1069,15 @@ void DestroyLooper(SoftBusLooper *looper)
     }
 
     SoftBusLooperContext *context = looper->context;
-    if (context != NULL) {
+    if (context != NULL && context->members != NULL) {
+        DestroyGroupMembers(context);
+        pthread_mutex_destroy(&context->lock);
+        SoftBusFree(context);
+        looper->context = NULL;
+    } else if (context != NULL) {
+        (void)pthread_mutex_lock(&g_looperListLock);
+        ListDelete(&context->node);
+        (void)pthread_mutex_unlock(&g_looperListLock);
         (void)pthread_mutex_lock(&context->lock);
 
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s]set stop = 1", context->name);
@@ -452,15 +1096,16 @@ void DestroyLooper(SoftBusLooper *looper)
             (void)pthread_mutex_unlock(&context->lock);
         }
         // release msg
-        ListNode *item = NULL;
-        ListNode *nextItem = NULL;
-        LIST_FOR_EACH_SAFE(item, nextItem, &context->msgHead) {
-            SoftBusMessageNode *itemNode = LIST_ENTRY(item, SoftBusMessageNode, node);
-            SoftBusMessage *msg = itemNode->msg;
+        SoftBusMessage *msg = NULL;
+        while ((msg = QueuePop(&context->msgQueue)) != NULL) {
             FreeSoftBusMsg(msg);
-            ListDelete(&itemNode->node);
-            SoftBusFree(itemNode);
         }
+        for (unsigned int i = 0; i < context->delayHeap.size; i++) {
+            FreeSoftBusMsg(context->delayHeap.msgs[i]);
+        }
+        SoftBusFree(context->delayHeap.msgs);
+        context->delayHeap.msgs = NULL;
+        context->delayHeap.size = 0;
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "[%s] destroy", context->name);
         // destroy looper
         pthread_cond_destroy(&context->cond);
@@ -501,4 +1146,5 @@ void LooperDeinit(void)
         (void)pthread_mutex_unlock(&(g_loopConfig[i].looper->context->lock));
         DestroyLooper(g_loopConfig[i].looper);
     }
+    DrainMessagePool();
 }
@@ -26,15 +26,22 @@ extern "C" {
 #endif
 #endif
 
-/* when receive seq < minSeq, the package is duplicated.
-   when receive seq == minSeq, update minSeq.
-   when minSeq < receive seq < maxSeq, Check whether duplicate package exist, record the package in bitmap.
-   when receive seq >= maxSeq, update maxSeq, record the package in bitmap.
+/* bitmap words, a power of two; the window is one word short of the bitmap so the top word can fill up */
+#define SEQ_WINDOW_WORDS 16
+#define SEQ_WINDOW_SIZE ((SEQ_WINDOW_WORDS - 1) * 64)
+
+/* seqs compare with serial arithmetic, so the window slides across the int32 flip like anywhere else.
+   when receive seq < minSeq, the package is too old or duplicated.
+   when minSeq <= receive seq < maxSeq, check whether duplicate package exist, record the package in bitmap.
+   when maxSeq <= receive seq < maxSeq + SEQ_WINDOW_SIZE, update maxSeq, slide minSeq up to keep at most
+   SEQ_WINDOW_SIZE seqs in the window, record the package in bitmap.
+   receive seq further ahead is refused.
+   minSeq == maxSeq with a zeroed bitmap expects maxSeq next.
 */
 typedef struct {
     int32_t maxSeq;
     int32_t minSeq;
-    uint64_t recvBitmap;
+    uint64_t recvBitmap[SEQ_WINDOW_WORDS];
 } SeqVerifyInfo;
 
 /* When the received package is an ACK packet, this function does not need to be called for verification. */
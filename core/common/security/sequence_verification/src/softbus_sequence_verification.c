@@ -16,163 +16,67 @@
 #include "softbus_sequence_verification.h"
 #include "softbus_log.h"
 
-#define MAX_SEQ_BIAS 60
+#define SEQ_WORD_SHIFT 6
+#define SEQ_WORD_MASK ((1U << SEQ_WORD_SHIFT) - 1)
+/* block numbers wrap together with the seqs they are taken from */
+#define SEQ_BLOCK_MASK (UINT32_MAX >> SEQ_WORD_SHIFT)
 
-static bool IsDifferentSign(int32_t seqA, int32_t seqB)
+/* signed distance from seqB to seqA, correct across the flip while they are less than 2^31 apart */
+static int32_t SeqDiff(int32_t seqA, int32_t seqB)
 {
-    if ((seqA >= 0 && seqB >= 0) || (seqA < 0 && seqB < 0)) {
-        return false;
-    }
-    return true;
+    return (int32_t)((uint32_t)seqA - (uint32_t)seqB);
 }
 
-static bool IsPassDuplicateCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
+static uint64_t *SeqWord(SeqVerifyInfo *seqVerifyInfo, uint32_t block)
 {
-    uint32_t offset = seqVerifyInfo->maxSeq - recvSeq;
-    int32_t isRepeat = seqVerifyInfo->recvBitmap & (0x1UL << offset);
-    if (isRepeat) {
-        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "duplicated package seq[%d].", recvSeq);
-        return false;
-    }
-    seqVerifyInfo->recvBitmap |= (0x1UL << offset);
-    return true;
+    return &seqVerifyInfo->recvBitmap[block & (SEQ_WINDOW_WORDS - 1)];
 }
 
-static bool IsPassOverMaxCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
+/* words of the blocks the top moves across are stale by a full lap of the ring, clear them (RFC 6479) */
+static void SlideWindow(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
 {
-    /* consider flip */
-    if (recvSeq - seqVerifyInfo->maxSeq < 0) {
-        return false;
+    uint32_t oldBlock = ((uint32_t)seqVerifyInfo->maxSeq - 1) >> SEQ_WORD_SHIFT;
+    uint32_t newBlock = (uint32_t)recvSeq >> SEQ_WORD_SHIFT;
+    uint32_t blocks = (newBlock - oldBlock) & SEQ_BLOCK_MASK;
+    if (blocks > SEQ_WINDOW_WORDS) {
+        blocks = SEQ_WINDOW_WORDS;
     }
-
-    if (recvSeq - seqVerifyInfo->minSeq >= MAX_SEQ_BIAS) {
-        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "seq bias reach max[%d].", MAX_SEQ_BIAS);
-        return false;
+    for (uint32_t i = 1; i <= blocks; i++) {
+        *SeqWord(seqVerifyInfo, oldBlock + i) = 0;
     }
-    uint32_t seqOffset = recvSeq - seqVerifyInfo->maxSeq + 1;
-    seqVerifyInfo->maxSeq = ++recvSeq;
-    seqVerifyInfo->recvBitmap = seqVerifyInfo->recvBitmap << seqOffset;
-    /* 1: represent the penultimate bit of recvBitmap is 1. */
-    seqVerifyInfo->recvBitmap |= (0x1UL << 1);
-    return true;
-}
 
-static bool IsPassAllRangeCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
-{
-    if (recvSeq == seqVerifyInfo->minSeq) {
-        seqVerifyInfo->minSeq = ++recvSeq;
-        return true;
+    seqVerifyInfo->maxSeq = (int32_t)((uint32_t)recvSeq + 1);
+    int32_t floorSeq = (int32_t)((uint32_t)seqVerifyInfo->maxSeq - SEQ_WINDOW_SIZE);
+    if (SeqDiff(floorSeq, seqVerifyInfo->minSeq) > 0) {
+        seqVerifyInfo->minSeq = floorSeq;
     }
-
-    if (recvSeq > seqVerifyInfo->minSeq) {
-        if (recvSeq < seqVerifyInfo->maxSeq) {
-            return IsPassDuplicateCheck(seqVerifyInfo, recvSeq);
-        }
-        return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-    }
-    return false;
 }
 
-static bool IsPassNormalCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
+bool IsPassSeqCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
 {
-    /* normal case */
-    if (recvSeq == seqVerifyInfo->minSeq) {
-        seqVerifyInfo->minSeq = recvSeq + 1;
-        seqVerifyInfo->maxSeq = recvSeq + 1;
-        return true;
-    }
-    /* first disorder package, recvSeq and minSeq/maxSeq are same signs. */
-    if (!IsDifferentSign(recvSeq, seqVerifyInfo->minSeq)) {
-        if (recvSeq > seqVerifyInfo->maxSeq) {
-            return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-        }
+    if (seqVerifyInfo == NULL) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "invalid param.");
         return false;
     }
-    /* first disorder package, recvSeq and minSeq/maxSeq are different signs. */
-    return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-}
-
-static bool IsPassNoflipDisorderCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
-{
-    if (seqVerifyInfo->minSeq >= 0) {
-        if (recvSeq >= 0) {
-            return IsPassAllRangeCheck(seqVerifyInfo, recvSeq);
-        }
-        return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-    }
-    if (seqVerifyInfo->maxSeq < 0) {
-        if (recvSeq < 0) {
-            return IsPassAllRangeCheck(seqVerifyInfo, recvSeq);
-        }
-        return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-    }
-    /* can not reach here. */
-    return false;
-}
-
-static bool IsPassFlipPositiveCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
-{
-    if (recvSeq >= 0) {
-        if (recvSeq < seqVerifyInfo->maxSeq) {
-            return IsPassDuplicateCheck(seqVerifyInfo, recvSeq);
-        }
-        return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
-    }
-    if (recvSeq < 0) {
-        if (recvSeq == seqVerifyInfo->minSeq) {
-            seqVerifyInfo->minSeq = ++recvSeq;
-            return true;
-        }
-        if (recvSeq > seqVerifyInfo->minSeq) {
-            return IsPassDuplicateCheck(seqVerifyInfo, recvSeq);
-        }
+    if (SeqDiff(recvSeq, seqVerifyInfo->minSeq) < 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "seq[%d] below window[%d].", recvSeq, seqVerifyInfo->minSeq);
         return false;
     }
-    /* can not reach here. */
-    return false;
-}
-
-static bool IsPassFlipNegativeCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
-{
-    if (recvSeq >= 0) {
-        if (recvSeq == seqVerifyInfo->minSeq) {
-            seqVerifyInfo->minSeq = ++recvSeq;
-            return true;
-        }
-        if (recvSeq > seqVerifyInfo->minSeq) {
-            return IsPassDuplicateCheck(seqVerifyInfo, recvSeq);
-        }
+    int32_t ahead = SeqDiff(recvSeq, seqVerifyInfo->maxSeq);
+    if (ahead >= SEQ_WINDOW_SIZE) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "seq bias reach max[%d].", SEQ_WINDOW_SIZE);
         return false;
     }
-    if (recvSeq < 0) {
-        if (recvSeq < seqVerifyInfo->maxSeq) {
-            return IsPassDuplicateCheck(seqVerifyInfo, recvSeq);
-        }
-        return IsPassOverMaxCheck(seqVerifyInfo, recvSeq);
+    if (ahead >= 0) {
+        SlideWindow(seqVerifyInfo, recvSeq);
     }
-    /* can not reach here. */
-    return false;
-}
 
-bool IsPassSeqCheck(SeqVerifyInfo *seqVerifyInfo, int32_t recvSeq)
-{
-    if (seqVerifyInfo == NULL) {
-        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "invalid param.");
+    uint64_t *word = SeqWord(seqVerifyInfo, (uint32_t)recvSeq >> SEQ_WORD_SHIFT);
+    uint64_t bit = (uint64_t)1 << ((uint32_t)recvSeq & SEQ_WORD_MASK);
+    if ((*word & bit) != 0) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "duplicated package seq[%d].", recvSeq);
         return false;
     }
-    bool isDifferentSign = IsDifferentSign(seqVerifyInfo->minSeq, seqVerifyInfo->maxSeq);
-    if (seqVerifyInfo->minSeq == seqVerifyInfo->maxSeq) {
-        return IsPassNormalCheck(seqVerifyInfo, recvSeq);
-    }
-    if ((seqVerifyInfo->minSeq < seqVerifyInfo->maxSeq) && !isDifferentSign) {
-        return IsPassNoflipDisorderCheck(seqVerifyInfo, recvSeq);
-    }
-    if ((seqVerifyInfo->minSeq > seqVerifyInfo->maxSeq) && isDifferentSign) {
-        return IsPassFlipNegativeCheck(seqVerifyInfo, recvSeq);
-    }
-    if ((seqVerifyInfo->minSeq < seqVerifyInfo->maxSeq) && isDifferentSign) {
-        return IsPassFlipPositiveCheck(seqVerifyInfo, recvSeq);
-    }
-    /* can not reach here. */
-    return false;
+    *word |= bit;
+    return true;
 }
@@ -0,0 +1,259 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softbus_timer_wheel.h"
+
+#include <pthread.h>
+
+#include "common_list.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_errcode.h"
+#include "softbus_log.h"
+#include "softbus_utils.h"
+
+#define WHEEL_SLOT_BITS 6
+#define WHEEL_SLOT_NUM (1U << WHEEL_SLOT_BITS)
+#define WHEEL_SLOT_MASK (WHEEL_SLOT_NUM - 1)
+#define WHEEL_LEVEL_NUM 4
+/* 2^24 ticks, about 194 days at one tick a second, longer deadlines are clamped */
+#define WHEEL_MAX_TICKS ((1U << (WHEEL_SLOT_BITS * WHEEL_LEVEL_NUM)) - 1)
+#define WHEEL_HASH_BITS 8
+#define WHEEL_HASH_NUM (1U << WHEEL_HASH_BITS)
+#define WHEEL_HASH_MULTIPLIER 0x9E3779B1U
+#define WHEEL_POOL_MAX_FREE 64
+#define HASH_BITS 32
+
+typedef struct {
+    ListNode slotNode; /* wheel slot, the expired list of a tick, or the free pool */
+    ListNode hashNode;
+    int32_t timerFunId;
+    uint32_t key;
+    uint32_t expire;
+} TimerWheelEntry;
+
+typedef struct {
+    pthread_mutex_t lock;
+    bool inited;
+    uint32_t now;
+    ListNode slot[WHEEL_LEVEL_NUM][WHEEL_SLOT_NUM];
+    ListNode hash[WHEEL_HASH_NUM];
+    ListNode pool;
+    uint32_t poolCnt;
+    TimerWheelExpireCb cb[SOFTBUS_MAX_TIMER_FUN_NUM];
+} TimerWheel;
+
+static TimerWheel g_wheel = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .inited = false,
+};
+
+static void TimerWheelInitLocked(void)
+{
+    if (g_wheel.inited) {
+        return;
+    }
+    for (uint32_t level = 0; level < WHEEL_LEVEL_NUM; level++) {
+        for (uint32_t i = 0; i < WHEEL_SLOT_NUM; i++) {
+            ListInit(&g_wheel.slot[level][i]);
+        }
+    }
+    for (uint32_t i = 0; i < WHEEL_HASH_NUM; i++) {
+        ListInit(&g_wheel.hash[i]);
+    }
+    ListInit(&g_wheel.pool);
+    g_wheel.poolCnt = 0;
+    g_wheel.inited = true;
+}
+
+static bool IsTimerFunIdValid(int32_t timerFunId)
+{
+    return timerFunId >= SOFTBUS_CONN_TIMER_FUN && timerFunId < SOFTBUS_MAX_TIMER_FUN_NUM;
+}
+
+static uint32_t HashSlot(int32_t timerFunId, uint32_t key)
+{
+    uint32_t hash = ((key * WHEEL_HASH_MULTIPLIER) ^ (uint32_t)timerFunId) * WHEEL_HASH_MULTIPLIER;
+    return hash >> (HASH_BITS - WHEEL_HASH_BITS);
+}
+
+static TimerWheelEntry *FindEntryLocked(int32_t timerFunId, uint32_t key)
+{
+    TimerWheelEntry *entry = NULL;
+    LIST_FOR_EACH_ENTRY(entry, &g_wheel.hash[HashSlot(timerFunId, key)], TimerWheelEntry, hashNode) {
+        if (entry->timerFunId == timerFunId && entry->key == key) {
+            return entry;
+        }
+    }
+    return NULL;
+}
+
+/* the level is picked by how far away expire is, the slot by the bits of expire that level resolves */
+static void PlaceEntryLocked(TimerWheelEntry *entry)
+{
+    uint32_t delta = entry->expire - g_wheel.now;
+    uint32_t level = 0;
+    while (level < WHEEL_LEVEL_NUM - 1 && delta >= (1U << (WHEEL_SLOT_BITS * (level + 1)))) {
+        level++;
+    }
+    uint32_t index = (entry->expire >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK;
+    ListTailInsert(&g_wheel.slot[level][index], &entry->slotNode);
+}
+
+static TimerWheelEntry *AllocEntryLocked(void)
+{
+    if (IsListEmpty(&g_wheel.pool)) {
+        return (TimerWheelEntry *)SoftBusCalloc(sizeof(TimerWheelEntry));
+    }
+    TimerWheelEntry *entry = LIST_ENTRY(g_wheel.pool.next, TimerWheelEntry, slotNode);
+    ListDelete(&entry->slotNode);
+    g_wheel.poolCnt--;
+    return entry;
+}
+
+static void FreeEntryLocked(TimerWheelEntry *entry)
+{
+    if (g_wheel.poolCnt < WHEEL_POOL_MAX_FREE) {
+        ListAdd(&g_wheel.pool, &entry->slotNode);
+        g_wheel.poolCnt++;
+        return;
+    }
+    SoftBusFree(entry);
+}
+
+int32_t TimerWheelRegister(int32_t timerFunId, TimerWheelExpireCb cb)
+{
+    if (!IsTimerFunIdValid(timerFunId) || cb == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    (void)pthread_mutex_lock(&g_wheel.lock);
+    TimerWheelInitLocked();
+    g_wheel.cb[timerFunId] = cb;
+    (void)pthread_mutex_unlock(&g_wheel.lock);
+    return SOFTBUS_OK;
+}
+
+int32_t TimerWheelArm(int32_t timerFunId, uint32_t key, uint32_t ticks)
+{
+    if (!IsTimerFunIdValid(timerFunId)) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    /* a slot is only looked at once per lap, so nothing may land in the one of the current tick */
+    ticks = (ticks == 0) ? 1 : ((ticks > WHEEL_MAX_TICKS) ? WHEEL_MAX_TICKS : ticks);
+
+    (void)pthread_mutex_lock(&g_wheel.lock);
+    TimerWheelInitLocked();
+    TimerWheelEntry *entry = FindEntryLocked(timerFunId, key);
+    if (entry != NULL) {
+        ListDelete(&entry->slotNode);
+    } else {
+        entry = AllocEntryLocked();
+        if (entry == NULL) {
+            (void)pthread_mutex_unlock(&g_wheel.lock);
+            SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "timer %d key %u arm failed", timerFunId, key);
+            return SOFTBUS_MALLOC_ERR;
+        }
+        entry->timerFunId = timerFunId;
+        entry->key = key;
+        ListAdd(&g_wheel.hash[HashSlot(timerFunId, key)], &entry->hashNode);
+    }
+    entry->expire = g_wheel.now + ticks;
+    PlaceEntryLocked(entry);
+    (void)pthread_mutex_unlock(&g_wheel.lock);
+    return SOFTBUS_OK;
+}
+
+void TimerWheelCancel(int32_t timerFunId, uint32_t key)
+{
+    if (!IsTimerFunIdValid(timerFunId)) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_wheel.lock);
+    if (g_wheel.inited) {
+        TimerWheelEntry *entry = FindEntryLocked(timerFunId, key);
+        if (entry != NULL) {
+            ListDelete(&entry->slotNode);
+            ListDelete(&entry->hashNode);
+            FreeEntryLocked(entry);
+        }
+    }
+    (void)pthread_mutex_unlock(&g_wheel.lock);
+}
+
+uint32_t TimerWheelNow(void)
+{
+    return __atomic_load_n(&g_wheel.now, __ATOMIC_RELAXED);
+}
+
+/*
+ * moves every entry of the current slot of a higher level down; the slot comes round less than one of its
+ * own spans before expire, so each entry always lands on a lower level
+ */
+static void CascadeLocked(uint32_t level)
+{
+    uint32_t index = (g_wheel.now >> (WHEEL_SLOT_BITS * level)) & WHEEL_SLOT_MASK;
+    TimerWheelEntry *entry = NULL;
+    TimerWheelEntry *next = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &g_wheel.slot[level][index], TimerWheelEntry, slotNode) {
+        ListDelete(&entry->slotNode);
+        PlaceEntryLocked(entry);
+    }
+}
+
+void TimerWheelTick(void)
+{
+    ListNode expired;
+    ListInit(&expired);
+    TimerWheelExpireCb cb[SOFTBUS_MAX_TIMER_FUN_NUM];
+
+    (void)pthread_mutex_lock(&g_wheel.lock);
+    TimerWheelInitLocked();
+    __atomic_store_n(&g_wheel.now, g_wheel.now + 1, __ATOMIC_RELAXED);
+    /* each level is cascaded when all the levels below it wrapped, the highest first */
+    uint32_t top = 0;
+    while (top < WHEEL_LEVEL_NUM - 1 && (g_wheel.now & ((1U << (WHEEL_SLOT_BITS * (top + 1))) - 1)) == 0) {
+        top++;
+    }
+    for (uint32_t level = top; level > 0; level--) {
+        CascadeLocked(level);
+    }
+    ListNode *slot = &g_wheel.slot[0][g_wheel.now & WHEEL_SLOT_MASK];
+    TimerWheelEntry *entry = NULL;
+    TimerWheelEntry *next = NULL;
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, slot, TimerWheelEntry, slotNode) {
+        ListDelete(&entry->slotNode);
+        ListDelete(&entry->hashNode);
+        ListTailInsert(&expired, &entry->slotNode);
+    }
+    for (int32_t i = 0; i < SOFTBUS_MAX_TIMER_FUN_NUM; i++) {
+        cb[i] = g_wheel.cb[i];
+    }
+    (void)pthread_mutex_unlock(&g_wheel.lock);
+    if (IsListEmpty(&expired)) {
+        return;
+    }
+
+    /* the callbacks look their key up again under their own lock, so they may run after a cancel */
+    LIST_FOR_EACH_ENTRY(entry, &expired, TimerWheelEntry, slotNode) {
+        if (cb[entry->timerFunId] != NULL) {
+            cb[entry->timerFunId](entry->key);
+        }
+    }
+    (void)pthread_mutex_lock(&g_wheel.lock);
+    LIST_FOR_EACH_ENTRY_SAFE(entry, next, &expired, TimerWheelEntry, slotNode) {
+        ListDelete(&entry->slotNode);
+        FreeEntryLocked(entry);
+    }
+    (void)pthread_mutex_unlock(&g_wheel.lock);
+}
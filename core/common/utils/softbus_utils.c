@@ -22,6 +22,7 @@
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_type_def.h"
 
 static void *g_timerId = NULL;
@@ -74,6 +75,7 @@ int32_t RegisterTimeoutCallback(int32_t timerFunId, TimerFunCallback callback)
 
 static void HandleTimeoutFun(void)
 {
+    TimerWheelTick();
     int32_t i;
     for (i = 0; i < SOFTBUS_MAX_TIMER_FUN_NUM; i++) {
         if (g_timerFunList[i] != NULL) {
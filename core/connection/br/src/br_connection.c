@@ -22,6 +22,7 @@
 #include "ohos_types.h"
 #include "securec.h"
 #include "softbus_adapter_mem.h"
+#include "softbus_conn_id_table.h"
 #include "softbus_conn_manager.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
@@ -40,6 +41,8 @@
 #define METHOD_NOTIFY_REQUEST 1
 #define METHOD_NOTIFY_RESPONSE 2
 #define METHOD_SHUT_DOWN 3
+#define METHOD_NOTIFY_CAPABILITY 4
+#define KEY_CAPABILITY "KEY_CAPABILITY"
 #define DISCONN_DELAY_TIME 200
 #define MAGIC_NUMBER  0xBABEFACE
 #define TIMEOUT_DISCONNECT 1000
@@ -63,10 +66,17 @@
 #define PRIORITY_HIGH 64
 #define PRIORITY_MID 8
 #define PRIORITY_LOW 1
-#define PRIORITY_DAF 1
+#define BR_SEND_CONGESTED 1
 #define INVALID_VALUE (-1)
+/* items queued over all connections, a memory ceiling only; each connection is capped at g_brSendQueueMaxLen */
 #define MAX_BR_SENDQUEQUE_SIZE (10*10)
 #define BT_ADDR_LEN_RFCOM 6
+#define BR_REF_MSG_TAG 0x01
+#define BR_REF_MSG_LEN 12
+/* the peer decodes binary ref messages, sent in METHOD_NOTIFY_CAPABILITY once the link is up */
+#define BR_CAP_BINARY_REF 0x1
+#define BR_RECV_FRAME_ALIGN 8
+#define BR_RECV_ALIGN(len) (((len) + BR_RECV_FRAME_ALIGN - 1) & ~(BR_RECV_FRAME_ALIGN - 1))
 
 typedef struct {
     ListNode node;
@@ -74,6 +84,46 @@ typedef struct {
     ConnectResult callback;
 } RequestInfo;
 
+enum BrSendClass {
+    BR_SEND_CLASS_HIGH = 0,
+    BR_SEND_CLASS_MID,
+    BR_SEND_CLASS_LOW,
+    BR_SEND_CLASS_NUM
+};
+
+/* items per turn a class may send before the lower classes get theirs */
+static const int32_t g_sendClassWeight[BR_SEND_CLASS_NUM] = { PRIORITY_HIGH, PRIORITY_MID, PRIORITY_LOW };
+
+/* pending data of one connection, guarded by g_dataQueue.lock */
+typedef struct {
+    ListNode node; /* link in g_dataQueue.readyList while any class has data */
+    ListNode queue[BR_SEND_CLASS_NUM];
+    int32_t quota[BR_SEND_CLASS_NUM];
+    bool isReady;
+    int32_t itemCount;
+    ListNode writableNode; /* link in g_dataQueue.writableList while OnWritable is armed */
+    bool isWritableArmed;
+} BrSendQueue;
+
+/*
+ * Frames are reassembled in place, each starting BR_RECV_FRAME_ALIGN aligned: [r, parsed) holds complete
+ * frames waiting for RecvHandlerLoop, [parsed, w) the frame still arriving. While busy, RecvHandlerLoop reads
+ * [r, parsed) without g_recvQueue.lock, so the ring is only compacted when it is idle.
+ */
+typedef struct {
+    ListNode node;
+    uint32_t connectionId;
+    char *buf;
+    int32_t size;
+    int32_t r;
+    int32_t parsed;
+    int32_t w;
+    int32_t holders;
+    bool isReady;
+    bool busy;
+    bool closed;
+} BrRecvRing;
+
 typedef struct {
     ListNode node;
     uint32_t connectionId;
@@ -84,12 +134,13 @@ typedef struct {
     int32_t state;
     int32_t refCount;
     int32_t refCountRemote;
-    char *recvBuf;
-    int32_t recvPos;
+    int32_t peerCapability;
+    BrRecvRing *recvRing;
     int32_t conGestState;
     ListNode requestList;
     pthread_mutex_t lock;
     pthread_cond_t congestCond;
+    BrSendQueue sendQueue;
 } BrConnectionInfo;
 
 typedef struct {
@@ -103,36 +154,33 @@ typedef struct {
 } SendItemStruct;
 
 typedef struct {
-    ListNode node;
-    int32_t pid;
+    ListNode readyList;
+    ListNode writableList;
     int32_t itemCount;
-} DataPidQueueStruct;
-
-typedef struct {
-    ListNode sendList;
-    ListNode pidList;
     pthread_mutex_t lock;
     pthread_cond_t cond;
     SoftBusHandler *handler;
 } DataQueueStruct;
 
 typedef struct {
-    ListNode node;
-    uint32_t connectionId;
-    int32_t module;
-    long seqNum;
-    int32_t flag;
-    uint32_t dataLen;
-    uint8_t *data;
-} ReceiveItemStruct;
-
-typedef struct {
-    ListNode recvList;
+    ListNode readyList;
     pthread_mutex_t lock;
     pthread_cond_t cond;
+    pthread_cond_t spaceCond;
     SoftBusHandler *handler;
 } RecvQueueStruct;
 
+/*
+ * A decoded MODULE_CONNECTION frame. The binary body is BR_REF_MSG_LEN bytes: tag, method, two reserved
+ * bytes, then delta and refNum in network byte order. JSON bodies always start with '{'.
+ */
+typedef struct {
+    int32_t method;
+    int32_t delta;
+    int32_t refNum;
+    int32_t capability;
+} BrRefMessage;
+
 enum BRConnectionState {
     BR_CONNECTION_STATE_CONNECTING = 0,
     BR_CONNECTION_STATE_CONNECTED,
@@ -149,13 +197,16 @@ static void ServerOnEvent(int32_t type, int32_t socketFd, int32_t value);
 static void ServerOnDataReceived(int32_t socketFd, const char *buf, int32_t len);
 
 static bool GetJsonObjectNumberItem(const cJSON *json, const char * const string, int *target);
-
 static bool AddNumberToJsonObject(cJSON *obj, const char * const string, int32_t num);
 
 static int32_t ConnectDevice(const ConnectOption *option, uint32_t requestId, const ConnectResult *result);
 
 static int32_t PostBytes(uint32_t connectionId, const char *data, int32_t len, int32_t pid, int32_t flag);
 
+static int32_t GetSendWindow(uint32_t connectionId, uint32_t *window);
+
+static int32_t GetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit);
+
 static int32_t DisconnectDevice(uint32_t connectionId);
 
 static int32_t DisconnectDeviceNow(const ConnectOption *option);
@@ -168,9 +219,11 @@ static int32_t StopLocalListening(const LocalListenerInfo *info);
 
 static void ClientOnBrDisconnect(int32_t socketFd, int32_t value);
 
-static void ClearSendItemByConnId(uint32_t connectionId);
+static void InitSendQueue(BrSendQueue *sendQueue);
 
-static void ClearReceiveQueueByConnId(uint32_t connectionId);
+static void ClearSendQueue(BrSendQueue *sendQueue);
+
+static void CloseRecvRing(BrRecvRing *ring);
 
 static int32_t ConvertBtMacToBinary(char *strMac, int32_t strMacLen,
     const uint8_t *binMac, int32_t binMacLen)
@@ -218,6 +271,8 @@ static SppSocketEventCallback g_sppSocketServiceCallback = {
 static ConnectFuncInterface g_brInterface = {
     .ConnectDevice = ConnectDevice,
     .PostBytes = PostBytes,
+    .GetSendWindow = GetSendWindow,
+    .GetLinkLimit = GetLinkLimit,
     .DisconnectDevice = DisconnectDevice,
     .DisconnectDeviceNow = DisconnectDeviceNow,
     .GetConnectionInfo = GetConnectionInfo,
@@ -232,6 +287,8 @@ static const uint8_t UUID[BT_UUID_LEN] = {
 };
 
 static LIST_HEAD(g_conection_list);
+/* indexes g_conection_list by connectionId, updated with g_connectionLock held */
+static ConnIdTable g_brConnTable;
 static DataQueueStruct g_dataQueue;
 static RecvQueueStruct g_recvQueue;
 static SppSocketDriver *g_sppDriver = NULL;
@@ -245,66 +302,58 @@ static int32_t AllocNewConnectionIdLocked()
 {
     g_nextConnectionId++;
     int32_t tempId;
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
+        return (CONNECT_BR << CONNECT_TYPE_SHIFT) + g_nextConnectionId;
+    }
     while (1) {
         tempId = (CONNECT_BR << CONNECT_TYPE_SHIFT) + g_nextConnectionId;
-        ListNode *item = NULL;
-        LIST_FOR_EACH(item, &g_conection_list) {
-            BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
-            if (itemNode->connectionId == tempId) {
-                g_nextConnectionId++;
-                continue;
-            }
+        if (ConnIdTableFind(&g_brConnTable, (uint32_t)tempId) == NULL) {
+            break;
         }
-        break;
+        g_nextConnectionId++;
     }
+    ConnIdTableUnlock(&g_brConnTable);
     return tempId;
 }
 
 static int32_t GetConnectionInfo(uint32_t connectionId, ConnectionInfo *info)
 {
     int32_t result = SOFTBUS_ERR;
-    if (pthread_mutex_lock(&g_connectionLock) != 0) {
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock mutex failed");
         return SOFTBUS_ERR;
     }
-    ListNode *item = NULL;
-    LIST_FOR_EACH(item, &g_conection_list) {
-        BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
-        if (itemNode->connectionId == connectionId) {
-            info->isAvailable = 1;
-            info->isServer = itemNode->sideType;
-            info->type = CONNECT_BR;
-            if (strncpy_s(info->info.brInfo.brMac, BT_MAC_LEN,
-                itemNode->mac, sizeof(itemNode->mac)) != EOK) {
-                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "GetConnInfo scpy error");
-                (void)pthread_mutex_unlock(&g_connectionLock);
-                return SOFTBUS_BRCONNECTION_GETCONNINFO_ERROR;
-            }
-            result = SOFTBUS_OK;
-            break;
+    BrConnectionInfo *itemNode = (BrConnectionInfo *)ConnIdTableFind(&g_brConnTable, connectionId);
+    if (itemNode != NULL) {
+        info->isAvailable = 1;
+        info->isServer = itemNode->sideType;
+        info->type = CONNECT_BR;
+        if (strncpy_s(info->info.brInfo.brMac, BT_MAC_LEN,
+            itemNode->mac, sizeof(itemNode->mac)) != EOK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "GetConnInfo scpy error");
+            ConnIdTableUnlock(&g_brConnTable);
+            return SOFTBUS_BRCONNECTION_GETCONNINFO_ERROR;
         }
+        result = SOFTBUS_OK;
     }
-    (void)pthread_mutex_unlock(&g_connectionLock);
+    ConnIdTableUnlock(&g_brConnTable);
     return result;
 }
 
-static BrConnectionInfo *GetConnectionRef(uint32_t connID)
+static int32_t AddConnectionLocked(BrConnectionInfo *conn)
 {
-    BrConnectionInfo *result = NULL;
-    ListNode *item = NULL;
-    LIST_FOR_EACH(item, &g_conection_list) {
-        BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
-        if (itemNode->connectionId == connID) {
-            result = itemNode;
-            break;
-        }
+    if (ConnIdTableAdd(&g_brConnTable, conn->connectionId, conn) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "add connection %u failed", conn->connectionId);
+        return SOFTBUS_ERR;
     }
-    return result;
+    ListAdd(&g_conection_list, &conn->node);
+    return SOFTBUS_OK;
 }
 
 static void ReleaseConnection(BrConnectionInfo *conn)
 {
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "ReleaseConnection node + u%", conn->connectionId);
+    ClearSendQueue(&conn->sendQueue);
     ListNode *item = NULL;
     ListNode *nextItem = NULL;
     LIST_FOR_EACH_SAFE(item, nextItem, &conn->requestList) {
@@ -314,7 +363,7 @@ static void ReleaseConnection(BrConnectionInfo *conn)
     }
     pthread_cond_destroy(&conn->congestCond);
     pthread_mutex_destroy(&conn->lock);
-    SoftBusFree(conn->recvBuf);
+    CloseRecvRing(conn->recvRing);
     SoftBusFree(conn);
 }
 
@@ -324,79 +373,103 @@ static void ReleaseConnectionRef(BrConnectionInfo *conn)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock mutex failed");
         return;
     }
+    (void)ConnIdTableRemove(&g_brConnTable, conn->connectionId);
     ListDelete(&conn->node);
     ReleaseConnection(conn);
     (void)pthread_mutex_unlock(&g_connectionLock);
 }
 
-static int AddNumToJson(cJSON *json, int32_t requestOrResponse, int32_t delta, int32_t count)
+static void PutInt32Be(uint8_t *buf, int32_t value)
 {
-    if (requestOrResponse == METHOD_NOTIFY_REQUEST) {
-        if (!AddNumberToJsonObject(json, KEY_METHOD, METHOD_NOTIFY_REQUEST) ||
-            !AddNumberToJsonObject(json, KEY_DELTA, delta) ||
-            !AddNumberToJsonObject(json, KEY_REFERENCE_NUM, count)) {
-            return SOFTBUS_BRCONNECTION_PACKJSON_ERROR;
-        }
-    } else {
-        if (!AddNumberToJsonObject(json, KEY_METHOD, METHOD_NOTIFY_RESPONSE) ||
-            !AddNumberToJsonObject(json, KEY_REFERENCE_NUM, count)) {
-            return SOFTBUS_BRCONNECTION_PACKJSON_ERROR;
-        }
-    }
-    return SOFTBUS_OK;
+    uint32_t v = (uint32_t)value;
+    buf[0] = (uint8_t)(v >> 24);
+    buf[1] = (uint8_t)(v >> 16);
+    buf[2] = (uint8_t)(v >> 8);
+    buf[3] = (uint8_t)v;
 }
 
-static void SendRefMessage(int32_t delta, int32_t connectionId, int32_t count, int32_t requestOrResponse)
+static int32_t GetInt32Be(const uint8_t *buf)
 {
-    cJSON *json =  cJSON_CreateObject();
-    if (json == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot create cJSON object");
+    return (int32_t)(((uint32_t)buf[0] << 24) | ((uint32_t)buf[1] << 16) | ((uint32_t)buf[2] << 8) | buf[3]);
+}
+
+static void PostConnectionMessage(int32_t connectionId, const char *body, int32_t bodyLen)
+{
+    int32_t headSize = sizeof(ConnPktHead);
+    int32_t dataLen = headSize + bodyLen;
+    char *buf = (char *)SoftBusCalloc(dataLen);
+    if (buf == NULL) {
         return;
     }
-    if (AddNumToJson(json, requestOrResponse, delta, count) != SOFTBUS_OK) {
-        cJSON_Delete(json);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot AddNumToJson");
+    ConnPktHead head;
+    head.magic = MAGIC_NUMBER;
+    head.module = MODULE_CONNECTION;
+    head.seq = 1;
+    head.flag = 0;
+    head.len = bodyLen;
+    if (memcpy_s(buf, dataLen, &head, headSize) != EOK ||
+        memcpy_s(buf + headSize, dataLen - headSize, body, bodyLen) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memcpy_s connection message error");
+        SoftBusFree(buf);
         return;
     }
+    (void)PostBytes(connectionId, buf, dataLen, 0, 0);
+}
 
+static void PostJsonMessage(int32_t connectionId, cJSON *json)
+{
     char *data = cJSON_PrintUnformatted(json);
-    cJSON_Delete(json);
     if (data == NULL) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "cJSON_PrintUnformatted failed");
         return;
     }
+    PostConnectionMessage(connectionId, data, strlen(data) + 1);
+    cJSON_free(data);
+}
 
-    int32_t headSize = sizeof(ConnPktHead);
-    int32_t dataLen = strlen(data) + 1 + headSize;
-    char *buf = (char *)SoftBusCalloc(dataLen);
-    if (buf == NULL) {
-        cJSON_free(data);
+/* JSON until the peer has advertised BR_CAP_BINARY_REF, older peers only parse JSON */
+static void SendRefMessage(int32_t delta, int32_t connectionId, int32_t count, int32_t requestOrResponse,
+    bool peerBinary)
+{
+    if (peerBinary) {
+        uint8_t body[BR_REF_MSG_LEN] = { BR_REF_MSG_TAG, (uint8_t)requestOrResponse };
+        PutInt32Be(body + 4, delta);
+        PutInt32Be(body + 8, count);
+        PostConnectionMessage(connectionId, (const char *)body, sizeof(body));
         return;
     }
-    ConnPktHead head;
-    head.magic = MAGIC_NUMBER;
-    head.module = MODULE_CONNECTION;
-    head.seq = 1;
-    head.flag = 0;
-    head.len = strlen(data) + 1;
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot create cJSON object");
+        return;
+    }
+    if (!AddNumberToJsonObject(json, KEY_METHOD, requestOrResponse) ||
+        !AddNumberToJsonObject(json, KEY_REFERENCE_NUM, count) ||
+        (requestOrResponse == METHOD_NOTIFY_REQUEST && !AddNumberToJsonObject(json, KEY_DELTA, delta))) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot pack ref message");
+        cJSON_Delete(json);
+        return;
+    }
+    PostJsonMessage(connectionId, json);
+    cJSON_Delete(json);
+}
 
-    if (memcpy_s(buf, dataLen, (void *)&head, headSize)) {
-        cJSON_free(data);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memcpy_s head error");
-        cJSON_free(data);
-        SoftBusFree(buf);
+/* sent by both sides once the link is up; older peers ignore a method they do not know */
+static void SendCapabilityMessage(int32_t connectionId)
+{
+    cJSON *json = cJSON_CreateObject();
+    if (json == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot create cJSON object");
         return;
     }
-    if (memcpy_s(buf + headSize, dataLen - headSize, data, strlen(data) + 1)) {
-        cJSON_free(data);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memcpy_s data error");
-        cJSON_free(data);
-        SoftBusFree(buf);
+    if (!AddNumberToJsonObject(json, KEY_METHOD, METHOD_NOTIFY_CAPABILITY) ||
+        !AddNumberToJsonObject(json, KEY_CAPABILITY, BR_CAP_BINARY_REF)) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Cannot pack capability message");
+        cJSON_Delete(json);
         return;
     }
-    (void)PostBytes(connectionId, buf, dataLen, 0, 0);
-    cJSON_free(data);
-    return;
+    PostJsonMessage(connectionId, json);
+    cJSON_Delete(json);
 }
 
 static void PackRequest(int32_t delta, int32_t connectionId)
@@ -405,6 +478,7 @@ static void PackRequest(int32_t delta, int32_t connectionId)
     ListNode *item = NULL;
     BrConnectionInfo *targetNode = NULL;
     int refCount;
+    bool peerBinary = false;
     if (pthread_mutex_lock(&g_connectionLock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock mutex failed");
         return;
@@ -414,6 +488,7 @@ static void PackRequest(int32_t delta, int32_t connectionId)
         if (itemNode->connectionId == connectionId) {
             itemNode->refCount += delta;
             refCount = itemNode->refCount;
+            peerBinary = (itemNode->peerCapability & BR_CAP_BINARY_REF) != 0;
             targetNode = itemNode;
             break;
         }
@@ -424,7 +499,7 @@ static void PackRequest(int32_t delta, int32_t connectionId)
     }
     (void)pthread_mutex_unlock(&g_connectionLock);
 
-    SendRefMessage(delta, connectionId, refCount, METHOD_NOTIFY_REQUEST);
+    SendRefMessage(delta, connectionId, refCount, METHOD_NOTIFY_REQUEST, peerBinary);
 }
 
 static void OnPackResponse(int32_t delta, int32_t peerRef, int32_t connectionId)
@@ -435,6 +510,7 @@ static void OnPackResponse(int32_t delta, int32_t peerRef, int32_t connectionId)
     BrConnectionInfo *targetNode = NULL;
     int myRefCount;
     int mySocketFd;
+    bool peerBinary = false;
     if (pthread_mutex_lock(&g_connectionLock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock mutex failed");
         return;
@@ -446,6 +522,7 @@ static void OnPackResponse(int32_t delta, int32_t peerRef, int32_t connectionId)
             targetNode->refCount += delta;
             myRefCount = targetNode->refCount;
             mySocketFd = targetNode->socketFd;
+            peerBinary = (targetNode->peerCapability & BR_CAP_BINARY_REF) != 0;
             break;
         }
     }
@@ -465,7 +542,7 @@ static void OnPackResponse(int32_t delta, int32_t peerRef, int32_t connectionId)
         g_sppDriver->CloseClient(mySocketFd);
         return;
     }
-    SendRefMessage(delta, connectionId, myRefCount, METHOD_NOTIFY_RESPONSE);
+    SendRefMessage(delta, connectionId, myRefCount, METHOD_NOTIFY_RESPONSE, peerBinary);
 }
 
 static int32_t HasDiffMacDeviceExit(const ConnectOption *option)
@@ -500,9 +577,7 @@ static void ReleaseBrconnectionNode(BrConnectionInfo *newConnectionInfo)
     pthread_cond_destroy(&newConnectionInfo->congestCond);
     pthread_mutex_destroy(&newConnectionInfo->lock);
     pthread_mutex_destroy(&newConnectionInfo->lock);
-    if (newConnectionInfo->recvBuf != NULL) {
-        SoftBusFree(newConnectionInfo->recvBuf);
-    }
+    CloseRecvRing(newConnectionInfo->recvRing);
     RequestInfo *requestInfo = NULL;
     ListNode *item = NULL;
     ListNode *itemNext = NULL;
@@ -517,6 +592,24 @@ static void ReleaseBrconnectionNode(BrConnectionInfo *newConnectionInfo)
     return;
 }
 
+static BrRecvRing *CreateRecvRing(void)
+{
+    BrRecvRing *ring = (BrRecvRing *)SoftBusCalloc(sizeof(BrRecvRing));
+    if (ring == NULL) {
+        return NULL;
+    }
+    /* room for a full frame arriving behind one that RecvHandlerLoop is still dispatching */
+    ring->size = BR_RECV_ALIGN(g_brBuffSize) * 2;
+    ring->buf = (char *)SoftBusMalloc(ring->size);
+    if (ring->buf == NULL) {
+        SoftBusFree(ring);
+        return NULL;
+    }
+    ListInit(&ring->node);
+    ring->holders = 1;
+    return ring;
+}
+
 static BrConnectionInfo* CreateBrconnectionNode(int clientFlag)
 {
     BrConnectionInfo *newConnectionInfo = SoftBusCalloc(sizeof(BrConnectionInfo));
@@ -524,9 +617,9 @@ static BrConnectionInfo* CreateBrconnectionNode(int clientFlag)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ConnectDeviceFristTime malloc fail.]");
         return NULL;
     }
-    newConnectionInfo->recvBuf = SoftBusCalloc(g_brBuffSize);
-    if (newConnectionInfo->recvBuf == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[SoftBusMalloc recvBuf fail]");
+    newConnectionInfo->recvRing = CreateRecvRing();
+    if (newConnectionInfo->recvRing == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[SoftBusMalloc recvRing fail]");
         SoftBusFree(newConnectionInfo);
         return NULL;
     }
@@ -534,9 +627,10 @@ static BrConnectionInfo* CreateBrconnectionNode(int clientFlag)
     ListInit(&newConnectionInfo->requestList);
     pthread_mutex_init(&newConnectionInfo->lock, NULL);
     newConnectionInfo->connectionId = AllocNewConnectionIdLocked();
-    newConnectionInfo->recvPos = 0;
+    newConnectionInfo->recvRing->connectionId = newConnectionInfo->connectionId;
     newConnectionInfo->conGestState = BT_RFCOM_CONGEST_OFF;
     pthread_cond_init(&newConnectionInfo->congestCond, NULL);
+    InitSendQueue(&newConnectionInfo->sendQueue);
     newConnectionInfo->refCount = 1;
     return newConnectionInfo;
 }
@@ -581,7 +675,11 @@ static int32_t ConnectDeviceFristTime(const ConnectOption *option, uint32_t requ
     newConnectionInfo->socketFd = socketFd;
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
         "[new connection %d,socket=%d", newConnectionInfo->connectionId, socketFd);
-    ListAdd(&g_conection_list, &newConnectionInfo->node);
+    if (AddConnectionLocked(newConnectionInfo) != SOFTBUS_OK) {
+        g_sppDriver->CloseClient(socketFd);
+        ReleaseBrconnectionNode(newConnectionInfo);
+        return SOFTBUS_ERR;
+    }
     int32_t ret = g_sppDriver->Connect(socketFd, &g_sppSocketClientCallback);
     return ret;
 }
@@ -689,6 +787,12 @@ void RfcomCongestEvent(int32_t socketFd, int32_t value)
         }
     }
     (void)pthread_mutex_unlock(&g_connectionLock);
+    if (value == BT_RFCOM_CONGEST_OFF) {
+        /* the sender may be idle because every link with data was congested */
+        (void)pthread_mutex_lock(&g_dataQueue.lock);
+        pthread_cond_broadcast(&g_dataQueue.cond);
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+    }
 }
 
 static void ClientOnBrConnect(int32_t socketFd)
@@ -726,6 +830,7 @@ static void ClientOnBrConnect(int32_t socketFd)
     }
     (void)pthread_mutex_unlock(&g_connectionLock);
     if (connectionId != 0) {
+        SendCapabilityMessage(connectionId);
         DeviceConnectPackRequest(packRequestFlag, connectionId);
         LIST_FOR_EACH_SAFE(item, itemNext, &notifyList) {
             requestInfo = LIST_ENTRY(item, RequestInfo, node);
@@ -831,8 +936,6 @@ static void ClientOnBrDisconnect(int32_t socketFd, int32_t value)
             break;
         }
     }
-    ClearSendItemByConnId(connectionId);
-    ClearReceiveQueueByConnId(connectionId);
     ReleaseConnectionRef(brNode);
     (void)pthread_mutex_unlock(&g_connectionLock);
     if (connectionId != -1) {
@@ -840,172 +943,157 @@ static void ClientOnBrDisconnect(int32_t socketFd, int32_t value)
     }
 }
 
-static int32_t ReceivedHeadCheck(const ConnPktHead *head, BrConnectionInfo *conn)
+static void PutRecvRingLocked(BrRecvRing *ring)
 {
-    if (head->magic != 0xBABEFACE) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ClientOnDataReceived] magic error 0x%x", head->magic);
-        conn->recvPos = 0;
-        return SOFTBUS_ERR;
+    ring->holders--;
+    if (ring->holders == 0) {
+        SoftBusFree(ring->buf);
+        SoftBusFree(ring);
     }
+}
 
-    if (head->len > (g_brBuffSize - sizeof(ConnPktHead))) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
-            "[ClientOnDataReceived]data too large . module=%d,seq=%lld, datalen=%d",
-            head->module, head->seq, head->len);
-        conn->recvPos = 0;
-        return SOFTBUS_ERR;
+/* called once by the owning connection, frames not yet dispatched are dropped */
+static void CloseRecvRing(BrRecvRing *ring)
+{
+    if (ring == NULL) {
+        return;
     }
-    return SOFTBUS_OK;
+    (void)pthread_mutex_lock(&g_recvQueue.lock);
+    ring->closed = true;
+    if (ring->isReady) {
+        ListDelete(&ring->node);
+        ring->isReady = false;
+    }
+    pthread_cond_broadcast(&g_recvQueue.spaceCond);
+    PutRecvRingLocked(ring);
+    (void)pthread_mutex_unlock(&g_recvQueue.lock);
 }
 
-static int32_t ReceivedError(ReceiveItemStruct *recvItem, char *dataCopy,
-    const char *bufHead, const ConnPktHead  *head, int32_t sendToManagerLen)
+static void MarkRecvRingReadyLocked(BrRecvRing *ring)
 {
-    if (recvItem == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "malloc recvItem fail");
-        if (dataCopy != NULL) {
-            SoftBusFree(dataCopy);
-        }
-        return SOFTBUS_ERR;
+    if (ring->isReady || ring->busy || ring->closed) {
+        return;
+    }
+    ListTailInsert(&g_recvQueue.readyList, &ring->node);
+    ring->isReady = true;
+    pthread_cond_signal(&g_recvQueue.cond);
+}
+
+static void CompactRecvRingLocked(BrRecvRing *ring)
+{
+    if (ring->r == 0) {
+        return;
+    }
+    if (ring->w > ring->r &&
+        memmove_s(ring->buf, ring->size, ring->buf + ring->r, ring->w - ring->r) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memmove_s failed");
+        return;
     }
-    if (dataCopy == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "malloc dataCopy fail");
-        SoftBusFree(recvItem);
+    ring->parsed -= ring->r;
+    ring->w -= ring->r;
+    ring->r = 0;
+}
+
+static int32_t ReceivedHeadCheck(const ConnPktHead *head)
+{
+    if (head->magic != (int32_t)MAGIC_NUMBER) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ClientOnDataReceived] magic error 0x%x", head->magic);
         return SOFTBUS_ERR;
     }
-    if (memcpy_s(dataCopy, sendToManagerLen,
-        bufHead, head->len + sizeof(ConnPktHead)) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ReceivedError memcpy_s failed");
-        SoftBusFree(dataCopy);
-        SoftBusFree(recvItem);
+    if (head->len < 0 || head->len > (int32_t)(g_brBuffSize - sizeof(ConnPktHead))) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
+            "[ClientOnDataReceived]data too large . module=%d,seq=%lld, datalen=%d",
+            head->module, head->seq, head->len);
         return SOFTBUS_ERR;
     }
     return SOFTBUS_OK;
 }
 
-
-static void InitRecvItemAndInsert(ReceiveItemStruct *recvItem, int32_t connectionId,
-    const ConnPktHead *head, int32_t sendToManagerLen, const char *dataCopy)
+/* returns how much of data went into the ring, 0 when it has to wait for RecvHandlerLoop to free room */
+static int32_t RecvRingWriteLocked(BrRecvRing *ring, const char *data, int32_t len)
 {
-    recvItem->connectionId = connectionId;
-    recvItem->module = head->module;
-    recvItem->seqNum = head->seq;
-    recvItem->flag = head->flag;
-    recvItem->dataLen = sendToManagerLen;
-    recvItem->data = (uint8_t*)dataCopy;
-    if (pthread_mutex_lock(&g_recvQueue.lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "InitRecvItemAndInsert mutex failed");
-        return;
-    }
-    if (recvItem->module == MODULE_DEVICE_AUTH) {
-        ListAdd(&g_recvQueue.recvList, &recvItem->node);
-    } else {
-        ListTailInsert(&g_recvQueue.recvList, &recvItem->node);
+    int32_t headSize = sizeof(ConnPktHead);
+    ConnPktHead head;
+    int32_t done = 0;
+    while (done < len) {
+        if (ring->w == ring->size && !ring->busy) {
+            CompactRecvRingLocked(ring);
+        }
+        int32_t room = ring->size - ring->w;
+        if (room == 0) {
+            break;
+        }
+        int32_t partial = ring->w - ring->parsed;
+        int32_t need = headSize - partial;
+        if (partial >= headSize) {
+            (void)memcpy_s(&head, sizeof(head), ring->buf + ring->parsed, headSize);
+            need = headSize + head.len - partial;
+        }
+        int32_t count = len - done;
+        count = (count < need) ? count : need;
+        count = (count < room) ? count : room;
+        if (memcpy_s(ring->buf + ring->w, room, data + done, count) != EOK) {
+            return SOFTBUS_MEM_ERR;
+        }
+        ring->w += count;
+        done += count;
+        partial += count;
+        if (partial < headSize) {
+            continue;
+        }
+        (void)memcpy_s(&head, sizeof(head), ring->buf + ring->parsed, headSize);
+        if (ReceivedHeadCheck(&head) != SOFTBUS_OK) {
+            ring->w = ring->parsed;
+            return SOFTBUS_ERR;
+        }
+        if (partial == headSize + head.len) {
+            ring->parsed = BR_RECV_ALIGN(ring->w);
+            ring->w = ring->parsed;
+            MarkRecvRingReadyLocked(ring);
+        }
     }
-    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "[ClientOnDataReceived] connectionId=%d", connectionId);
-    pthread_cond_signal(&g_recvQueue.cond);
-    (void)pthread_mutex_unlock(&g_recvQueue.lock);
+    return done;
 }
 
 static void ClientOnDataReceived(int32_t socketFd, const char *buf, int32_t len)
 {
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "[ClientOnDataReceived] socketFd=%d,len=%d", socketFd, len);
-    BrConnectionInfo *conn = NULL;
+    if (buf == NULL || len <= 0) {
+        return;
+    }
+    BrRecvRing *ring = NULL;
     (void)pthread_mutex_lock(&g_connectionLock);
     ListNode *item = NULL;
     LIST_FOR_EACH(item, &g_conection_list) {
         BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
         if (itemNode->socketFd == socketFd) {
-            conn = itemNode;
+            ring = itemNode->recvRing;
             break;
         }
     }
-
-    if (conn == NULL) {
+    if (ring == NULL) {
         (void)pthread_mutex_unlock(&g_connectionLock);
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ClientOnDataReceived] not found socket=%d", socketFd);
         return;
     }
+    (void)pthread_mutex_lock(&g_recvQueue.lock);
+    ring->holders++;
+    (void)pthread_mutex_unlock(&g_connectionLock);
 
-    char *bufHead = (char*)buf;
-    int32_t bufLen = len;
-    bool isCopy = false;
-    if (conn->recvPos != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_DBG, "[ClientOnDataReceived] recvPos=%d", conn->recvPos);
-        (void)memcpy_s(conn->recvBuf + conn->recvPos, g_brBuffSize - conn->recvPos, buf, len);
-        conn->recvPos += len;
-        isCopy = true;
-        bufHead = conn->recvBuf;
-        bufLen = conn->recvPos;
-    }
-    // recv head
-    if (bufLen < sizeof(ConnPktHead)) {
-        if (!isCopy) {
-            (void)memcpy_s(conn->recvBuf + conn->recvPos, g_brBuffSize - conn->recvPos, buf, len);
-            conn->recvPos += len;
-            isCopy = true;
+    int32_t done = 0;
+    while (!ring->closed && done < len) {
+        int32_t ret = RecvRingWriteLocked(ring, buf + done, len - done);
+        if (ret < 0) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ClientOnDataReceived] socket=%d drop data", socketFd);
+            break;
         }
-        (void)pthread_mutex_unlock(&g_connectionLock);
-        return;
-    }
-
-    ConnPktHead *head = (ConnPktHead *)bufHead;
-    if (ReceivedHeadCheck(head, conn) != SOFTBUS_OK) {
-        (void)pthread_mutex_unlock(&g_connectionLock);
-        return;
-    }
-
-    if (head->len > (bufLen - sizeof(ConnPktHead))) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
-            "[ClientOnDataReceived] socket=%d , continue to recv", socketFd);
-        if (!isCopy) {
-            (void)memcpy_s(conn->recvBuf + conn->recvPos, g_brBuffSize - conn->recvPos, buf, len);
-            conn->recvPos += len;
-            isCopy = true;
+        done += ret;
+        if (done < len) {
+            pthread_cond_wait(&g_recvQueue.spaceCond, &g_recvQueue.lock);
         }
-        (void)pthread_mutex_unlock(&g_connectionLock);
-        return;
-    }
-    bool headtogether = false;
-    int32_t sendToManagerLen = bufLen;
-    if (head->len < (bufLen - sizeof(ConnPktHead))) {
-        headtogether = true;
-        sendToManagerLen = head->len + sizeof(ConnPktHead);
     }
-    if (g_connectCallback != NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[ClientOnDataReceived] socket=%d , ready to insert", socketFd);
-        ReceiveItemStruct *recvItem = SoftBusMalloc(sizeof(ReceiveItemStruct));
-        if (recvItem == NULL) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "malloc failed");
-            (void)pthread_mutex_unlock(&g_connectionLock);
-            return;
-        }
-        char *dataCopy = SoftBusMalloc(sendToManagerLen);
-        if (dataCopy == NULL) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "malloc failed");
-            SoftBusFree(recvItem);
-            (void)pthread_mutex_unlock(&g_connectionLock);
-            return;
-        }
-        if (ReceivedError(recvItem, dataCopy, bufHead, head, sendToManagerLen) != SOFTBUS_OK) {
-            conn->recvPos = 0;
-            (void)pthread_mutex_unlock(&g_connectionLock);
-            return;
-        }
-        InitRecvItemAndInsert(recvItem, conn->connectionId, head, sendToManagerLen, dataCopy);
-    }
-    if (headtogether == false) {
-        conn->recvPos = 0;
-    } else {
-        if (memmove_s(conn->recvBuf, g_brBuffSize,
-            conn->recvBuf + sendToManagerLen, bufLen - sendToManagerLen) != EOK) {
-                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memmove_s failed");
-                (void)pthread_mutex_unlock(&g_connectionLock);
-                return;
-            }
-        conn->recvPos = bufLen - sendToManagerLen;
-    }
-    (void)pthread_mutex_unlock(&g_connectionLock);
+    PutRecvRingLocked(ring);
+    (void)pthread_mutex_unlock(&g_recvQueue.lock);
 }
 
 static int32_t NotifyServerConn(int connectionId, const BrConnectionInfo *conn)
@@ -1069,10 +1157,18 @@ static void ServerOnBrConnect(int32_t type, int32_t socketFd, int32_t value)
     newConnectionInfo->state = BR_CONNECTION_STATE_CONNECTED;
     newConnectionInfo->sideType = BR_SERVICE_TYPE;
     int connectionId = newConnectionInfo->connectionId;
-    ListAdd(&g_conection_list, &newConnectionInfo->node);
-    if (NotifyServerConn(connectionId, newConnectionInfo) != SOFTBUS_OK) {
+    (void)pthread_mutex_lock(&g_connectionLock);
+    if (AddConnectionLocked(newConnectionInfo) != SOFTBUS_OK) {
+        (void)pthread_mutex_unlock(&g_connectionLock);
         ReleaseBrconnectionNode(newConnectionInfo);
         g_sppDriver->CloseClient(value);
+        return;
+    }
+    (void)pthread_mutex_unlock(&g_connectionLock);
+    SendCapabilityMessage(connectionId);
+    if (NotifyServerConn(connectionId, newConnectionInfo) != SOFTBUS_OK) {
+        ReleaseConnectionRef(newConnectionInfo);
+        g_sppDriver->CloseClient(value);
     }
     return;
 }
@@ -1102,56 +1198,127 @@ static int32_t GetPriority(int32_t flag)
     int priority;
     switch (flag) {
         case CONN_HIGH: {
-            priority = PRIORITY_HIGH;
+            priority = BR_SEND_CLASS_HIGH;
             break;
         }
         case CONN_MIDDLE: {
-            priority = PRIORITY_MID;
-            break;
-        }
-        case CONN_LOW: {
-            priority = PRIORITY_LOW;
+            priority = BR_SEND_CLASS_MID;
             break;
         }
         default:
-            priority = PRIORITY_DAF;
+            priority = BR_SEND_CLASS_LOW;
             break;
     }
     return priority;
 }
 
-static int32_t CheckSendQueueLength(void)
+/* OnWritable fires once the connection drains to half of g_brSendQueueMaxLen and the shared ceiling to half */
+static void ArmWritableLocked(BrSendQueue *sendQueue)
 {
-    int totalSendNum = 0;
-    ListNode *sendItemNode = NULL;
-    if (pthread_mutex_lock(&g_dataQueue.lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "CheckSendQueueLength mutex failed");
-        return SOFTBUS_ERR;
+    if (!sendQueue->isWritableArmed) {
+        ListTailInsert(&g_dataQueue.writableList, &sendQueue->writableNode);
+        sendQueue->isWritableArmed = true;
     }
-    LIST_FOR_EACH(sendItemNode, &g_dataQueue.sendList) {
-        totalSendNum++;
+}
+
+static void DisarmWritableLocked(BrSendQueue *sendQueue)
+{
+    if (sendQueue->isWritableArmed) {
+        ListDelete(&sendQueue->writableNode);
+        sendQueue->isWritableArmed = false;
     }
-    (void)pthread_mutex_unlock(&g_dataQueue.lock);
-    if (totalSendNum > g_brSendQueueMaxLen) {
+}
+
+static bool IsWritableDueLocked(const BrSendQueue *sendQueue)
+{
+    return sendQueue->itemCount <= g_brSendQueueMaxLen / 2 && g_dataQueue.itemCount <= MAX_BR_SENDQUEQUE_SIZE / 2;
+}
+
+static bool IsAnyWritableDueLocked(void)
+{
+    ListNode *item = NULL;
+    LIST_FOR_EACH(item, &g_dataQueue.writableList) {
+        if (IsWritableDueLocked(LIST_ENTRY(item, BrSendQueue, writableNode))) {
+            return true;
+        }
+    }
+    return false;
+}
+
+static void AddItemCountLocked(BrSendQueue *sendQueue, int32_t delta)
+{
+    sendQueue->itemCount += delta;
+    g_dataQueue.itemCount += delta;
+}
+
+static int32_t CheckSendQueueLengthLocked(BrSendQueue *sendQueue)
+{
+    if (sendQueue->itemCount > g_brSendQueueMaxLen || g_dataQueue.itemCount >= MAX_BR_SENDQUEQUE_SIZE) {
+        ArmWritableLocked(sendQueue);
         return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
     }
     return SOFTBUS_OK;
 }
 
-static DataPidQueueStruct *CreatNewPidNode(int pid)
+static void InitSendQueue(BrSendQueue *sendQueue)
 {
-    DataPidQueueStruct *pidQueue = SoftBusCalloc(sizeof(DataPidQueueStruct));
-    if (pidQueue == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "PostBytes CreatNewPidNode fail");
-        return NULL;
+    ListInit(&sendQueue->node);
+    for (int32_t i = 0; i < BR_SEND_CLASS_NUM; i++) {
+        ListInit(&sendQueue->queue[i]);
+        sendQueue->quota[i] = g_sendClassWeight[i];
+    }
+    sendQueue->isReady = false;
+    sendQueue->itemCount = 0;
+    ListInit(&sendQueue->writableNode);
+    sendQueue->isWritableArmed = false;
+}
+
+static void FreeSendItem(SendItemStruct *sendItem)
+{
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "FreeSendItem");
+    if (sendItem == NULL) {
+        return;
+    }
+    if (sendItem->data != NULL) {
+        SoftBusFree(sendItem->data);
+    }
+    SoftBusFree(sendItem);
+}
+
+static void MarkSendQueueReadyLocked(BrSendQueue *sendQueue)
+{
+    if (!sendQueue->isReady) {
+        ListTailInsert(&g_dataQueue.readyList, &sendQueue->node);
+        sendQueue->isReady = true;
+    }
+}
+
+static void ClearSendQueue(BrSendQueue *sendQueue)
+{
+    if (pthread_mutex_lock(&g_dataQueue.lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ClearSendQueue mutex failed");
+        return;
+    }
+    if (sendQueue->isReady) {
+        ListDelete(&sendQueue->node);
+        sendQueue->isReady = false;
+    }
+    DisarmWritableLocked(sendQueue);
+    ListNode *item = NULL;
+    ListNode *nextItem = NULL;
+    for (int32_t i = 0; i < BR_SEND_CLASS_NUM; i++) {
+        LIST_FOR_EACH_SAFE(item, nextItem, &sendQueue->queue[i]) {
+            SendItemStruct *sendItem = LIST_ENTRY(item, SendItemStruct, node);
+            ListDelete(item);
+            FreeSendItem(sendItem);
+            AddItemCountLocked(sendQueue, -1);
+        }
     }
-    ListInit(&pidQueue->node);
-    pidQueue->pid = pid;
-    ListTailInsert(&g_dataQueue.pidList, &pidQueue->node);
-    return pidQueue;
+    (void)pthread_mutex_unlock(&g_dataQueue.lock);
 }
 
-static int32_t CreateNewSendItem(int pid, int flag, int connectionId, int len, const char *data)
+static int32_t CreateNewSendItem(BrSendQueue *sendQueue, int pid, int flag, int connectionId, int len,
+    const char *data)
 {
     SendItemStruct *sendItem = SoftBusCalloc(sizeof(SendItemStruct));
     if (sendItem == NULL) {
@@ -1163,26 +1330,11 @@ static int32_t CreateNewSendItem(int pid, int flag, int connectionId, int len, c
     sendItem->priority = GetPriority(flag);
     sendItem->connectionId = connectionId;
     sendItem->dataLen = len;
+    sendItem->sendPos = 0;
     sendItem->data = (char*)data;
-
-    ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    SendItemStruct *sendItemInsert = NULL;
-    int lastInsertFlag = false;
-    LIST_FOR_EACH_SAFE(item, nextItem, &g_dataQueue.sendList) {
-        sendItemInsert = LIST_ENTRY(item, SendItemStruct, node);
-        if (sendItemInsert->pid == pid && sendItemInsert->priority < sendItem->priority) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "SendItem ListAdd");
-            ListNode *sendItemNode = item->prev;
-            ListAdd(sendItemNode, &sendItem->node);
-            lastInsertFlag = true;
-            break;
-        }
-    }
-    if (lastInsertFlag != true) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "SendItem ListTailInsert");
-        ListTailInsert(&g_dataQueue.sendList, &sendItem->node);
-    }
+    ListTailInsert(&sendQueue->queue[sendItem->priority], &sendItem->node);
+    AddItemCountLocked(sendQueue, 1);
+    MarkSendQueueReadyLocked(sendQueue);
     return SOFTBUS_OK;
 }
 
@@ -1190,226 +1342,321 @@ static int32_t PostBytes(uint32_t connectionId, const char *data, int32_t len, i
 {
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
         "PostBytes connectionId=%u,pid=%d,len=%d flag=%d", connectionId, pid, len, flag);
-    (void)pthread_mutex_lock(&g_connectionLock);
-    if (CheckSendQueueLength() != SOFTBUS_OK) {
+    (void)pthread_mutex_lock(&g_dataQueue.lock);
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
         SoftBusFree((void*)data);
-        (void)pthread_mutex_unlock(&g_connectionLock);
-        return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        return SOFTBUS_BRCONNECTION_POSTBYTES_ERROR;
     }
-    BrConnectionInfo *conn = GetConnectionRef(connectionId);
+    BrConnectionInfo *conn = (BrConnectionInfo *)ConnIdTableFind(&g_brConnTable, connectionId);
     if (conn == NULL) {
+        ConnIdTableUnlock(&g_brConnTable);
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "PostBytes connectionId=%u not found", connectionId);
         SoftBusFree((void*)data);
-        (void)pthread_mutex_unlock(&g_connectionLock);
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
         return SOFTBUS_BRCONNECTION_POSTBYTES_ERROR;
     }
-
-    (void)pthread_mutex_lock(&g_dataQueue.lock);
-    DataPidQueueStruct *pidQueue = NULL;
-    ListNode *item = NULL;
-    LIST_FOR_EACH(item, &g_dataQueue.pidList) {
-        DataPidQueueStruct *itemNode = LIST_ENTRY(item, DataPidQueueStruct, node);
-        if (itemNode->pid == pid) {
-            pidQueue = itemNode;
-            break;
-        }
-    }
-    if (pidQueue == NULL) {
-        pidQueue = CreatNewPidNode(pid);
-        if (pidQueue == NULL) {
-            (void)pthread_mutex_unlock(&g_connectionLock);
-            SoftBusFree((void*)data);
-            (void)pthread_mutex_unlock(&g_dataQueue.lock);
-            return SOFTBUS_BRCONNECTION_POSTBYTES_ERROR;
-        }
+    if (CheckSendQueueLengthLocked(&conn->sendQueue) != SOFTBUS_OK) {
+        ConnIdTableUnlock(&g_brConnTable);
+        SoftBusFree((void*)data);
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
     }
-
-    pidQueue->itemCount++;
-    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "PostBytes pidQueue count=%d", pidQueue->itemCount);
-    if (CreateNewSendItem(pid, flag, connectionId, len, data) != SOFTBUS_OK) {
-        (void)pthread_mutex_unlock(&g_connectionLock);
+    int32_t ret = CreateNewSendItem(&conn->sendQueue, pid, flag, connectionId, len, data);
+    ConnIdTableUnlock(&g_brConnTable);
+    if (ret != SOFTBUS_OK) {
         SoftBusFree((void*)data);
-        SoftBusFree(pidQueue);
         (void)pthread_mutex_unlock(&g_dataQueue.lock);
         return SOFTBUS_BRCONNECTION_POSTBYTES_ERROR;
     }
-
-    (void)pthread_mutex_unlock(&g_connectionLock);
     pthread_cond_broadcast(&g_dataQueue.cond);
     (void)pthread_mutex_unlock(&g_dataQueue.lock);
     return SOFTBUS_OK;
 }
 
+/* counts whole packets: each free slot of the connection's queue takes at most one full sized frame */
+static int32_t GetSendWindow(uint32_t connectionId, uint32_t *window)
+{
+    if (window == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    (void)pthread_mutex_lock(&g_dataQueue.lock);
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        return SOFTBUS_LOCK_ERR;
+    }
+    BrConnectionInfo *conn = (BrConnectionInfo *)ConnIdTableFind(&g_brConnTable, connectionId);
+    if (conn == NULL) {
+        ConnIdTableUnlock(&g_brConnTable);
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        return SOFTBUS_BRCONNECTION_GETCONNINFO_ERROR;
+    }
+    int32_t freeSlots = g_brSendQueueMaxLen + 1 - conn->sendQueue.itemCount;
+    int32_t sharedSlots = MAX_BR_SENDQUEQUE_SIZE - g_dataQueue.itemCount;
+    freeSlots = (sharedSlots < freeSlots) ? sharedSlots : freeSlots;
+    *window = (freeSlots > 0) ? (uint32_t)freeSlots * (uint32_t)(g_brBuffSize - sizeof(ConnPktHead)) : 0;
+    /* with nothing queued the send loop would never run to deliver the callback */
+    if (*window < CONN_SEND_WINDOW_LOW && g_dataQueue.itemCount > 0) {
+        ArmWritableLocked(&conn->sendQueue);
+    }
+    ConnIdTableUnlock(&g_brConnTable);
+    (void)pthread_mutex_unlock(&g_dataQueue.lock);
+    return SOFTBUS_OK;
+}
 
-static void FreeSendItem(SendItemStruct *sendItem)
+/* every write of the send loop is capped at g_brSendPeerLen, the receive ring takes g_brBuffSize per packet */
+static int32_t GetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit)
 {
-    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "FreeSendItem");
-    if (sendItem == NULL) {
-        return;
+    if (limit == NULL) {
+        return SOFTBUS_INVALID_PARAM;
     }
-    if (sendItem->data != NULL) {
-        SoftBusFree(sendItem->data);
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
+        return SOFTBUS_LOCK_ERR;
     }
-    SoftBusFree(sendItem);
+    bool exist = (ConnIdTableFind(&g_brConnTable, connectionId) != NULL);
+    ConnIdTableUnlock(&g_brConnTable);
+    if (!exist) {
+        return SOFTBUS_BRCONNECTION_GETCONNINFO_ERROR;
+    }
+    limit->sendUnit = (uint32_t)g_brSendPeerLen;
+    limit->recvMax = (uint32_t)g_brBuffSize;
+    return SOFTBUS_OK;
+}
+
+#define BR_WRITABLE_NOTIFY_BATCH 8
+
+/* pops the armed connections in batches so OnWritable runs without g_dataQueue.lock */
+static void NotifyWritable(void)
+{
+    uint32_t connIds[BR_WRITABLE_NOTIFY_BATCH];
+    while (1) {
+        int32_t num = 0;
+        ListNode *item = NULL;
+        ListNode *nextItem = NULL;
+        (void)pthread_mutex_lock(&g_dataQueue.lock);
+        LIST_FOR_EACH_SAFE(item, nextItem, &g_dataQueue.writableList) {
+            BrSendQueue *sendQueue = LIST_ENTRY(item, BrSendQueue, writableNode);
+            if (num == BR_WRITABLE_NOTIFY_BATCH) {
+                break;
+            }
+            if (!IsWritableDueLocked(sendQueue)) {
+                continue;
+            }
+            DisarmWritableLocked(sendQueue);
+            connIds[num++] = LIST_ENTRY(sendQueue, BrConnectionInfo, sendQueue)->connectionId;
+        }
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        if (num == 0) {
+            return;
+        }
+        for (int32_t i = 0; i < num; i++) {
+            if (g_connectCallback->OnWritable != NULL) {
+                g_connectCallback->OnWritable(connIds[i]);
+            }
+        }
+    }
+}
+
+/* weighted round robin over the priority classes of one connection */
+static SendItemStruct *DequeueSendItemLocked(BrSendQueue *sendQueue)
+{
+    for (int32_t round = 0; round < 2; round++) {
+        for (int32_t i = 0; i < BR_SEND_CLASS_NUM; i++) {
+            if (sendQueue->quota[i] <= 0 || IsListEmpty(&sendQueue->queue[i])) {
+                continue;
+            }
+            sendQueue->quota[i]--;
+            SendItemStruct *sendItem = LIST_ENTRY(sendQueue->queue[i].next, SendItemStruct, node);
+            ListDelete(&sendItem->node);
+            return sendItem;
+        }
+        for (int32_t i = 0; i < BR_SEND_CLASS_NUM; i++) {
+            sendQueue->quota[i] = g_sendClassWeight[i];
+        }
+    }
+    return NULL;
 }
 
+static bool IsSendQueueEmpty(const BrSendQueue *sendQueue)
+{
+    for (int32_t i = 0; i < BR_SEND_CLASS_NUM; i++) {
+        if (!IsListEmpty(&sendQueue->queue[i])) {
+            return false;
+        }
+    }
+    return true;
+}
 
-static void ClearDataPidByPid(int32_t pid)
+/* takes one item from the first uncongested connection and rotates it behind the others */
+static SendItemStruct *PickSendItemLocked(void)
 {
     ListNode *item = NULL;
-    ListNode *nextItem = NULL;
-    LIST_FOR_EACH_SAFE(item, nextItem, &g_dataQueue.pidList) {
-        DataPidQueueStruct *itemNode = LIST_ENTRY(item, DataPidQueueStruct, node);
-        if (itemNode->pid == pid) {
-            ListDelete(item);
-            SoftBusFree(itemNode);
+    LIST_FOR_EACH(item, &g_dataQueue.readyList) {
+        BrSendQueue *sendQueue = LIST_ENTRY(item, BrSendQueue, node);
+        BrConnectionInfo *conn = LIST_ENTRY(sendQueue, BrConnectionInfo, sendQueue);
+        if (conn->conGestState == BT_RFCOM_CONGEST_ON) {
+            continue;
+        }
+        SendItemStruct *sendItem = DequeueSendItemLocked(sendQueue);
+        ListDelete(&sendQueue->node);
+        sendQueue->isReady = false;
+        if (!IsSendQueueEmpty(sendQueue)) {
+            MarkSendQueueReadyLocked(sendQueue);
         }
+        if (sendItem != NULL) {
+            AddItemCountLocked(sendQueue, -1);
+            return sendItem;
+        }
+        return NULL;
     }
+    return NULL;
 }
 
-static void ClearSendItemByConnId(uint32_t connectionId)
+/* an item stopped by congestion goes back to the head of its class to keep the stream in order */
+static void RequeueSendItem(SendItemStruct *sendItem)
 {
-    if (pthread_mutex_lock(&g_dataQueue.lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ClearSendItemByConnId mutex failed");
+    (void)pthread_mutex_lock(&g_dataQueue.lock);
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        FreeSendItem(sendItem);
         return;
     }
-    ListNode *sendItemNode = NULL;
-    ListNode *nextItem = NULL;
-    SendItemStruct *sendItem = NULL;
-    LIST_FOR_EACH_SAFE(sendItemNode, nextItem, &g_dataQueue.sendList) {
-        sendItem = LIST_ENTRY(sendItemNode, SendItemStruct, node);
-        if (sendItem->connectionId == connectionId) {
-            ClearDataPidByPid(sendItem->pid);
-            ListDelete(sendItemNode);
-            FreeSendItem(sendItem);
-        }
+    BrConnectionInfo *conn = (BrConnectionInfo *)ConnIdTableFind(&g_brConnTable, sendItem->connectionId);
+    if (conn == NULL) {
+        ConnIdTableUnlock(&g_brConnTable);
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        FreeSendItem(sendItem);
+        return;
     }
+    ListAdd(&conn->sendQueue.queue[sendItem->priority], &sendItem->node);
+    AddItemCountLocked(&conn->sendQueue, 1);
+    MarkSendQueueReadyLocked(&conn->sendQueue);
+    ConnIdTableUnlock(&g_brConnTable);
     (void)pthread_mutex_unlock(&g_dataQueue.lock);
 }
 
 static int32_t SendData(SendItemStruct *sendItem)
 {
-    BrConnectionInfo *brConnInfo = NULL;
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "SendData");
-    (void)pthread_mutex_lock(&g_connectionLock);
-    ListNode *item = NULL;
-    int32_t socketFd = -1;
-    LIST_FOR_EACH(item, &g_conection_list) {
-        brConnInfo = LIST_ENTRY(item, BrConnectionInfo, node);
-        if (brConnInfo->connectionId == sendItem->connectionId) {
-            socketFd = brConnInfo->socketFd;
-        }
+    /* the read lock keeps brConnInfo alive without blocking lookups from PostBytes */
+    if (ConnIdTableReadLock(&g_brConnTable) != SOFTBUS_OK) {
+        return SOFTBUS_ERR;
     }
-
-    if (socketFd == -1) {
-        (void)pthread_mutex_unlock(&g_connectionLock);
+    BrConnectionInfo *brConnInfo = (BrConnectionInfo *)ConnIdTableFind(&g_brConnTable, sendItem->connectionId);
+    if (brConnInfo == NULL) {
+        ConnIdTableUnlock(&g_brConnTable);
         return SOFTBUS_ERR;
     }
-    int32_t writeRet = -1;
-    int freeLock = false;
-
-    int32_t templen = sendItem->dataLen;
-    char *sendData = sendItem->data;
-    while (templen > 0) {
-        (void)pthread_mutex_lock(&brConnInfo->lock);
-        while (brConnInfo->conGestState == BT_RFCOM_CONGEST_ON &&
-            brConnInfo->state == BR_CONNECTION_STATE_CONNECTED) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "wait congest");
-            (void)pthread_mutex_unlock(&g_connectionLock);
-            freeLock = true;
-            pthread_cond_wait(&brConnInfo->congestCond, &brConnInfo->lock);
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "free congest");
+    int32_t socketFd = brConnInfo->socketFd;
+    int32_t ret = SOFTBUS_OK;
+    while (sendItem->sendPos < (int32_t)sendItem->dataLen) {
+        if (brConnInfo->conGestState == BT_RFCOM_CONGEST_ON) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "congest, connectionId=%u", sendItem->connectionId);
+            ret = BR_SEND_CONGESTED;
             break;
         }
-        (void)pthread_mutex_unlock(&brConnInfo->lock);
-
-        int32_t sendlenth = templen;
+        int32_t sendlenth = (int32_t)sendItem->dataLen - sendItem->sendPos;
         if (sendlenth > g_brSendPeerLen) {
             sendlenth = g_brSendPeerLen;
         }
-        writeRet = g_sppDriver->Write(socketFd, sendItem->data, sendlenth);
-        sendItem->data += sendlenth;
-        templen -= sendlenth;
-    }
-    sendItem->data = sendData;
-    if (freeLock != true) {
-        (void)pthread_mutex_unlock(&g_connectionLock);
+        ret = g_sppDriver->Write(socketFd, sendItem->data + sendItem->sendPos, sendlenth);
+        if (ret != SOFTBUS_OK) {
+            break;
+        }
+        sendItem->sendPos += sendlenth;
     }
-    return writeRet;
+    ConnIdTableUnlock(&g_brConnTable);
+    return ret;
 }
 
 void *SendHandlerLoop(void *arg)
 {
     while (1) {
         (void)pthread_mutex_lock(&g_dataQueue.lock);
-        if (IsListEmpty(&g_dataQueue.sendList)) {
+        SendItemStruct *sendItem = PickSendItemLocked();
+        if (sendItem == NULL) {
+            /* nothing queued or every link with data is congested */
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "SendHandlerLoop empty");
             pthread_cond_wait(&g_dataQueue.cond, &g_dataQueue.lock);
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "start SendHandlerLoop");
             (void)pthread_mutex_unlock(&g_dataQueue.lock);
             continue;
         }
-        ListNode *item = NULL;
-        LIST_FOR_EACH(item, &g_dataQueue.pidList) {
-            DataPidQueueStruct *itemNode = LIST_ENTRY(item, DataPidQueueStruct, node);
-            ListDelete(item);
-            itemNode->itemCount--;
-            sendPid = itemNode->pid;
-            if (itemNode->itemCount == 0) {
-                SoftBusFree(itemNode);
-            } else {
-                ListTailInsert(&g_dataQueue.pidList, &itemNode->node);
-            }
-            break;
-        }
-
-        ListNode *sendItemNode = NULL;
-        SendItemStruct *sendItem = NULL;
-        LIST_FOR_EACH(sendItemNode, &g_dataQueue.sendList) {
-            sendItem = LIST_ENTRY(sendItemNode, SendItemStruct, node);
-            if (sendItem->pid == sendPid) {
-                ListDelete(sendItemNode);
-                break;
-            }
+        bool writableDue = IsAnyWritableDueLocked();
+        (void)pthread_mutex_unlock(&g_dataQueue.lock);
+        if (writableDue) {
+            NotifyWritable();
         }
-        if (sendItem == NULL) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "SendItem fail");
+        int32_t ret = SendData(sendItem);
+        if (ret == BR_SEND_CONGESTED) {
+            RequeueSendItem(sendItem);
             continue;
         }
-        (void)pthread_mutex_unlock(&g_dataQueue.lock);
-        if (SendData(sendItem) != SOFTBUS_OK) {
+        if (ret != SOFTBUS_OK) {
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "SendItem fail");
         }
         FreeSendItem(sendItem);
     }
 }
 
-static void RecvConnectedComd(uint32_t connectionId, const cJSON *data)
+static int32_t UnpackRefMessage(const char *data, int32_t len, BrRefMessage *msg)
 {
-    int32_t keyMethod = 0;
-    int32_t keyDelta = 0;
-    int32_t keyRefernceNum = 0;
-    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "RecvConnectedComd ID=%u", connectionId);
+    (void)memset_s(msg, sizeof(BrRefMessage), 0, sizeof(BrRefMessage));
+    if (len >= BR_REF_MSG_LEN && (uint8_t)data[0] == BR_REF_MSG_TAG) {
+        const uint8_t *body = (const uint8_t *)data;
+        msg->method = body[1];
+        msg->delta = GetInt32Be(body + 4);
+        msg->refNum = GetInt32Be(body + 8);
+        return SOFTBUS_OK;
+    }
+    /* peers still on the JSON encoding send a NUL terminated object */
+    if (len <= 0 || data[len - 1] != '\0') {
+        return SOFTBUS_ERR;
+    }
+    cJSON *json = cJSON_Parse(data);
+    if (json == NULL) {
+        return SOFTBUS_ERR;
+    }
+    int32_t ret = SOFTBUS_OK;
+    if (!GetJsonObjectNumberItem(json, KEY_METHOD, &msg->method)) {
+        ret = SOFTBUS_ERR;
+    } else if (msg->method == METHOD_NOTIFY_CAPABILITY) {
+        if (!GetJsonObjectNumberItem(json, KEY_CAPABILITY, &msg->capability)) {
+            ret = SOFTBUS_ERR;
+        }
+    } else if (!GetJsonObjectNumberItem(json, KEY_REFERENCE_NUM, &msg->refNum) ||
+        (msg->method == METHOD_NOTIFY_REQUEST && !GetJsonObjectNumberItem(json, KEY_DELTA, &msg->delta))) {
+        ret = SOFTBUS_ERR;
+    }
+    cJSON_Delete(json);
+    return ret;
+}
 
-    if (!GetJsonObjectNumberItem(data, KEY_METHOD, &keyMethod)) {
+static void RecvConnectedComd(uint32_t connectionId, const char *data, int32_t len)
+{
+    BrRefMessage msg;
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "RecvConnectedComd ID=%u", connectionId);
+    if (UnpackRefMessage(data, len, &msg) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[receive data invalid]");
         return;
     }
-    if (keyMethod == METHOD_NOTIFY_REQUEST) {
-        if (!GetJsonObjectNumberItem(data, KEY_METHOD, &keyMethod) ||
-            !GetJsonObjectNumberItem(data, KEY_DELTA, &keyDelta) ||
-            !GetJsonObjectNumberItem(data, KEY_REFERENCE_NUM, &keyRefernceNum)) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "REQUEST fail");
-            return;
+    if (msg.method == METHOD_NOTIFY_CAPABILITY) {
+        (void)pthread_mutex_lock(&g_connectionLock);
+        ListNode *item = NULL;
+        LIST_FOR_EACH(item, &g_conection_list) {
+            BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
+            if (itemNode->connectionId == connectionId) {
+                itemNode->peerCapability = msg.capability;
+                break;
+            }
         }
-        OnPackResponse(keyDelta, keyRefernceNum, connectionId);
+        (void)pthread_mutex_unlock(&g_connectionLock);
+    }
+    if (msg.method == METHOD_NOTIFY_REQUEST) {
+        OnPackResponse(msg.delta, msg.refNum, connectionId);
     }
-    if (keyMethod == METHOD_NOTIFY_RESPONSE) {
+    if (msg.method == METHOD_NOTIFY_RESPONSE) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "NOTIFY_RESPONSE");
-        if (!GetJsonObjectNumberItem(data, KEY_METHOD, &keyMethod) ||
-            !GetJsonObjectNumberItem(data, KEY_REFERENCE_NUM, &keyRefernceNum)) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "RESPONSE fail");
-            return;
-        }
         (void)pthread_mutex_lock(&g_connectionLock);
         ListNode *item = NULL;
         LIST_FOR_EACH(item, &g_conection_list) {
@@ -1426,67 +1673,60 @@ static void RecvConnectedComd(uint32_t connectionId, const cJSON *data)
     }
 }
 
+/* frames in buf were validated by RecvRingWriteLocked and start BR_RECV_FRAME_ALIGN apart */
+static void DispatchRecvFrames(uint32_t connectionId, char *buf, int32_t len)
+{
+    int32_t headSize = sizeof(ConnPktHead);
+    int32_t pos = 0;
+    while (pos < len) {
+        ConnPktHead *head = (ConnPktHead *)(buf + pos);
+        int32_t frameLen = headSize + head->len;
+        if (head->module == MODULE_CONNECTION) {
+            RecvConnectedComd(connectionId, buf + pos + headSize, head->len);
+        } else if (g_connectCallback != NULL) {
+            g_connectCallback->OnDataReceived(connectionId, (ConnModule)head->module, head->seq,
+                buf + pos, frameLen);
+        }
+        pos = BR_RECV_ALIGN(pos + frameLen);
+    }
+}
+
 void *RecvHandlerLoop(void *arg)
 {
+    (void)arg;
     while (1) {
         (void)pthread_mutex_lock(&g_recvQueue.lock);
-        if (IsListEmpty(&g_recvQueue.recvList)) {
+        while (IsListEmpty(&g_recvQueue.readyList)) {
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "RecvHandlerLoop empty");
             pthread_cond_wait(&g_recvQueue.cond, &g_recvQueue.lock);
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "Recv recvQueueCond");
-            (void)pthread_mutex_unlock(&g_recvQueue.lock);
-            continue;
-        }
-
-        ListNode *recvItemNode = NULL;
-        ReceiveItemStruct *recvItem = NULL;
-        LIST_FOR_EACH(recvItemNode, &g_recvQueue.recvList) {
-            recvItem = LIST_ENTRY(recvItemNode, ReceiveItemStruct, node);
-            ListDelete(recvItemNode);
-            break;
         }
+        BrRecvRing *ring = LIST_ENTRY(g_recvQueue.readyList.next, BrRecvRing, node);
+        ListDelete(&ring->node);
+        ring->isReady = false;
+        ring->busy = true;
+        ring->holders++;
+        int32_t start = ring->r;
+        int32_t end = ring->parsed;
         (void)pthread_mutex_unlock(&g_recvQueue.lock);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "RecvHandlerLoop OnDataReceived");
-        if (recvItem->module == MODULE_CONNECTION) {
-            cJSON *data = NULL;
-            data = cJSON_Parse((char *)(recvItem->data + sizeof(ConnPktHead)));
-            if (data == NULL) {
-                SoftBusFree(recvItem->data);
-                SoftBusFree(recvItem);
-                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "[receive data invalid]");
-                continue;
-            }
-            RecvConnectedComd(recvItem->connectionId, (const cJSON*)data);
-            cJSON_Delete(data);
-        } else {
-            if (g_connectCallback != NULL) {
-            g_connectCallback->OnDataReceived(recvItem->connectionId, (ConnModule)recvItem->module, recvItem->seqNum,
-                (char*)recvItem->data, recvItem->dataLen);
-            }
-        }
-        SoftBusFree(recvItem->data);
-        SoftBusFree(recvItem);
-    }
-}
 
-static void ClearReceiveQueueByConnId(uint32_t connectionId)
-{
-    if (pthread_mutex_lock(&g_recvQueue.lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ClearReceiveQueueByConnId mutex failed");
-        return;
-    }
-    ListNode *recvItemNode = NULL;
-    ListNode *nextItem = NULL;
-    ReceiveItemStruct *recvItem = NULL;
-    LIST_FOR_EACH_SAFE(recvItemNode, nextItem, &g_recvQueue.recvList) {
-        recvItem = LIST_ENTRY(recvItemNode, ReceiveItemStruct, node);
-        if (recvItem->connectionId == connectionId) {
-            ListDelete(recvItemNode);
-            SoftBusFree(recvItem->data);
-            SoftBusFree(recvItem);
+        /* every frame completed so far goes up in one batch, straight out of the ring */
+        DispatchRecvFrames(ring->connectionId, ring->buf + start, end - start);
+
+        (void)pthread_mutex_lock(&g_recvQueue.lock);
+        ring->r = end;
+        if (ring->r == ring->w) {
+            ring->r = 0;
+            ring->parsed = 0;
+            ring->w = 0;
+        }
+        ring->busy = false;
+        if (ring->parsed > ring->r) {
+            MarkRecvRingReadyLocked(ring);
         }
+        pthread_cond_broadcast(&g_recvQueue.spaceCond);
+        PutRecvRingLocked(ring);
+        (void)pthread_mutex_unlock(&g_recvQueue.lock);
     }
-    (void)pthread_mutex_unlock(&g_recvQueue.lock);
 }
 
 static int32_t DisconnectDevice(uint32_t connectionId)
@@ -1533,7 +1773,7 @@ static int32_t DisconnectDeviceNow(const ConnectOption *option)
     LIST_FOR_EACH_SAFE(item, nextItem, &g_conection_list) {
         BrConnectionInfo *itemNode = LIST_ENTRY(item, BrConnectionInfo, node);
         if (memcmp(itemNode->mac, option->info.brOption.brMac, sizeof(itemNode->mac)) == 0) {
-            if (!IsListEmpty(&g_dataQueue.sendList)) {
+            if (itemNode->sendQueue.itemCount > 0) {
                 osDelay(DISCONN_DELAY_TIME);
             }
             ret = g_sppDriver->CloseClient(itemNode->socketFd);
@@ -1545,8 +1785,9 @@ static int32_t DisconnectDeviceNow(const ConnectOption *option)
 
 static void InitDataQueue(DataQueueStruct *dataQueue)
 {
-    ListInit(&dataQueue->sendList);
-    ListInit(&dataQueue->pidList);
+    ListInit(&dataQueue->readyList);
+    ListInit(&dataQueue->writableList);
+    dataQueue->itemCount = 0;
     pthread_mutex_init(&dataQueue->lock, NULL);
     pthread_cond_init(&dataQueue->cond, NULL);
 
@@ -1561,9 +1802,10 @@ static void InitDataQueue(DataQueueStruct *dataQueue)
 
 static void InitRecvQueue(RecvQueueStruct *recvQueue)
 {
-    ListInit(&recvQueue->recvList);
+    ListInit(&recvQueue->readyList);
     pthread_mutex_init(&recvQueue->lock, NULL);
     pthread_cond_init(&recvQueue->cond, NULL);
+    pthread_cond_init(&recvQueue->spaceCond, NULL);
 
     pthread_t tid;
     pthread_attr_t threadAttr;
@@ -1634,6 +1876,10 @@ ConnectFuncInterface *ConnInitBr(const ConnectCallback *callback)
         return NULL;
     }
     pthread_mutex_init(&g_connectionLock, NULL);
+    if (ConnIdTableInit(&g_brConnTable) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "init conn table failed");
+        return NULL;
+    }
     InitDataQueue(&g_dataQueue);
     InitRecvQueue(&g_recvQueue);
     g_connectCallback = (ConnectCallback*)callback;
@@ -0,0 +1,68 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#ifndef SOFTBUS_CONN_ID_TABLE_H
+#define SOFTBUS_CONN_ID_TABLE_H
+
+#include <pthread.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+#if __cplusplus
+extern "C" {
+#endif
+#endif
+
+typedef struct {
+    uint32_t connectionId;
+    void *value; /* NULL marks a free slot */
+} ConnIdTableEntry;
+
+/*
+ * Open-addressing hash from connectionId to the connection object of a connect manager.
+ * Lookups share the lock, only adding and removing a connection takes it exclusively.
+ */
+typedef struct {
+#ifdef __LITEOS_M__
+    pthread_mutex_t lock;
+#else
+    pthread_rwlock_t lock;
+#endif
+    ConnIdTableEntry *entries;
+    uint32_t size; /* 1 << bits */
+    uint32_t bits;
+    uint32_t count;
+} ConnIdTable;
+
+int32_t ConnIdTableInit(ConnIdTable *table);
+void ConnIdTableDeinit(ConnIdTable *table);
+
+/* value must not be NULL, returns SOFTBUS_ALREADY_EXISTED when connectionId is taken */
+int32_t ConnIdTableAdd(ConnIdTable *table, uint32_t connectionId, void *value);
+/* returns the removed value, NULL when connectionId is unknown */
+void *ConnIdTableRemove(ConnIdTable *table, uint32_t connectionId);
+
+/* a value found under the read lock stays valid until ConnIdTableUnlock */
+int32_t ConnIdTableReadLock(ConnIdTable *table);
+void ConnIdTableUnlock(ConnIdTable *table);
+void *ConnIdTableFind(const ConnIdTable *table, uint32_t connectionId);
+
+#ifdef __cplusplus
+#if __cplusplus
+}
+#endif /* __cplusplus */
+#endif /* __cplusplus */
+
+#endif /* SOFTBUS_CONN_ID_TABLE_H */
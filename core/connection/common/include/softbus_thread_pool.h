@@ -33,9 +33,8 @@ typedef enum {
 struct Job {
     int32_t (*callbackFunction)(void *arg);
     void *arg;
-    struct Job *next;
+    struct Job *next; /* link in the PERSISTENT job registry */
     JobMode jobMode;
-    pthread_mutex_t mutex;
     uintptr_t handle;
     bool runnable;
 };
@@ -43,16 +42,40 @@ struct Job {
 typedef struct Job Job;
 
 typedef struct {
+    uint32_t seq;
+    Job *job;
+} JobCell;
+
+/* Bounded lock-free MPMC ring, pushed by submitters and popped by its owner or by stealing workers. */
+typedef struct {
+    JobCell *cells;
+    uint32_t mask;
+    uint32_t enqueuePos;
+    uint32_t dequeuePos;
+} JobRing;
+
+struct ThreadPool;
+
+typedef struct {
+    struct ThreadPool *pool;
+    JobRing ring;
+    pthread_t thread;
+    int32_t index;
+    bool isStarted;
+} PoolWorker;
+
+typedef struct ThreadPool {
     int32_t threadNum;
     int32_t queueMaxNum;
-    Job *head;
-    Job *tail;
-    pthread_t *pthreads;
-    pthread_mutex_t mutex;
+    PoolWorker *workers;
+    Job *persistentJobs;
+    pthread_mutex_t mutex; /* guards persistentJobs and idle workers, never taken to dispatch a job */
     pthread_cond_t queueEmpty;
     pthread_cond_t queueNotEmpty;
-    pthread_cond_t queueNotFull;
     int32_t queueCurNum;
+    int32_t readyNum;
+    int32_t sleepNum;
+    uint32_t nextWorker;
     int32_t queueClose;
     int32_t poolClose;
 } ThreadPool;
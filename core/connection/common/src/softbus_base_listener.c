@@ -20,8 +20,11 @@
 #include <securec.h>
 #include <sys/socket.h>
 #include <unistd.h>
+#ifdef SOFTBUS_LISTENER_EPOLL
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#endif
 
-#include "common_list.h"
 #include "softbus_adapter_mem.h"
 #include "softbus_errcode.h"
 #include "softbus_feature_config.h"
@@ -30,17 +33,26 @@
 #include "softbus_thread_pool.h"
 #include "softbus_utils.h"
 
+#ifdef SOFTBUS_LISTENER_EPOLL
+#define MAX_LISTEN_EVENTS 8192
+#define EPOLL_EVENT_BATCH 64
+#define EPOLL_WAIT_TIMEOUT_MS 1000
+/* one reactor per module, so a callback blocking on a slow peer only stalls its own module */
+#define REACTOR_NUM       UNUSE_BUTT
+#else
 #define MAX_LISTEN_EVENTS 1024
+#define REACTOR_NUM       1
+#endif
 #define TIMEOUT           10000
 #define DEFAULT_BACKLOG   4
-#define FDARR_START_SIZE  16
-#define FDARR_EXPAND_BASE 2
+#define FD_TABLE_START_SIZE 64
+#define FD_TABLE_EXPAND_BASE 2
 
-#define CLIENT_THREADNUM  1
-#define CLIENT_QUEUE_NUM  10
+#define REACTOR_QUEUE_NUM 10
 
-#define SERVER_THREADNUM  1
-#define SERVER_QUEUE_NUM  10
+#define TRIGGER_MASK_READ   0x1
+#define TRIGGER_MASK_WRITE  0x2
+#define TRIGGER_MASK_EXCEPT 0x4
 
 typedef enum {
     LISTENER_IDLE,
@@ -49,13 +61,13 @@ typedef enum {
     LISTENER_ERROR,
 } ListenerStatus;
 
+/* Indexed by fd, so dispatch finds the owner of a ready fd without walking the module lists. */
 typedef struct {
-    ListNode node;
-    int32_t fd;
-} FdNode;
+    ListenerModule module;
+    uint32_t triggerSet;
+} FdEntry;
 
 typedef struct {
-    ListNode node;
     int32_t listenFd;
     char ip[IP_LEN];
     int32_t listenPort;
@@ -71,64 +83,231 @@ typedef struct {
     pthread_mutex_t lock;
 } SoftbusListenerNode;
 
+/* An event loop thread with its own trigger set, serving the modules mapped to it by ReactorOf. */
+typedef struct {
+#ifdef SOFTBUS_LISTENER_EPOLL
+    int32_t epollFd;
+    int32_t wakeupFd;
+#else
+    fd_set readSet;
+    fd_set writeSet;
+    fd_set exceptSet;
+    int32_t maxFd;
+#endif
+    bool isStarted;
+} Reactor;
+
 static SoftbusListenerNode g_listenerList[UNUSE_BUTT];
-static ThreadPool *g_clientPool = NULL;
-static ThreadPool *g_serverPool = NULL;
-static fd_set g_readSet;
-static fd_set g_writeSet;
-static fd_set g_exceptSet;
-static int32_t g_maxFd;
+static ThreadPool *g_reactorPool = NULL;
+static Reactor g_reactors[REACTOR_NUM];
 static pthread_mutex_t g_fdSetLock = PTHREAD_MUTEX_INITIALIZER;
 static bool g_fdSetInit = false;
+static FdEntry *g_fdTable = NULL;
+static int32_t g_fdTableSize = 0;
 
-static int32_t FdCopy(const fd_set *dest, const fd_set *src)
+static Reactor *ReactorOf(ListenerModule module)
 {
-    return memcpy_s((void *)dest, sizeof(fd_set), (void *)src, sizeof(fd_set));
+    return &g_reactors[(uint32_t)module % REACTOR_NUM];
 }
 
-static int32_t MaxFd(int32_t fd1, int32_t fd2)
+static uint32_t TriggerToMask(TriggerType triggerType)
 {
-    return (fd1 > fd2) ? fd1 : fd2;
+    switch (triggerType) {
+        case READ_TRIGGER:
+            return TRIGGER_MASK_READ;
+        case WRITE_TRIGGER:
+            return TRIGGER_MASK_WRITE;
+        case EXCEPT_TRIGGER:
+            return TRIGGER_MASK_EXCEPT;
+        case RW_TRIGGER:
+            return TRIGGER_MASK_READ | TRIGGER_MASK_WRITE;
+        default:
+            return 0;
+    }
 }
 
-static void UpdateMaxFd(void)
+#ifdef SOFTBUS_LISTENER_EPOLL
+static void DeinitReactor(Reactor *reactor)
 {
-    int32_t tmpMax = -1;
+    if (reactor->wakeupFd >= 0) {
+        close(reactor->wakeupFd);
+        reactor->wakeupFd = -1;
+    }
+    if (reactor->epollFd >= 0) {
+        close(reactor->epollFd);
+        reactor->epollFd = -1;
+    }
+}
 
-    for (int i = 0; i < UNUSE_BUTT; i++) {
-        if (g_listenerList[i].info == NULL || g_listenerList[i].info->status != LISTENER_RUNNING) {
-            continue;
-        }
+static int32_t InitReactor(Reactor *reactor)
+{
+    reactor->isStarted = false;
+    reactor->wakeupFd = -1;
+    reactor->epollFd = epoll_create1(EPOLL_CLOEXEC);
+    if (reactor->epollFd < 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_create1 failed, errno=%d", errno);
+        return SOFTBUS_ERR;
+    }
+    reactor->wakeupFd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (reactor->wakeupFd < 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "eventfd failed, errno=%d", errno);
+        DeinitReactor(reactor);
+        return SOFTBUS_ERR;
+    }
+    struct epoll_event event;
+    (void)memset_s(&event, sizeof(event), 0, sizeof(event));
+    event.events = EPOLLIN;
+    event.data.fd = reactor->wakeupFd;
+    if (epoll_ctl(reactor->epollFd, EPOLL_CTL_ADD, reactor->wakeupFd, &event) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "add wakeup fd failed, errno=%d", errno);
+        DeinitReactor(reactor);
+        return SOFTBUS_ERR;
+    }
+    return SOFTBUS_OK;
+}
 
-        if (pthread_mutex_lock(&g_listenerList[i].lock) != 0) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-            continue;
-        }
+static uint32_t ToEpollEvents(uint32_t triggerSet)
+{
+    uint32_t events = 0;
+    if ((triggerSet & TRIGGER_MASK_READ) != 0) {
+        events |= EPOLLIN;
+    }
+    if ((triggerSet & TRIGGER_MASK_WRITE) != 0) {
+        events |= EPOLLOUT;
+    }
+    if ((triggerSet & TRIGGER_MASK_EXCEPT) != 0) {
+        events |= EPOLLPRI;
+    }
+    return events;
+}
 
-        SoftbusBaseListenerInfo *listenerInfo = g_listenerList[i].info;
-        if (listenerInfo == NULL) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "listenerInfo is NULL");
-            pthread_mutex_unlock(&g_listenerList[i].lock);
-            continue;
+/*
+ * Called with g_fdSetLock held. Level-triggered so that callbacks which consume only part of the
+ * pending data keep the select semantics.
+ */
+static int32_t ApplyTriggerSet(Reactor *reactor, int32_t fd, uint32_t oldSet, uint32_t newSet)
+{
+    if (oldSet == newSet) {
+        return SOFTBUS_OK;
+    }
+    struct epoll_event event;
+    (void)memset_s(&event, sizeof(event), 0, sizeof(event));
+    event.events = ToEpollEvents(newSet);
+    event.data.fd = fd;
+    if (newSet == 0) {
+        /* the fd may have been closed already, which removed it from the epoll set */
+        if (epoll_ctl(reactor->epollFd, EPOLL_CTL_DEL, fd, &event) != 0) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "epoll del fd=%d, errno=%d", fd, errno);
         }
+        return SOFTBUS_OK;
+    }
+    int32_t op = (oldSet == 0) ? EPOLL_CTL_ADD : EPOLL_CTL_MOD;
+    int32_t ret = epoll_ctl(reactor->epollFd, op, fd, &event);
+    if (ret != 0 && op == EPOLL_CTL_MOD && errno == ENOENT) {
+        /* closed and reused without DelTrigger, register it again */
+        ret = epoll_ctl(reactor->epollFd, EPOLL_CTL_ADD, fd, &event);
+    }
+    if (ret != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_ctl op=%d fd=%d failed, errno=%d", op, fd, errno);
+        return SOFTBUS_TCP_SOCKET_ERR;
+    }
+    return SOFTBUS_OK;
+}
 
-        tmpMax = MaxFd(listenerInfo->listenFd, tmpMax);
-        FdNode *item = NULL;
-        FdNode *nextItem = NULL;
-        LIST_FOR_EACH_ENTRY_SAFE(item, nextItem, &listenerInfo->node, FdNode, node) {
-            tmpMax = MaxFd(item->fd, tmpMax);
-        }
-        pthread_mutex_unlock(&g_listenerList[i].lock);
+static void RefreshEventEngine(Reactor *reactor)
+{
+    if (reactor->wakeupFd < 0) {
+        return;
+    }
+    uint64_t value = 1;
+    if (write(reactor->wakeupFd, &value, sizeof(value)) != sizeof(value) && errno != EAGAIN) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "wakeup event loop failed, errno=%d", errno);
     }
+}
+#else
+static int32_t FdCopy(const fd_set *dest, const fd_set *src)
+{
+    return memcpy_s((void *)dest, sizeof(fd_set), (void *)src, sizeof(fd_set));
+}
 
+static int32_t MaxFd(int32_t fd1, int32_t fd2)
+{
+    return (fd1 > fd2) ? fd1 : fd2;
+}
+
+static void UpdateMaxFd(Reactor *reactor)
+{
     if (pthread_mutex_lock(&g_fdSetLock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return;
     }
-    g_maxFd = tmpMax;
+    int32_t tmpMax = g_fdTableSize - 1;
+    while (tmpMax >= 0 && (g_fdTable[tmpMax].module == UNUSE_BUTT || ReactorOf(g_fdTable[tmpMax].module) != reactor)) {
+        tmpMax--;
+    }
+    reactor->maxFd = tmpMax;
     pthread_mutex_unlock(&g_fdSetLock);
 }
 
+static void DeinitReactor(Reactor *reactor)
+{
+    (void)reactor;
+}
+
+static int32_t InitReactor(Reactor *reactor)
+{
+    reactor->isStarted = false;
+    reactor->maxFd = -1;
+    FD_ZERO(&reactor->readSet);
+    FD_ZERO(&reactor->writeSet);
+    FD_ZERO(&reactor->exceptSet);
+    return SOFTBUS_OK;
+}
+
+/* Called with g_fdSetLock held. */
+static int32_t ApplyTriggerSet(Reactor *reactor, int32_t fd, uint32_t oldSet, uint32_t newSet)
+{
+    (void)oldSet;
+    if ((newSet & TRIGGER_MASK_READ) != 0) {
+        FD_SET(fd, &reactor->readSet);
+    } else {
+        FD_CLR(fd, &reactor->readSet);
+    }
+    if ((newSet & TRIGGER_MASK_WRITE) != 0) {
+        FD_SET(fd, &reactor->writeSet);
+    } else {
+        FD_CLR(fd, &reactor->writeSet);
+    }
+    if ((newSet & TRIGGER_MASK_EXCEPT) != 0) {
+        FD_SET(fd, &reactor->exceptSet);
+    } else {
+        FD_CLR(fd, &reactor->exceptSet);
+    }
+    if (newSet != 0) {
+        reactor->maxFd = MaxFd(fd, reactor->maxFd);
+    }
+    return SOFTBUS_OK;
+}
+
+static void RefreshEventEngine(Reactor *reactor)
+{
+    UpdateMaxFd(reactor);
+}
+#endif
+
+static int32_t InitEventEngine(void)
+{
+    for (int32_t i = 0; i < REACTOR_NUM; i++) {
+        if (InitReactor(&g_reactors[i]) != SOFTBUS_OK) {
+            for (int32_t j = 0; j < i; j++) {
+                DeinitReactor(&g_reactors[j]);
+            }
+            return SOFTBUS_ERR;
+        }
+    }
+    return SOFTBUS_OK;
+}
+
 static int32_t CheckModule(ListenerModule module)
 {
     if (module >= UNUSE_BUTT || module < PROXY) {
@@ -147,22 +326,86 @@ static int32_t CheckTrigger(TriggerType triggerType)
     return SOFTBUS_OK;
 }
 
-static void ClearListenerFdList(const ListNode *cfdList)
+/* Called with g_fdSetLock held, makes g_fdTable[fd] addressable. */
+static int32_t ExpandFdTable(int32_t fd)
 {
-    FdNode *item = NULL;
+    if (fd < g_fdTableSize) {
+        return SOFTBUS_OK;
+    }
+#ifndef SOFTBUS_LISTENER_EPOLL
+    if (fd >= FD_SETSIZE) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "fd=%d exceeds FD_SETSIZE", fd);
+        return SOFTBUS_INVALID_PARAM;
+    }
+#endif
+    int32_t newSize = (g_fdTableSize > 0) ? g_fdTableSize : FD_TABLE_START_SIZE;
+    while (newSize <= fd) {
+        newSize *= FD_TABLE_EXPAND_BASE;
+    }
+    FdEntry *newTable = (FdEntry *)SoftBusCalloc(sizeof(FdEntry) * newSize);
+    if (newTable == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "SoftBusCalloc failed, out of memory");
+        return SOFTBUS_MALLOC_ERR;
+    }
+    for (int32_t i = 0; i < newSize; i++) {
+        if (i < g_fdTableSize) {
+            newTable[i] = g_fdTable[i];
+        } else {
+            newTable[i].module = UNUSE_BUTT;
+            newTable[i].triggerSet = 0;
+        }
+    }
+    SoftBusFree(g_fdTable);
+    g_fdTable = newTable;
+    g_fdTableSize = newSize;
+    return SOFTBUS_OK;
+}
+
+static int32_t RegisterListenFd(ListenerModule module, int32_t fd)
+{
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (ExpandFdTable(fd) != SOFTBUS_OK || ApplyTriggerSet(ReactorOf(module), fd, 0, TRIGGER_MASK_READ) != SOFTBUS_OK) {
+        pthread_mutex_unlock(&g_fdSetLock);
+        return SOFTBUS_ERR;
+    }
+    g_fdTable[fd].module = module;
+    g_fdTable[fd].triggerSet = TRIGGER_MASK_READ;
+    pthread_mutex_unlock(&g_fdSetLock);
+    return SOFTBUS_OK;
+}
+
+static void UnregisterListenFd(ListenerModule module, int32_t fd)
+{
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    if (fd < g_fdTableSize && g_fdTable[fd].module == module) {
+        (void)ApplyTriggerSet(ReactorOf(module), fd, g_fdTable[fd].triggerSet, 0);
+        g_fdTable[fd].module = UNUSE_BUTT;
+        g_fdTable[fd].triggerSet = 0;
+    }
+    pthread_mutex_unlock(&g_fdSetLock);
+}
 
+static void ClearListenerFdList(ListenerModule module, SoftbusBaseListenerInfo *listenerInfo)
+{
     if (pthread_mutex_lock(&g_fdSetLock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return;
     }
-    while (!IsListEmpty(cfdList)) {
-        item = LIST_ENTRY(cfdList->next, FdNode, node);
-        ListDelete(&item->node);
-        FD_CLR(item->fd, &g_readSet);
-        FD_CLR(item->fd, &g_writeSet);
-        FD_CLR(item->fd, &g_exceptSet);
-        SoftBusFree(item);
+    for (int32_t fd = 0; fd < g_fdTableSize; fd++) {
+        if (g_fdTable[fd].module != module || fd == listenerInfo->listenFd) {
+            continue;
+        }
+        (void)ApplyTriggerSet(ReactorOf(module), fd, g_fdTable[fd].triggerSet, 0);
+        g_fdTable[fd].module = UNUSE_BUTT;
+        g_fdTable[fd].triggerSet = 0;
     }
+    listenerInfo->fdCount = 0;
     pthread_mutex_unlock(&g_fdSetLock);
 }
 
@@ -200,15 +443,10 @@ static int32_t InitListenFd(ListenerModule module, const char *ip, int32_t port)
         return SOFTBUS_ERR;
     }
 
-    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+    if (RegisterListenFd(module, listenerInfo->listenFd) != SOFTBUS_OK) {
         ResetBaseListener(module);
         return SOFTBUS_ERR;
     }
-    FD_SET(listenerInfo->listenFd, &g_readSet);
-    g_maxFd = MaxFd(listenerInfo->listenFd, g_maxFd);
-    pthread_mutex_unlock(&g_fdSetLock);
-
     return SOFTBUS_OK;
 }
 
@@ -227,16 +465,16 @@ void ResetBaseListener(ListenerModule module)
         return;
     }
     if (listenerInfo->listenFd >= 0) {
+        UnregisterListenFd(module, listenerInfo->listenFd);
         TcpShutDown(listenerInfo->listenFd);
     }
     listenerInfo->listenFd = -1;
     listenerInfo->listenPort = -1;
     listenerInfo->status = LISTENER_IDLE;
     listenerInfo->modeType = UNSET_MODE;
-    listenerInfo->fdCount = 0;
-    ClearListenerFdList(&listenerInfo->node);
+    ClearListenerFdList(module, listenerInfo);
     pthread_mutex_unlock(&g_listenerList[module].lock);
-    UpdateMaxFd();
+    RefreshEventEngine(ReactorOf(module));
 }
 
 void ResetBaseListenerSet(ListenerModule module)
@@ -253,10 +491,9 @@ void ResetBaseListenerSet(ListenerModule module)
         pthread_mutex_unlock(&g_listenerList[module].lock);
         return;
     }
-    ClearListenerFdList(&listenerInfo->node);
-    listenerInfo->fdCount = 0;
+    ClearListenerFdList(module, listenerInfo);
     pthread_mutex_unlock(&g_listenerList[module].lock);
-    UpdateMaxFd();
+    RefreshEventEngine(ReactorOf(module));
 }
 
 static int32_t OnEvent(ListenerModule module, int32_t fd, uint32_t events)
@@ -299,103 +536,121 @@ static int32_t OnEvent(ListenerModule module, int32_t fd, uint32_t events)
     return SOFTBUS_OK;
 }
 
-static int CreateFdArr(const int32_t **fdArr, int32_t *fdArrLen, const ListNode *list)
+static void DispatchFdEvents(int32_t fd, uint32_t readySet, bool isError)
 {
-    if (list == NULL || list->next == list) {
-        *fdArrLen = 0;
-        return SOFTBUS_OK;
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
     }
-
-    int32_t fdArrSize = FDARR_START_SIZE;
-    int32_t *tmpFdArr = NULL;
-
-    tmpFdArr = (int32_t *)SoftBusCalloc(sizeof(int32_t) * fdArrSize);
-    if (tmpFdArr == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "SoftBusCalloc failed, out of memory");
-        return SOFTBUS_MALLOC_ERR;
+    if (fd >= g_fdTableSize || g_fdTable[fd].module == UNUSE_BUTT) {
+        pthread_mutex_unlock(&g_fdSetLock);
+        return;
     }
-    *fdArrLen = 0;
-
-    FdNode *item = NULL;
-    LIST_FOR_EACH_ENTRY(item, list, FdNode, node) {
-        if (*fdArrLen == fdArrSize) {
-            int32_t *tmp = NULL;
+    ListenerModule module = g_fdTable[fd].module;
+    /* a callback earlier in this round may already have removed some triggers of the fd */
+    readySet &= g_fdTable[fd].triggerSet;
+    pthread_mutex_unlock(&g_fdSetLock);
 
-            tmp = (int32_t *)SoftBusCalloc(sizeof(int32_t) * fdArrSize * FDARR_EXPAND_BASE);
-            if (tmp == NULL) {
-                SoftBusFree(tmpFdArr);
-                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "SoftBusCalloc failed, out of memory");
-                return SOFTBUS_MALLOC_ERR;
-            }
-            for (int i = 0; i < *fdArrLen; i++) {
-                tmp[i] = tmpFdArr[i];
-            }
-            SoftBusFree(tmpFdArr);
-            tmpFdArr = tmp;
-            fdArrSize *= FDARR_EXPAND_BASE;
-        }
-        tmpFdArr[*fdArrLen] = item->fd;
-        *fdArrLen = *fdArrLen + 1;
+    SoftbusBaseListenerInfo *listenerInfo = g_listenerList[module].info;
+    if (listenerInfo == NULL || listenerInfo->status != LISTENER_RUNNING) {
+        return;
+    }
+    if ((readySet & TRIGGER_MASK_READ) != 0) {
+        OnEvent(module, fd, SOFTBUS_SOCKET_IN);
+    }
+    if ((readySet & TRIGGER_MASK_WRITE) != 0) {
+        OnEvent(module, fd, SOFTBUS_SOCKET_OUT);
+    }
+    if ((readySet & TRIGGER_MASK_EXCEPT) != 0) {
+        OnEvent(module, fd, SOFTBUS_SOCKET_EXCEPTION);
+    }
+    if (readySet == 0 && isError) {
+        OnEvent(module, fd, SOFTBUS_SOCKET_EXCEPTION);
     }
-    *fdArr = tmpFdArr;
-    return SOFTBUS_OK;
 }
 
-static void ProcessData(const fd_set *readSet, const fd_set *writeSet, const fd_set *exceptSet)
+#ifdef SOFTBUS_LISTENER_EPOLL
+static void ProcessData(const Reactor *reactor, const struct epoll_event *events, int32_t nEvents)
 {
-    for (int i = 0; i < UNUSE_BUTT; i++) {
-        SoftbusBaseListenerInfo *listenerInfo = g_listenerList[i].info;
-        if (listenerInfo == NULL || listenerInfo->status != LISTENER_RUNNING) {
+    for (int32_t i = 0; i < nEvents; i++) {
+        int32_t fd = events[i].data.fd;
+        if (fd == reactor->wakeupFd) {
+            uint64_t value = 0;
+            (void)read(reactor->wakeupFd, &value, sizeof(value));
             continue;
         }
-        if (pthread_mutex_lock(&g_listenerList[i].lock) != 0) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-            continue;
+        uint32_t revents = events[i].events;
+        uint32_t readySet = 0;
+        if ((revents & EPOLLIN) != 0) {
+            readySet |= TRIGGER_MASK_READ;
         }
-        int32_t listenFd = listenerInfo->listenFd;
-        int32_t *fdArr = NULL;
-        int32_t fdArrLen = 0;
-
-        if (CreateFdArr(&fdArr, &fdArrLen, &listenerInfo->node) != SOFTBUS_OK) {
-            pthread_mutex_unlock(&g_listenerList[i].lock);
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "CreateFdArr failed, module:%d", i);
-            continue;
+        if ((revents & EPOLLOUT) != 0) {
+            readySet |= TRIGGER_MASK_WRITE;
+        }
+        if ((revents & EPOLLPRI) != 0) {
+            readySet |= TRIGGER_MASK_EXCEPT;
         }
-        pthread_mutex_unlock(&g_listenerList[i].lock);
+        /* select reports such fds as ready, epoll only raises ERR/HUP when nothing else is pending */
+        DispatchFdEvents(fd, readySet, (revents & (EPOLLERR | EPOLLHUP)) != 0);
+    }
+}
 
-        if ((listenFd > 0) && FD_ISSET(listenFd, readSet)) {
-            OnEvent(i, listenFd, SOFTBUS_SOCKET_IN);
+static int32_t SelectThread(void *arg)
+{
+    Reactor *reactor = (Reactor *)arg;
+    struct epoll_event events[EPOLL_EVENT_BATCH];
+    int32_t nEvents = epoll_wait(reactor->epollFd, events, EPOLL_EVENT_BATCH, EPOLL_WAIT_TIMEOUT_MS);
+    if (nEvents < 0) {
+        if (errno == EINTR) {
+            return SOFTBUS_OK;
         }
-        for (int j = 0; j < fdArrLen; j++) {
-            if (FD_ISSET(fdArr[j], readSet)) {
-                OnEvent(i, fdArr[j], SOFTBUS_SOCKET_IN);
-            }
-            if (FD_ISSET(fdArr[j], writeSet)) {
-                OnEvent(i, fdArr[j], SOFTBUS_SOCKET_OUT);
-            }
-            if (FD_ISSET(fdArr[j], exceptSet)) {
-                OnEvent(i, fdArr[j], SOFTBUS_SOCKET_EXCEPTION);
-            }
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "epoll_wait failed, errno=%d", errno);
+        return SOFTBUS_TCP_SOCKET_ERR;
+    }
+    ProcessData(reactor, events, nEvents);
+    return SOFTBUS_OK;
+}
+#else
+static void ProcessData(const fd_set *readSet, const fd_set *writeSet, const fd_set *exceptSet,
+    int32_t maxFd, int32_t nEvents)
+{
+    for (int32_t fd = 0; fd <= maxFd && nEvents > 0; fd++) {
+        uint32_t readySet = 0;
+        if (FD_ISSET(fd, readSet)) {
+            readySet |= TRIGGER_MASK_READ;
+            nEvents--;
+        }
+        if (FD_ISSET(fd, writeSet)) {
+            readySet |= TRIGGER_MASK_WRITE;
+            nEvents--;
+        }
+        if (FD_ISSET(fd, exceptSet)) {
+            readySet |= TRIGGER_MASK_EXCEPT;
+            nEvents--;
+        }
+        if (readySet != 0) {
+            DispatchFdEvents(fd, readySet, false);
         }
-        SoftBusFree(fdArr);
     }
 }
 
-static int32_t SetSelect(const fd_set *readSet, const fd_set *writeSet, const fd_set *exceptSet)
+static int32_t SetSelect(const Reactor *reactor, const fd_set *readSet, const fd_set *writeSet,
+    const fd_set *exceptSet, int32_t *maxFd)
 {
     if (pthread_mutex_lock(&g_fdSetLock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return SOFTBUS_ERR;
     }
-    if (FdCopy(readSet, &g_readSet) != EOK) {
+    if (FdCopy(readSet, &reactor->readSet) != EOK) {
         goto EXIT;
     }
-    if (FdCopy(writeSet, &g_writeSet) != EOK) {
+    if (FdCopy(writeSet, &reactor->writeSet) != EOK) {
         goto EXIT;
     }
-    if (FdCopy(exceptSet, &g_exceptSet) != EOK) {
+    if (FdCopy(exceptSet, &reactor->exceptSet) != EOK) {
         goto EXIT;
     }
+    *maxFd = reactor->maxFd;
     pthread_mutex_unlock(&g_fdSetLock);
 
     return SOFTBUS_OK;
@@ -407,8 +662,9 @@ EXIT:
     return SOFTBUS_MEM_ERR;
 }
 
-static int32_t SelectThread(void)
+static int32_t SelectThread(void *arg)
 {
+    Reactor *reactor = (Reactor *)arg;
     struct timeval tv;
     tv.tv_sec = 0;
     tv.tv_usec = TIMEOUT;
@@ -422,11 +678,11 @@ static int32_t SelectThread(void)
     FD_ZERO(&readSet);
     FD_ZERO(&writeSet);
     FD_ZERO(&exceptSet);
-    if (SetSelect(&readSet, &writeSet, &exceptSet) != SOFTBUS_OK) {
+    int32_t maxFd = -1;
+    if (SetSelect(reactor, &readSet, &writeSet, &exceptSet, &maxFd) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "select failed with invalid listener");
         return SOFTBUS_ERR;
     }
-    int32_t maxFd = g_maxFd;
     if (maxFd < 0) {
         select(0, NULL, NULL, NULL, &tv);
         return SOFTBUS_OK;
@@ -439,10 +695,32 @@ static int32_t SelectThread(void)
     } else if (nEvents == 0) {
         return SOFTBUS_OK;
     } else {
-        ProcessData(&readSet, &writeSet, &exceptSet);
+        ProcessData(&readSet, &writeSet, &exceptSet, maxFd, nEvents);
         return SOFTBUS_OK;
     }
 }
+#endif
+
+static int32_t AddSelectJob(ListenerModule module)
+{
+    Reactor *reactor = ReactorOf(module);
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (reactor->isStarted) {
+        pthread_mutex_unlock(&g_fdSetLock);
+        RefreshEventEngine(reactor);
+        return SOFTBUS_OK;
+    }
+    int32_t ret = ThreadPoolAddJob(g_reactorPool, SelectThread, reactor, PERSISTENT,
+        (uintptr_t)(reactor - g_reactors));
+    if (ret == SOFTBUS_OK) {
+        reactor->isStarted = true;
+    }
+    pthread_mutex_unlock(&g_fdSetLock);
+    return ret;
+}
 
 static int32_t StartThread(ListenerModule module, ModeType modeType)
 {
@@ -452,12 +730,8 @@ static int32_t StartThread(ListenerModule module, ModeType modeType)
     }
     listenerInfo->modeType = modeType;
     listenerInfo->status = LISTENER_RUNNING;
-    if (modeType == SERVER_MODE) {
-        return ThreadPoolAddJob(g_serverPool, (int(*)(void *))SelectThread,
-            NULL, PERSISTENT, (uintptr_t)0);
-    } else if (modeType == CLIENT_MODE) {
-        return ThreadPoolAddJob(g_clientPool, (int(*)(void *))SelectThread,
-            NULL, PERSISTENT, (uintptr_t)0);
+    if (modeType == SERVER_MODE || modeType == CLIENT_MODE) {
+        return AddSelectJob(module);
     } else {
         return SOFTBUS_INVALID_PARAM;
     }
@@ -473,19 +747,10 @@ static int32_t PrepareBaseListener(ListenerModule module, ModeType modeType)
         return SOFTBUS_ERR;
     }
 
-    if (modeType == SERVER_MODE) {
-        if (g_serverPool == NULL) {
-            g_serverPool = ThreadPoolInit(SERVER_THREADNUM, SERVER_QUEUE_NUM);
-            if (g_serverPool == NULL) {
-                return SOFTBUS_MALLOC_ERR;
-            }
-        }
-    } else {
-        if (g_clientPool == NULL) {
-            g_clientPool = ThreadPoolInit(CLIENT_THREADNUM, CLIENT_QUEUE_NUM);
-            if (g_clientPool == NULL) {
-                return SOFTBUS_MALLOC_ERR;
-            }
+    if (g_reactorPool == NULL) {
+        g_reactorPool = ThreadPoolInit(REACTOR_NUM, REACTOR_QUEUE_NUM);
+        if (g_reactorPool == NULL) {
+            return SOFTBUS_MALLOC_ERR;
         }
     }
     int ret = StartThread(module, modeType);
@@ -508,7 +773,6 @@ static SoftbusBaseListenerInfo *CreateNewListenerInfo(void)
     listenerInfo->listenFd = -1;
     listenerInfo->listenPort = -1;
     listenerInfo->status = LISTENER_IDLE;
-    ListInit(&listenerInfo->node);
 
     if (pthread_mutex_lock(&g_fdSetLock) != 0) {
         SoftBusFree(listenerInfo);
@@ -516,9 +780,11 @@ static SoftbusBaseListenerInfo *CreateNewListenerInfo(void)
         return NULL;
     }
     if (g_fdSetInit == false) {
-        FD_ZERO(&g_readSet);
-        FD_ZERO(&g_writeSet);
-        FD_ZERO(&g_exceptSet);
+        if (InitEventEngine() != SOFTBUS_OK) {
+            pthread_mutex_unlock(&g_fdSetLock);
+            SoftBusFree(listenerInfo);
+            return NULL;
+        }
         g_fdSetInit = true;
     }
     pthread_mutex_unlock(&g_fdSetLock);
@@ -672,12 +938,13 @@ int32_t StopBaseListener(ListenerModule module)
     }
     listenerInfo->status = LISTENER_IDLE;
     if (listenerInfo->listenFd > 0) {
+        UnregisterListenFd(module, listenerInfo->listenFd);
         TcpShutDown(listenerInfo->listenFd);
     }
     listenerInfo->listenFd = -1;
     pthread_mutex_unlock(&g_listenerList[module].lock);
 
-    UpdateMaxFd();
+    RefreshEventEngine(ReactorOf(module));
     return SOFTBUS_OK;
 }
 
@@ -702,108 +969,6 @@ void DestroyBaseListener(ListenerModule module)
     pthread_mutex_unlock(&g_listenerList[module].lock);
 }
 
-static int32_t AddTriggerToSet(int32_t fd, TriggerType triggerType)
-{
-    int32_t ret = SOFTBUS_OK;
-    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-        return SOFTBUS_ERR;
-    }
-    switch (triggerType) {
-        case READ_TRIGGER:
-            FD_SET(fd, &g_readSet);
-            break;
-        case WRITE_TRIGGER:
-            FD_SET(fd, &g_writeSet);
-            break;
-        case EXCEPT_TRIGGER:
-            FD_SET(fd, &g_exceptSet);
-            break;
-        case RW_TRIGGER:
-            FD_SET(fd, &g_readSet);
-            FD_SET(fd, &g_writeSet);
-            break;
-        default:
-            ret = SOFTBUS_INVALID_PARAM;
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Invalid trigger type");
-            break;
-    }
-    pthread_mutex_unlock(&g_fdSetLock);
-
-    return ret;
-}
-
-static int32_t DelTriggerFromSet(int32_t fd, TriggerType triggerType)
-{
-    int32_t ret = SOFTBUS_OK;
-    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-        return SOFTBUS_ERR;
-    }
-    switch (triggerType) {
-        case READ_TRIGGER:
-            FD_CLR(fd, &g_readSet);
-            break;
-        case WRITE_TRIGGER:
-            FD_CLR(fd, &g_writeSet);
-            break;
-        case EXCEPT_TRIGGER:
-            FD_CLR(fd, &g_exceptSet);
-            break;
-        case RW_TRIGGER:
-            FD_CLR(fd, &g_readSet);
-            FD_CLR(fd, &g_writeSet);
-            break;
-        default:
-            ret = SOFTBUS_INVALID_PARAM;
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Invalid trigger type");
-            break;
-    }
-    pthread_mutex_unlock(&g_fdSetLock);
-
-    return ret;
-}
-
-static bool CheckFdIsExist(SoftbusBaseListenerInfo *info, int32_t fd)
-{
-    FdNode *item = NULL;
-    FdNode *nextItem = NULL;
-    LIST_FOR_EACH_ENTRY_SAFE(item, nextItem, &info->node, FdNode, node) {
-        if (item->fd == fd) {
-            return true;
-        }
-    }
-    return false;
-}
-
-static int32_t AddNewFdNode(SoftbusBaseListenerInfo *info, int32_t fd)
-{
-    FdNode *newNode = (FdNode *)SoftBusCalloc(sizeof(FdNode));
-    if (newNode == NULL) {
-        return SOFTBUS_MALLOC_ERR;
-    }
-    newNode->fd = fd;
-    ListInit(&newNode->node);
-    ListNodeInsert(&info->node, &newNode->node);
-    info->fdCount++;
-    return SOFTBUS_OK;
-}
-
-static void DelFdNode(SoftbusBaseListenerInfo *info, int32_t fd)
-{
-    FdNode *item = NULL;
-    FdNode *nextItem = NULL;
-
-    LIST_FOR_EACH_ENTRY_SAFE(item, nextItem, &info->node, FdNode, node) {
-        if (item->fd == fd) {
-            ListDelete(&item->node);
-            SoftBusFree(item);
-            info->fdCount--;
-            return;
-        }
-    }
-}
-
 int32_t AddTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
 {
     if (CheckModule(module) != SOFTBUS_OK || fd < 0 || CheckTrigger(triggerType) != SOFTBUS_OK) {
@@ -821,32 +986,49 @@ int32_t AddTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
         pthread_mutex_unlock(&g_listenerList[module].lock);
         return SOFTBUS_ERR;
     }
-
-    if (AddTriggerToSet(fd, triggerType) != SOFTBUS_OK) {
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         pthread_mutex_unlock(&g_listenerList[module].lock);
-        return SOFTBUS_ERR;
+        return SOFTBUS_LOCK_ERR;
     }
-
-    if (CheckFdIsExist(info, fd)) {
+    if (ExpandFdTable(fd) != SOFTBUS_OK) {
+        pthread_mutex_unlock(&g_fdSetLock);
         pthread_mutex_unlock(&g_listenerList[module].lock);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "fd exist");
-        return SOFTBUS_OK;
+        return SOFTBUS_ERR;
     }
 
-    if (AddNewFdNode(info, fd) != SOFTBUS_OK) {
-        (void)DelTriggerFromSet(fd, triggerType);
+    FdEntry *entry = &g_fdTable[fd];
+    bool isExist = (entry->module == module);
+    uint32_t oldSet = (entry->module == UNUSE_BUTT) ? 0 : entry->triggerSet;
+    uint32_t newSet = (isExist ? entry->triggerSet : 0) | TriggerToMask(triggerType);
+    if (oldSet != 0 && !isExist && ReactorOf(entry->module) != ReactorOf(module)) {
+        (void)ApplyTriggerSet(ReactorOf(entry->module), fd, oldSet, 0);
+        oldSet = 0;
+    }
+    if (ApplyTriggerSet(ReactorOf(module), fd, oldSet, newSet) != SOFTBUS_OK) {
+        pthread_mutex_unlock(&g_fdSetLock);
         pthread_mutex_unlock(&g_listenerList[module].lock);
         return SOFTBUS_ERR;
     }
+    if (!isExist) {
+        if (entry->module != UNUSE_BUTT) {
+            /* the previous owner closed the fd without DelTrigger and the number got reused */
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_WARN, "fd:%d taken over from module:%d", fd, entry->module);
+            if (g_listenerList[entry->module].info != NULL) {
+                g_listenerList[entry->module].info->fdCount--;
+            }
+        }
+        entry->module = module;
+        info->fdCount++;
+    }
+    entry->triggerSet = newSet;
+    pthread_mutex_unlock(&g_fdSetLock);
     pthread_mutex_unlock(&g_listenerList[module].lock);
 
-    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+    if (isExist) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "fd exist");
         return SOFTBUS_OK;
     }
-    g_maxFd = MaxFd(fd, g_maxFd);
-    pthread_mutex_unlock(&g_fdSetLock);
-
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
         "AddTrigger fd:%d success, current fdcount:%d, module:%d, triggerType:%d",
         fd, info->fdCount, module, triggerType);
@@ -868,13 +1050,27 @@ int32_t DelTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
         pthread_mutex_unlock(&g_listenerList[module].lock);
         return SOFTBUS_ERR;
     }
+    if (pthread_mutex_lock(&g_fdSetLock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        pthread_mutex_unlock(&g_listenerList[module].lock);
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (fd >= g_fdTableSize || g_fdTable[fd].module != module || fd == info->listenFd) {
+        pthread_mutex_unlock(&g_fdSetLock);
+        pthread_mutex_unlock(&g_listenerList[module].lock);
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "DelTrigger [fd:%d] not exist", fd);
+        return SOFTBUS_OK;
+    }
 
-    if (DelTriggerFromSet(fd, triggerType) != SOFTBUS_OK) {
+    FdEntry *entry = &g_fdTable[fd];
+    uint32_t newSet = entry->triggerSet & ~TriggerToMask(triggerType);
+    if (ApplyTriggerSet(ReactorOf(module), fd, entry->triggerSet, newSet) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
             "del trigger fail: fd = %d, trigger = %d", fd, triggerType);
     }
-
-    if (FD_ISSET(fd, &g_writeSet) || FD_ISSET(fd, &g_readSet) || FD_ISSET(fd, &g_exceptSet)) {
+    entry->triggerSet = newSet;
+    if (newSet != 0) {
+        pthread_mutex_unlock(&g_fdSetLock);
         pthread_mutex_unlock(&g_listenerList[module].lock);
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
             "DelTrigger [fd:%d] success, current fdcount:%d, triggerType:%d",
@@ -882,12 +1078,14 @@ int32_t DelTrigger(ListenerModule module, int32_t fd, TriggerType triggerType)
         return SOFTBUS_OK;
     }
 
-    DelFdNode(info, fd);
+    entry->module = UNUSE_BUTT;
+    info->fdCount--;
+    pthread_mutex_unlock(&g_fdSetLock);
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO,
         "DelTrigger and node [fd:%d] success, current fdcount:%d, triggerType:%d",
         fd, info->fdCount, triggerType);
     pthread_mutex_unlock(&g_listenerList[module].lock);
-    UpdateMaxFd();
+    RefreshEventEngine(ReactorOf(module));
 
     return SOFTBUS_OK;
 }
@@ -0,0 +1,215 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "softbus_conn_id_table.h"
+
+#include "softbus_adapter_mem.h"
+#include "softbus_errcode.h"
+#include "softbus_log.h"
+
+#define CONN_ID_TABLE_INIT_BITS 4
+#define CONN_ID_TABLE_LOAD_NUM 3
+#define CONN_ID_TABLE_LOAD_DEN 4
+#define CONN_ID_HASH_MULTIPLIER 0x9E3779B1U
+#define HASH_BITS 32
+
+#ifdef __LITEOS_M__
+#define TABLE_LOCK_INIT(lock) pthread_mutex_init((lock), NULL)
+#define TABLE_LOCK_DESTROY(lock) pthread_mutex_destroy(lock)
+#define TABLE_RDLOCK(lock) pthread_mutex_lock(lock)
+#define TABLE_WRLOCK(lock) pthread_mutex_lock(lock)
+#define TABLE_UNLOCK(lock) pthread_mutex_unlock(lock)
+#else
+#define TABLE_LOCK_INIT(lock) pthread_rwlock_init((lock), NULL)
+#define TABLE_LOCK_DESTROY(lock) pthread_rwlock_destroy(lock)
+#define TABLE_RDLOCK(lock) pthread_rwlock_rdlock(lock)
+#define TABLE_WRLOCK(lock) pthread_rwlock_wrlock(lock)
+#define TABLE_UNLOCK(lock) pthread_rwlock_unlock(lock)
+#endif
+
+/* the high bits of the product, the low ones barely change between sequential connectionIds */
+static uint32_t HashSlot(uint32_t bits, uint32_t connectionId)
+{
+    return (connectionId * CONN_ID_HASH_MULTIPLIER) >> (HASH_BITS - bits);
+}
+
+static uint32_t HomeSlot(const ConnIdTable *table, uint32_t connectionId)
+{
+    return HashSlot(table->bits, connectionId);
+}
+
+static int32_t FindSlot(const ConnIdTable *table, uint32_t connectionId)
+{
+    uint32_t mask = table->size - 1;
+    for (uint32_t i = HomeSlot(table, connectionId);; i = (i + 1) & mask) {
+        const ConnIdTableEntry *entry = &table->entries[i];
+        if (entry->value == NULL) {
+            return -1;
+        }
+        if (entry->connectionId == connectionId) {
+            return (int32_t)i;
+        }
+    }
+}
+
+static void PutEntry(ConnIdTableEntry *entries, uint32_t bits, uint32_t connectionId, void *value)
+{
+    uint32_t mask = (1U << bits) - 1;
+    uint32_t i = HashSlot(bits, connectionId);
+    while (entries[i].value != NULL) {
+        i = (i + 1) & mask;
+    }
+    entries[i].connectionId = connectionId;
+    entries[i].value = value;
+}
+
+static int32_t Grow(ConnIdTable *table)
+{
+    uint32_t newBits = table->bits + 1;
+    uint32_t newSize = 1U << newBits;
+    ConnIdTableEntry *entries = (ConnIdTableEntry *)SoftBusCalloc(sizeof(ConnIdTableEntry) * newSize);
+    if (entries == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "conn id table grow to %u failed", newSize);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    for (uint32_t i = 0; i < table->size; i++) {
+        if (table->entries[i].value != NULL) {
+            PutEntry(entries, newBits, table->entries[i].connectionId, table->entries[i].value);
+        }
+    }
+    SoftBusFree(table->entries);
+    table->entries = entries;
+    table->size = newSize;
+    table->bits = newBits;
+    return SOFTBUS_OK;
+}
+
+int32_t ConnIdTableInit(ConnIdTable *table)
+{
+    if (table == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    table->entries = (ConnIdTableEntry *)SoftBusCalloc(sizeof(ConnIdTableEntry) * (1U << CONN_ID_TABLE_INIT_BITS));
+    if (table->entries == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    if (TABLE_LOCK_INIT(&table->lock) != 0) {
+        SoftBusFree(table->entries);
+        table->entries = NULL;
+        return SOFTBUS_LOCK_ERR;
+    }
+    table->size = 1U << CONN_ID_TABLE_INIT_BITS;
+    table->bits = CONN_ID_TABLE_INIT_BITS;
+    table->count = 0;
+    return SOFTBUS_OK;
+}
+
+void ConnIdTableDeinit(ConnIdTable *table)
+{
+    if (table == NULL || table->entries == NULL) {
+        return;
+    }
+    (void)TABLE_LOCK_DESTROY(&table->lock);
+    SoftBusFree(table->entries);
+    table->entries = NULL;
+    table->size = 0;
+    table->bits = 0;
+    table->count = 0;
+}
+
+int32_t ConnIdTableAdd(ConnIdTable *table, uint32_t connectionId, void *value)
+{
+    if (table == NULL || table->entries == NULL || value == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (TABLE_WRLOCK(&table->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    if (FindSlot(table, connectionId) >= 0) {
+        (void)TABLE_UNLOCK(&table->lock);
+        return SOFTBUS_ALREADY_EXISTED;
+    }
+    if ((table->count + 1) * CONN_ID_TABLE_LOAD_DEN > table->size * CONN_ID_TABLE_LOAD_NUM &&
+        Grow(table) != SOFTBUS_OK) {
+        (void)TABLE_UNLOCK(&table->lock);
+        return SOFTBUS_MALLOC_ERR;
+    }
+    PutEntry(table->entries, table->bits, connectionId, value);
+    table->count++;
+    (void)TABLE_UNLOCK(&table->lock);
+    return SOFTBUS_OK;
+}
+
+void *ConnIdTableRemove(ConnIdTable *table, uint32_t connectionId)
+{
+    if (table == NULL || table->entries == NULL) {
+        return NULL;
+    }
+    if (TABLE_WRLOCK(&table->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return NULL;
+    }
+    int32_t slot = FindSlot(table, connectionId);
+    if (slot < 0) {
+        (void)TABLE_UNLOCK(&table->lock);
+        return NULL;
+    }
+    uint32_t mask = table->size - 1;
+    uint32_t hole = (uint32_t)slot;
+    void *value = table->entries[hole].value;
+    /* backward shift deletion keeps every probe chain free of tombstones */
+    for (uint32_t i = (hole + 1) & mask; table->entries[i].value != NULL; i = (i + 1) & mask) {
+        uint32_t home = HomeSlot(table, table->entries[i].connectionId);
+        if (((i - home) & mask) >= ((i - hole) & mask)) {
+            table->entries[hole] = table->entries[i];
+            hole = i;
+        }
+    }
+    table->entries[hole].connectionId = 0;
+    table->entries[hole].value = NULL;
+    table->count--;
+    (void)TABLE_UNLOCK(&table->lock);
+    return value;
+}
+
+int32_t ConnIdTableReadLock(ConnIdTable *table)
+{
+    if (table == NULL || table->entries == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (TABLE_RDLOCK(&table->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    return SOFTBUS_OK;
+}
+
+void ConnIdTableUnlock(ConnIdTable *table)
+{
+    if (table == NULL) {
+        return;
+    }
+    (void)TABLE_UNLOCK(&table->lock);
+}
+
+void *ConnIdTableFind(const ConnIdTable *table, uint32_t connectionId)
+{
+    if (table == NULL || table->entries == NULL) {
+        return NULL;
+    }
+    int32_t slot = FindSlot(table, connectionId);
+    return (slot < 0) ? NULL : table->entries[slot].value;
+}
@@ -20,6 +20,7 @@
 #include <netinet/in.h>
 #include <netinet/tcp.h>
 #include <securec.h>
+#include <sys/ioctl.h>
 #include <sys/select.h>
 #include <sys/socket.h>
 #include <sys/types.h>
@@ -266,6 +267,79 @@ ssize_t SendTcpData(int fd, const char *buf, size_t len, int timeout)
     return bytes;
 }
 
+/* walks the local iov copy past the bytes sendmsg already took, returns the index of the first unsent segment */
+static int SkipSentIov(struct iovec *iov, int iovCnt, int first, size_t sent)
+{
+    while (first < iovCnt && sent >= iov[first].iov_len) {
+        sent -= iov[first].iov_len;
+        first++;
+    }
+    if (first < iovCnt) {
+        iov[first].iov_base = (char *)iov[first].iov_base + sent;
+        iov[first].iov_len -= sent;
+    }
+    return first;
+}
+
+ssize_t SendTcpDataV(int fd, const struct iovec *iov, int iovCnt, int timeout)
+{
+    if (fd < 0 || iov == NULL || iovCnt <= 0 || iovCnt > TCP_SEND_IOV_MAX) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "fd=%d iovCnt=%d invalid params", fd, iovCnt);
+        return -1;
+    }
+    struct iovec vec[TCP_SEND_IOV_MAX];
+    size_t len = 0;
+    for (int i = 0; i < iovCnt; i++) {
+        vec[i] = iov[i];
+        len += iov[i].iov_len;
+    }
+    if (len == 0) {
+        return -1;
+    }
+    if (timeout == 0) {
+        timeout = USER_TIMEOUT_MS;
+    }
+
+    int err = WaitEvent(fd, SOFTBUS_SOCKET_OUT, USER_TIMEOUT_MS);
+    if (err <= 0) {
+        return err;
+    }
+    ssize_t bytes = 0;
+    int first = 0;
+    while (1) {
+        struct msghdr msg;
+        (void)memset_s(&msg, sizeof(msg), 0, sizeof(msg));
+        msg.msg_iov = &vec[first];
+        msg.msg_iovlen = (size_t)(iovCnt - first);
+        errno = 0;
+        ssize_t rc = TEMP_FAILURE_RETRY(sendmsg(fd, &msg, 0));
+        if ((rc == -1) && (errno == EAGAIN)) {
+            continue;
+        } else if (rc <= 0) {
+            if (bytes == 0) {
+                bytes = -1;
+            }
+            break;
+        }
+        bytes += rc;
+        if (bytes == (ssize_t)(len)) {
+            break;
+        }
+        first = SkipSentIov(vec, iovCnt, first, (size_t)rc);
+
+        err = WaitEvent(fd, SOFTBUS_SOCKET_OUT, timeout);
+        if (err == 0) {
+            continue;
+        } else if (err < 0) {
+            if (bytes == 0) {
+                bytes = err;
+            }
+            break;
+        }
+    }
+    return bytes;
+}
+
 static ssize_t OnRecvData(int fd, char *buf, size_t len, int timeout, int flags)
 {
     if (fd < 0 || buf == NULL || len == 0) {
@@ -295,6 +369,12 @@ ssize_t RecvTcpData(int fd, char *buf, size_t len, int timeout)
     return OnRecvData(fd, buf, len, timeout, 0);
 }
 
+/* returns 0 instead of blocking when nothing is queued, negative when the peer is gone */
+ssize_t RecvTcpDataNoWait(int fd, char *buf, size_t len)
+{
+    return OnRecvData(fd, buf, len, 0, MSG_DONTWAIT);
+}
+
 void CloseTcpFd(int fd)
 {
     if (fd >= 0) {
@@ -353,4 +433,26 @@ int32_t SetTcpKeepAlive(int32_t fd, int32_t seconds)
         return -1;
     }
     return 0;
+}
+
+int32_t GetTcpSendWindow(int32_t fd)
+{
+    if (fd < 0) {
+        return -1;
+    }
+#ifdef TIOCOUTQ
+    int32_t sndBuf = 0;
+    socklen_t optLen = sizeof(sndBuf);
+    if (getsockopt(fd, SOL_SOCKET, SO_SNDBUF, &sndBuf, &optLen) != 0) {
+        return -1;
+    }
+    int32_t queued = 0;
+    if (ioctl(fd, TIOCOUTQ, &queued) != 0) {
+        return -1;
+    }
+    return (sndBuf > queued) ? (sndBuf - queued) : 0;
+#else
+    (void)fd;
+    return -1;
+#endif
 }
\ No newline at end of file
@@ -15,6 +15,7 @@
 
 #include "softbus_thread_pool.h"
 
+#include <sched.h>
 #include <sys/prctl.h>
 
 #include "softbus_adapter_mem.h"
@@ -27,6 +28,14 @@
 #endif
 #define THREAD_POOL_NAME "THREAD_POOL_WORKER"
 
+/*
+ * Every worker owns a ring. Submitters spread jobs over the rings round-robin without taking a lock,
+ * a worker runs the jobs of its own ring first and steals from the other rings once it runs dry.
+ * queueCurNum bounds the jobs alive in the pool by queueMaxNum and every ring holds at least
+ * queueMaxNum cells, so a push can not fail. pool->mutex is only taken to park an idle worker and to
+ * maintain the registry of PERSISTENT jobs used for handle lookups.
+ */
+
 typedef void *(*Runnable)(void *argv);
 typedef struct ThreadAttr ThreadAttr;
 
@@ -38,7 +47,6 @@ struct ThreadAttr {
 
 static int32_t CreateThread(Runnable run, void *argv, const ThreadAttr *attr, uint32_t *threadId);
 static ThreadPool* CreateThreadPool(int32_t threadNum, int32_t queueMaxNum);
-static void JobCheck(ThreadPool *pool, Job *job);
 static void ThreadPoolWorker(void *arg);
 
 static int32_t CreateThread(Runnable run, void *argv, const ThreadAttr *attr, uint32_t *threadId)
@@ -53,6 +61,87 @@ static int32_t CreateThread(Runnable run, void *argv, const ThreadAttr *attr, ui
     return errCode;
 }
 
+static uint32_t RoundUpPowerOfTwo(uint32_t num)
+{
+    uint32_t size = 1;
+    while (size < num) {
+        size <<= 1;
+    }
+    return size;
+}
+
+static int32_t JobRingInit(JobRing *ring, uint32_t capacity)
+{
+    uint32_t size = RoundUpPowerOfTwo(capacity);
+    ring->cells = (JobCell *)SoftBusCalloc(sizeof(JobCell) * size);
+    if (ring->cells == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    for (uint32_t i = 0; i < size; i++) {
+        ring->cells[i].seq = i;
+        ring->cells[i].job = NULL;
+    }
+    ring->mask = size - 1;
+    ring->enqueuePos = 0;
+    ring->dequeuePos = 0;
+    return SOFTBUS_OK;
+}
+
+static bool JobRingPush(JobRing *ring, Job *job)
+{
+    uint32_t pos = __atomic_load_n(&ring->enqueuePos, __ATOMIC_RELAXED);
+    JobCell *cell = NULL;
+    while (true) {
+        cell = &ring->cells[pos & ring->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - pos);
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->enqueuePos, &pos, pos + 1, true,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return false;
+        } else {
+            pos = __atomic_load_n(&ring->enqueuePos, __ATOMIC_RELAXED);
+        }
+    }
+    cell->job = job;
+    __atomic_store_n(&cell->seq, pos + 1, __ATOMIC_RELEASE);
+    return true;
+}
+
+static Job *JobRingPop(JobRing *ring)
+{
+    uint32_t pos = __atomic_load_n(&ring->dequeuePos, __ATOMIC_RELAXED);
+    JobCell *cell = NULL;
+    while (true) {
+        cell = &ring->cells[pos & ring->mask];
+        int32_t diff = (int32_t)(__atomic_load_n(&cell->seq, __ATOMIC_ACQUIRE) - (pos + 1));
+        if (diff == 0) {
+            if (__atomic_compare_exchange_n(&ring->dequeuePos, &pos, pos + 1, true,
+                __ATOMIC_RELAXED, __ATOMIC_RELAXED)) {
+                break;
+            }
+        } else if (diff < 0) {
+            return NULL;
+        } else {
+            pos = __atomic_load_n(&ring->dequeuePos, __ATOMIC_RELAXED);
+        }
+    }
+    Job *job = cell->job;
+    __atomic_store_n(&cell->seq, pos + ring->mask + 1, __ATOMIC_RELEASE);
+    return job;
+}
+
+static void DestroyWorkers(ThreadPool *pool)
+{
+    for (int32_t i = 0; i < pool->threadNum; ++i) {
+        SoftBusFree(pool->workers[i].ring.cells);
+    }
+    SoftBusFree(pool->workers);
+    pool->workers = NULL;
+}
+
 static ThreadPool* CreateThreadPool(int32_t threadNum, int32_t queueMaxNum)
 {
     if (threadNum <= 0 || queueMaxNum <= 0) {
@@ -67,8 +156,7 @@ static ThreadPool* CreateThreadPool(int32_t threadNum, int32_t queueMaxNum)
     pool->threadNum = threadNum;
     pool->queueMaxNum = queueMaxNum;
     pool->queueCurNum = 0;
-    pool->head = NULL;
-    pool->tail = NULL;
+    pool->persistentJobs = NULL;
     if (pthread_mutex_init(&(pool->mutex), NULL)) {
         SoftBusFree(pool);
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to init mutex");
@@ -84,11 +172,22 @@ static ThreadPool* CreateThreadPool(int32_t threadNum, int32_t queueMaxNum)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to init cond queueNotEmpty");
         return NULL;
     }
-    if (pthread_cond_init(&(pool->queueNotFull), NULL)) {
+    pool->workers = (PoolWorker *)SoftBusCalloc(sizeof(PoolWorker) * threadNum);
+    if (pool->workers == NULL) {
         SoftBusFree(pool);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to init cond queueNotFull");
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to malloc workers");
         return NULL;
     }
+    for (int32_t i = 0; i < threadNum; ++i) {
+        pool->workers[i].pool = pool;
+        pool->workers[i].index = i;
+        if (JobRingInit(&pool->workers[i].ring, (uint32_t)queueMaxNum) != SOFTBUS_OK) {
+            DestroyWorkers(pool);
+            SoftBusFree(pool);
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to malloc job ring");
+            return NULL;
+        }
+    }
     return pool;
 }
 
@@ -103,27 +202,18 @@ ThreadPool *ThreadPoolInit(int32_t threadNum, int32_t queueMaxNum)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to create thread pool");
         return NULL;
     }
-
-    pool->pthreads = (pthread_t *)SoftBusCalloc(sizeof(pthread_t) * threadNum);
-    if (pool->pthreads == NULL) {
-        SoftBusFree(pool);
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to malloc pthreads");
-        return NULL;
-    }
     pool->queueClose = 0;
     pool->poolClose = 0;
-    if (pthread_mutex_lock(&(pool->mutex)) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-        goto EXIT;
-    }
     int32_t countSuccess = 0;
     for (int32_t i = 0; i < pool->threadNum; ++i) {
         ThreadAttr attr = {"ThreadPoolWorker", 0, THREAD_PRIORITY};
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "create pthread now.");
-        if (CreateThread((Runnable)ThreadPoolWorker, (void *)pool, &attr, (uint32_t *)&(pool->pthreads[i])) != 0) {
+        PoolWorker *worker = &pool->workers[i];
+        if (CreateThread((Runnable)ThreadPoolWorker, (void *)worker, &attr, (uint32_t *)&(worker->thread)) != 0) {
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "create pthreads no. [%d] failed\n", i);
-            pool->pthreads[i] = (pthread_t)0;
+            worker->isStarted = false;
         } else {
+            worker->isStarted = true;
             ++countSuccess;
         }
     }
@@ -131,140 +221,205 @@ ThreadPool *ThreadPoolInit(int32_t threadNum, int32_t queueMaxNum)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Failed to create %d threads", pool->threadNum - countSuccess);
     }
     if (countSuccess == 0) {
-        pthread_mutex_unlock(&pool->mutex);
         goto EXIT;
     }
-    pthread_mutex_unlock(&(pool->mutex));
     return pool;
 
 EXIT:
     pthread_mutex_destroy(&pool->mutex);
     pthread_cond_destroy(&pool->queueEmpty);
     pthread_cond_destroy(&pool->queueNotEmpty);
-    pthread_cond_destroy(&pool->queueNotFull);
-    SoftBusFree(pool->pthreads);
+    DestroyWorkers(pool);
     SoftBusFree(pool);
     return NULL;
 }
 
-static void JobCheck(ThreadPool *pool, Job *job)
+static void WakeWorker(ThreadPool *pool)
 {
-    if (pool->queueClose || pool->poolClose) {
-        job->runnable = false;
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "Threadpool starts to close...");
+    if (__atomic_load_n(&pool->sleepNum, __ATOMIC_SEQ_CST) == 0) {
+        return;
     }
-    if (job->jobMode == PERSISTENT && job->runnable == true) {
-        pool->queueCurNum++;
-        pool->tail->next = job;
-        pool->tail = job;
+    if (pthread_mutex_lock(&(pool->mutex)) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
     }
-    if (pool->queueCurNum == 0) {
-        pool->head = pool->tail = NULL;
-    } else {
-        pool->head = job->next;
+    pthread_cond_signal(&(pool->queueNotEmpty));
+    pthread_mutex_unlock(&(pool->mutex));
+}
+
+static void EnqueueJob(ThreadPool *pool, PoolWorker *worker, Job *job)
+{
+    int32_t index = worker->index;
+    for (int32_t i = 0; i < pool->threadNum; ++i) {
+        if (JobRingPush(&pool->workers[(index + i) % pool->threadNum].ring, job)) {
+            __atomic_add_fetch(&pool->readyNum, 1, __ATOMIC_SEQ_CST);
+            WakeWorker(pool);
+            return;
+        }
     }
-    if (pool->tail != NULL) {
-        pool->tail->next = NULL;
+    /* unreachable while queueCurNum stays below the ring capacity */
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "job rings are full, drop job");
+}
+
+static Job *TakeJob(ThreadPool *pool, PoolWorker *worker)
+{
+    Job *job = JobRingPop(&worker->ring);
+    for (int32_t i = 1; job == NULL && i < pool->threadNum; ++i) {
+        job = JobRingPop(&pool->workers[(worker->index + i) % pool->threadNum].ring);
     }
+    if (job != NULL) {
+        __atomic_sub_fetch(&pool->readyNum, 1, __ATOMIC_SEQ_CST);
+    }
+    return job;
 }
 
-static void ThreadPoolWorker(void *arg)
+static void WaitForJob(ThreadPool *pool)
 {
-    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "ThreadPoolWorker Start");
-    if (arg == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ThreadPoolWorker arg is NULL");
+    if (pthread_mutex_lock(&(pool->mutex)) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return;
     }
-    ThreadPool *pool = (ThreadPool *)arg;
-    Job *job = NULL;
-    pthread_setname_np(pthread_self(), THREAD_POOL_NAME);
-    while (1) {
+    __atomic_add_fetch(&pool->sleepNum, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&pool->readyNum, __ATOMIC_SEQ_CST) <= 0 &&
+        !__atomic_load_n(&pool->poolClose, __ATOMIC_SEQ_CST)) {
+        pthread_cond_wait(&(pool->queueNotEmpty), &(pool->mutex));
+    }
+    __atomic_sub_fetch(&pool->sleepNum, 1, __ATOMIC_SEQ_CST);
+    pthread_mutex_unlock(&(pool->mutex));
+}
+
+static void ReleaseJobSlot(ThreadPool *pool)
+{
+    if (__atomic_sub_fetch(&pool->queueCurNum, 1, __ATOMIC_SEQ_CST) != 0 ||
+        !__atomic_load_n(&pool->queueClose, __ATOMIC_SEQ_CST)) {
+        return;
+    }
+    if (pthread_mutex_lock(&(pool->mutex)) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+    pthread_cond_signal(&(pool->queueEmpty));
+    pthread_mutex_unlock(&(pool->mutex));
+}
+
+static void RetireJob(ThreadPool *pool, Job *job)
+{
+    if (job->jobMode == PERSISTENT) {
         if (pthread_mutex_lock(&(pool->mutex)) != 0) {
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
             return;
         }
-        while ((pool->queueCurNum == 0) && !pool->poolClose) {
-            pthread_cond_wait(&(pool->queueNotEmpty), &(pool->mutex));
+        Job **link = &pool->persistentJobs;
+        while (*link != NULL && *link != job) {
+            link = &(*link)->next;
         }
-        if (pool->poolClose || pool->queueCurNum <= 0) {
-            pthread_mutex_unlock(&(pool->mutex));
-            break;
+        if (*link != NULL) {
+            *link = job->next;
         }
-        pool->queueCurNum--;
-        job = pool->head;
-        if (pthread_mutex_lock(&(job->mutex)) != 0) {
-            pool->queueCurNum++;
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-            pthread_mutex_unlock(&(pool->mutex));
+        pthread_mutex_unlock(&(pool->mutex));
+    }
+    SoftBusFree(job);
+    ReleaseJobSlot(pool);
+}
+
+static bool IsJobAlive(const ThreadPool *pool, Job *job)
+{
+    return !__atomic_load_n(&pool->queueClose, __ATOMIC_SEQ_CST) && __atomic_load_n(&job->runnable, __ATOMIC_ACQUIRE);
+}
+
+static void ThreadPoolWorker(void *arg)
+{
+    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "ThreadPoolWorker Start");
+    if (arg == NULL) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ThreadPoolWorker arg is NULL");
+        return;
+    }
+    PoolWorker *worker = (PoolWorker *)arg;
+    ThreadPool *pool = worker->pool;
+    pthread_setname_np(pthread_self(), THREAD_POOL_NAME);
+    while (1) {
+        Job *job = TakeJob(pool, worker);
+        if (job == NULL) {
+            if (__atomic_load_n(&pool->poolClose, __ATOMIC_SEQ_CST)) {
+                break;
+            }
+            /* give submitters a chance to refill the rings before paying for a sleep and a wakeup */
+            sched_yield();
+            if (__atomic_load_n(&pool->readyNum, __ATOMIC_SEQ_CST) <= 0) {
+                WaitForJob(pool);
+            }
             continue;
         }
-        JobCheck(pool, job);
-        if (pool->queueCurNum == 0) {
-            pthread_cond_signal(&(pool->queueEmpty));
-        }
-        if (pool->queueCurNum == pool->queueMaxNum - 1) {
-            pthread_cond_broadcast(&(pool->queueNotFull));
+        if (!IsJobAlive(pool, job)) {
+            if (__atomic_load_n(&pool->queueClose, __ATOMIC_SEQ_CST)) {
+                SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "Threadpool starts to close...");
+            }
+            RetireJob(pool, job);
+            continue;
         }
-        pthread_mutex_unlock(&(pool->mutex));
-        if (job->runnable) {
+        if (job->jobMode == ONCE) {
+            ReleaseJobSlot(pool);
             (void)(*(job->callbackFunction))(job->arg);
-        }
-        if (job->jobMode == ONCE || job->runnable == false) {
-            pthread_mutex_unlock(&(job->mutex));
-            pthread_mutex_destroy(&(job->mutex));
             SoftBusFree(job);
-            job = NULL;
+            continue;
         }
-        if (job != NULL) {
-            pthread_mutex_unlock(&(job->mutex));
+        (void)(*(job->callbackFunction))(job->arg);
+        if (IsJobAlive(pool, job)) {
+            EnqueueJob(pool, worker, job);
+        } else {
+            RetireJob(pool, job);
         }
     }
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "ThreadPoolWorker Exit");
 }
 
-static int32_t CheckThreadPoolAddReady(ThreadPool *pool, int32_t (*callbackFunction)(void *arg))
+static int32_t ReserveJobSlot(ThreadPool *pool)
+{
+    int32_t curNum = __atomic_load_n(&pool->queueCurNum, __ATOMIC_SEQ_CST);
+    do {
+        if (curNum >= pool->queueMaxNum) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "queueCurNum equals queueMaxNum, just quit");
+            return SOFTBUS_ERR;
+        }
+    } while (!__atomic_compare_exchange_n(&pool->queueCurNum, &curNum, curNum + 1, false,
+        __ATOMIC_SEQ_CST, __ATOMIC_SEQ_CST));
+    return SOFTBUS_OK;
+}
+
+static int32_t RegisterPersistentJob(ThreadPool *pool, Job *job)
 {
-    if (pool == NULL || callbackFunction == NULL) {
-        return SOFTBUS_INVALID_PARAM;
-    }
     if (pthread_mutex_lock(&(pool->mutex)) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return SOFTBUS_LOCK_ERR;
     }
-    if (pool->queueCurNum == pool->queueMaxNum) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "queueCurNum equals queueMaxNum, just quit");
-        pthread_mutex_unlock(&(pool->mutex));
-        return SOFTBUS_ERR;
-    }
-    while ((pool->queueCurNum == pool->queueMaxNum) && !(pool->queueClose || pool->poolClose)) {
-        pthread_cond_wait(&(pool->queueNotFull), &(pool->mutex));
-    }
-    if (pool->queueClose || pool->poolClose) {
-        pthread_mutex_unlock(&(pool->mutex));
-        return SOFTBUS_ERR;
+    for (Job *item = pool->persistentJobs; item != NULL; item = item->next) {
+        if (item->handle == job->handle && item->runnable == true) {
+            pthread_mutex_unlock(&(pool->mutex));
+            return SOFTBUS_ALREADY_EXISTED;
+        }
     }
-    // will call pthread_mutex_unlock in ThreadPoolAddJob
+    job->next = pool->persistentJobs;
+    pool->persistentJobs = job;
+    pthread_mutex_unlock(&(pool->mutex));
     return SOFTBUS_OK;
 }
 
 int32_t ThreadPoolAddJob(ThreadPool *pool, int32_t (*callbackFunction)(void *arg), void *arg,
     JobMode jobMode, uintptr_t handle)
 {
-    int32_t ret = CheckThreadPoolAddReady(pool, callbackFunction);
+    if (pool == NULL || callbackFunction == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (__atomic_load_n(&pool->queueClose, __ATOMIC_SEQ_CST) || __atomic_load_n(&pool->poolClose, __ATOMIC_SEQ_CST)) {
+        return SOFTBUS_ERR;
+    }
+    int32_t ret = ReserveJobSlot(pool);
     if (ret != SOFTBUS_OK) {
         return ret;
     }
-    Job* job = pool->head;
-    while (job != NULL) {
-        if (job->handle == handle && job->runnable == true) {
-            pthread_mutex_unlock(&(pool->mutex));
-            return SOFTBUS_ALREADY_EXISTED;
-        }
-        job = job->next;
-    }
-    job = (Job *)SoftBusCalloc(sizeof(Job));
+    Job *job = (Job *)SoftBusCalloc(sizeof(Job));
     if (job == NULL) {
-        pthread_mutex_unlock(&(pool->mutex));
+        ReleaseJobSlot(pool);
         return SOFTBUS_MALLOC_ERR;
     }
     job->callbackFunction = callbackFunction;
@@ -273,20 +428,16 @@ int32_t ThreadPoolAddJob(ThreadPool *pool, int32_t (*callbackFunction)(void *arg
     job->handle = handle;
     job->runnable = true;
     job->next = NULL;
-    if (pthread_mutex_init(&(job->mutex), NULL)) {
-        SoftBusFree(job);
-        pthread_mutex_unlock(&(pool->mutex));
-        return SOFTBUS_ERR;
-    }
-    if (pool->head == NULL) {
-        pool->head = pool->tail = job;
-        pthread_cond_broadcast(&(pool->queueNotEmpty));
-    } else {
-        pool->tail->next = job;
-        pool->tail = job;
+    if (jobMode == PERSISTENT) {
+        ret = RegisterPersistentJob(pool, job);
+        if (ret != SOFTBUS_OK) {
+            SoftBusFree(job);
+            ReleaseJobSlot(pool);
+            return ret;
+        }
     }
-    pool->queueCurNum++;
-    pthread_mutex_unlock(&(pool->mutex));
+    uint32_t index = __atomic_fetch_add(&pool->nextWorker, 1, __ATOMIC_RELAXED) % (uint32_t)pool->threadNum;
+    EnqueueJob(pool, &pool->workers[index], job);
     return SOFTBUS_OK;
 }
 
@@ -300,21 +451,12 @@ int32_t ThreadPoolRemoveJob(ThreadPool *pool, uintptr_t handle)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return SOFTBUS_LOCK_ERR;
     }
-    Job* job = pool->head;
-    while (job != NULL) {
-        if (job->handle == handle && job->jobMode == PERSISTENT && job->runnable == true) {
+    for (Job *job = pool->persistentJobs; job != NULL; job = job->next) {
+        if (job->handle == handle && job->runnable == true) {
+            /* the worker that pops it next drops it from the pool */
+            __atomic_store_n(&job->runnable, false, __ATOMIC_RELEASE);
             break;
         }
-        job = job->next;
-    }
-    if (job != NULL && job->runnable == true && job->jobMode == PERSISTENT) {
-        if (pthread_mutex_lock(&(job->mutex)) != 0) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-            pthread_mutex_unlock(&(job->mutex));
-            return SOFTBUS_LOCK_ERR;
-        }
-        job->runnable = false;
-        pthread_mutex_unlock(&(job->mutex));
     }
     pthread_mutex_unlock(&(pool->mutex));
     return SOFTBUS_OK;
@@ -333,30 +475,22 @@ int32_t ThreadPoolDestroy(ThreadPool *pool)
         pthread_mutex_unlock(&(pool->mutex));
         return SOFTBUS_OK;
     }
-    pool->queueClose = 1;
-    while (pool->queueCurNum != 0) {
+    __atomic_store_n(&pool->queueClose, 1, __ATOMIC_SEQ_CST);
+    while (__atomic_load_n(&pool->queueCurNum, __ATOMIC_SEQ_CST) != 0) {
         pthread_cond_wait(&(pool->queueEmpty), &(pool->mutex));
     }
-    pool->poolClose = 1;
-    pthread_mutex_unlock(&(pool->mutex));
+    __atomic_store_n(&pool->poolClose, 1, __ATOMIC_SEQ_CST);
     pthread_cond_broadcast(&(pool->queueNotEmpty));
-    pthread_cond_broadcast(&(pool->queueNotFull));
+    pthread_mutex_unlock(&(pool->mutex));
     for (int32_t i = 0; i < pool->threadNum; ++i) {
-        if (pool->pthreads != NULL) {
-            pthread_join(pool->pthreads[i], NULL);
+        if (pool->workers[i].isStarted) {
+            pthread_join(pool->workers[i].thread, NULL);
         }
     }
     pthread_mutex_destroy(&(pool->mutex));
     pthread_cond_destroy(&(pool->queueEmpty));
     pthread_cond_destroy(&(pool->queueNotEmpty));
-    pthread_cond_destroy(&(pool->queueNotFull));
-    SoftBusFree(pool->pthreads);
-    Job* job = NULL;
-    while (pool->head != NULL) {
-        job = pool->head;
-        pool->head = job->next;
-        SoftBusFree(job);
-    }
+    DestroyWorkers(pool);
     SoftBusFree(pool);
     return SOFTBUS_OK;
 }
@@ -78,6 +78,8 @@ typedef struct {
     void (*OnConnected)(uint32_t connectionId, const ConnectionInfo *info);
     void (*OnDisconnected)(uint32_t connectionId, const ConnectionInfo *info);
     void (*OnDataReceived)(uint32_t connectionId, ConnModule moduleId, int64_t seq, char *data, int32_t len);
+    /* optional, the send window of connectionId has opened again after ConnGetSendWindow reported it low */
+    void (*OnWritable)(uint32_t connectionId);
 } ConnectCallback;
 
 typedef enum {
@@ -96,6 +98,26 @@ typedef struct {
     char *buf;
 } ConnPostData;
 
+#define CONN_POST_IOV_MAX 4
+
+typedef struct {
+    const char *base;
+    int32_t len;
+} ConnIoVec;
+
+/*
+ * Scatter/gather form of ConnPostData. The connection head is filled in by the connection manager and is not
+ * part of iov. The segments stay owned by the caller: they are sent or copied before ConnPostBytesVec returns.
+ */
+typedef struct {
+    int32_t module; // ConnModule
+    int64_t seq;
+    int32_t flag; // SendPriority
+    int32_t pid;
+    int32_t iovCnt;
+    const ConnIoVec *iov;
+} ConnPostVecData;
+
 typedef struct {
     void (*OnConnectSuccessed)(uint32_t requestId, uint32_t connectionId, const ConnectionInfo *info);
     void (*OnConnectFailed)(uint32_t requestId, int32_t reason);
@@ -140,6 +162,26 @@ void ConnUnSetConnectCallback(ConnModule moduleId);
 
 int32_t ConnPostBytes(uint32_t connectionId, ConnPostData *data);
 
+int32_t ConnPostBytesVec(uint32_t connectionId, const ConnPostVecData *data);
+
+/* a send window below this many bytes arms a single OnWritable for the connection */
+#define CONN_SEND_WINDOW_LOW 4096
+
+/*
+ * Number of bytes that can be posted to connectionId right now without blocking or being rejected with
+ * SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL. A window below CONN_SEND_WINDOW_LOW arms OnWritable.
+ */
+int32_t ConnGetSendWindow(uint32_t connectionId, uint32_t *window);
+
+/* packet sizes of a connection, the connection head included */
+typedef struct {
+    uint32_t sendUnit; /* largest packet the link writes without cutting it up, 0 on a stream */
+    uint32_t recvMax; /* largest packet this end of the link takes in */
+} ConnLinkLimit;
+
+/* read on every call, a caller sizing its packets by it follows the link when it is reconfigured */
+int32_t ConnGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit);
+
 int32_t ConnTypeIsSupport(ConnectType type);
 
 int32_t ConnGetConnectionInfo(uint32_t connectionId, ConnectionInfo *info);
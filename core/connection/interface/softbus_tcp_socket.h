@@ -42,6 +42,8 @@ extern "C" {
 )
 #endif
 
+#define TCP_SEND_IOV_MAX 8
+
 enum {
     SOFTBUS_SOCKET_OUT, // writable
     SOFTBUS_SOCKET_IN, // readable
@@ -52,10 +54,15 @@ int32_t OpenTcpServerSocket(const char *ip, int32_t port);
 int32_t OpenTcpClientSocket(const char *peerIp, const char *myIp, int32_t port);
 int32_t GetTcpSockPort(int32_t fd);
 ssize_t SendTcpData(int32_t fd, const char *buf, size_t len, int32_t timeout);
+/* gathers at most TCP_SEND_IOV_MAX segments into the stream without flattening them first */
+ssize_t SendTcpDataV(int32_t fd, const struct iovec *iov, int32_t iovCnt, int32_t timeout);
 ssize_t RecvTcpData(int32_t fd, char *buf, size_t len, int32_t timeout);
+ssize_t RecvTcpDataNoWait(int32_t fd, char *buf, size_t len);
 void CloseTcpFd(int32_t fd);
 void TcpShutDown(int32_t fd);
 int32_t SetTcpKeepAlive(int32_t fd, int32_t seconds);
+/* free bytes in the socket send buffer, -1 when the platform cannot tell */
+int32_t GetTcpSendWindow(int32_t fd);
 
 #ifdef __cplusplus
 #if __cplusplus
@@ -277,6 +277,26 @@ void ConnManagerDisconnected(uint32_t connectionId, const ConnectionInfo *info)
     return;
 }
 
+void ConnManagerWritable(uint32_t connectionId)
+{
+    int32_t i, num;
+    ConnListenerNode *node = NULL;
+    ConnListenerNode *listener = NULL;
+
+    num = GetAllListener(&node);
+    if (num == 0 || node == NULL) {
+        return;
+    }
+    for (i = 0; i < num; i++) {
+        listener = node + i;
+        if (listener->callback.OnWritable != NULL) {
+            listener->callback.OnWritable(connectionId);
+        }
+    }
+    SoftBusFree(node);
+    return;
+}
+
 int32_t ConnSetConnectCallback(ConnModule moduleId, const ConnectCallback *callback)
 {
     if (ModuleCheck(moduleId) != SOFTBUS_OK) {
@@ -360,6 +380,114 @@ int32_t ConnPostBytes(uint32_t connectionId, ConnPostData *data)
     return g_connManager[type]->PostBytes(connectionId, data->buf, data->len, data->pid, data->flag);
 }
 
+static int32_t GetIoVecLen(const ConnIoVec *iov, int32_t iovCnt)
+{
+    int32_t len = 0;
+    for (int32_t i = 0; i < iovCnt; i++) {
+        if (iov[i].len < 0 || (iov[i].len > 0 && iov[i].base == NULL) || iov[i].len > INT32_MAX - len) {
+            return -1;
+        }
+        len += iov[i].len;
+    }
+    return len;
+}
+
+/* managers that queue the packet need it in one buffer anyway, so flatten it once here */
+static int32_t PostFlattenedIoVec(uint32_t type, uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt,
+    int32_t pid, int32_t flag)
+{
+    int32_t len = GetIoVecLen(iov, iovCnt);
+    char *buf = (char *)SoftBusMalloc(len);
+    if (buf == NULL) {
+        return SOFTBUS_MALLOC_ERR;
+    }
+    int32_t offset = 0;
+    for (int32_t i = 0; i < iovCnt; i++) {
+        if (iov[i].len == 0) {
+            continue;
+        }
+        if (memcpy_s(buf + offset, len - offset, iov[i].base, iov[i].len) != EOK) {
+            SoftBusFree(buf);
+            return SOFTBUS_MEM_ERR;
+        }
+        offset += iov[i].len;
+    }
+    return g_connManager[type]->PostBytes(connectionId, buf, len, pid, flag);
+}
+
+int32_t ConnPostBytesVec(uint32_t connectionId, const ConnPostVecData *data)
+{
+    if (data == NULL || data->iov == NULL || data->iovCnt <= 0 || data->iovCnt > CONN_POST_IOV_MAX) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    int32_t payloadLen = GetIoVecLen(data->iov, data->iovCnt);
+    if (payloadLen <= 0 || payloadLen > INT32_MAX - (int32_t)sizeof(ConnPktHead)) {
+        return SOFTBUS_CONN_MANAGER_PKT_LEN_INVALID;
+    }
+
+    uint32_t type = (connectionId >> CONNECT_TYPE_SHIFT);
+    if (ConnTypeCheck((ConnectType)type) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "connectionId type is err %d", type);
+        return SOFTBUS_CONN_MANAGER_TYPE_NOT_SUPPORT;
+    }
+
+    ConnPktHead head = {
+        .magic = MAGIC_NUMBER,
+        .module = data->module,
+        .seq = data->seq,
+        .flag = data->flag,
+        .len = payloadLen,
+    };
+    ConnIoVec iov[CONN_POST_IOV_MAX + 1];
+    iov[0].base = (const char *)&head;
+    iov[0].len = sizeof(ConnPktHead);
+    for (int32_t i = 0; i < data->iovCnt; i++) {
+        iov[i + 1] = data->iov[i];
+    }
+
+    if (g_connManager[type]->PostBytesVec != NULL) {
+        return g_connManager[type]->PostBytesVec(connectionId, iov, data->iovCnt + 1, data->pid, data->flag);
+    }
+    if (g_connManager[type]->PostBytes == NULL) {
+        return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+    }
+    return PostFlattenedIoVec(type, connectionId, iov, data->iovCnt + 1, data->pid, data->flag);
+}
+
+int32_t ConnGetSendWindow(uint32_t connectionId, uint32_t *window)
+{
+    if (window == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+
+    uint32_t type = (connectionId >> CONNECT_TYPE_SHIFT);
+    if (ConnTypeCheck((ConnectType)type) != SOFTBUS_OK) {
+        return SOFTBUS_CONN_MANAGER_TYPE_NOT_SUPPORT;
+    }
+
+    if (g_connManager[type]->GetSendWindow == NULL) {
+        return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+    }
+    return g_connManager[type]->GetSendWindow(connectionId, window);
+}
+
+int32_t ConnGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit)
+{
+    if (limit == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+
+    uint32_t type = (connectionId >> CONNECT_TYPE_SHIFT);
+    if (ConnTypeCheck((ConnectType)type) != SOFTBUS_OK) {
+        return SOFTBUS_CONN_MANAGER_TYPE_NOT_SUPPORT;
+    }
+
+    if (g_connManager[type]->GetLinkLimit == NULL) {
+        return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+    }
+    return g_connManager[type]->GetLinkLimit(connectionId, limit);
+}
+
 int32_t ConnDisconnectDevice(uint32_t connectionId)
 {
     uint32_t type = (connectionId >> CONNECT_TYPE_SHIFT);
@@ -450,6 +578,7 @@ int32_t ConnServerInit(void)
     g_connManagerCb.OnConnected = ConnManagerConnected;
     g_connManagerCb.OnDisconnected = ConnManagerDisconnected;
     g_connManagerCb.OnDataReceived = ConnManagerRecvData;
+    g_connManagerCb.OnWritable = ConnManagerWritable;
 
     int isSupportTcp = 0;
     (void)SoftbusGetConfig(SOFTBUS_INT_SUPPORT_TCP_PROXY, &isSupportTcp, sizeof(isSupportTcp));
@@ -34,6 +34,12 @@ typedef struct {
     int32_t (*GetConnectionInfo)(uint32_t connectionId, ConnectionInfo *info);
     int32_t (*StartLocalListening)(const LocalListenerInfo *info);
     int32_t (*StopLocalListening)(const LocalListenerInfo *info);
+    /* optional, iov[0] is the connection head; without it ConnPostBytesVec flattens into PostBytes */
+    int32_t (*PostBytesVec)(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t pid, int32_t flag);
+    /* optional, see ConnGetSendWindow; the backend calls OnWritable once a reported low window opens again */
+    int32_t (*GetSendWindow)(uint32_t connectionId, uint32_t *window);
+    /* optional, see ConnGetLinkLimit */
+    int32_t (*GetLinkLimit)(uint32_t connectionId, ConnLinkLimit *limit);
 } ConnectFuncInterface;
 
 #define MAGIC_NUMBER  0xBABEFACE
@@ -42,6 +42,12 @@ int32_t TcpDisconnectDeviceNow(const ConnectOption *option);
 
 int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32_t pid, int32_t flag);
 
+int32_t TcpPostBytesVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t pid, int32_t flag);
+
+int32_t TcpGetSendWindow(uint32_t connectionId, uint32_t *window);
+
+int32_t TcpGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit);
+
 int32_t TcpGetConnectionInfo(uint32_t connectionId, ConnectionInfo *Info);
 
 int32_t TcpStartListening(const LocalListenerInfo *info);
@@ -22,6 +22,7 @@
 #include "securec.h"
 #include "softbus_adapter_mem.h"
 #include "softbus_base_listener.h"
+#include "softbus_conn_id_table.h"
 #include "softbus_conn_interface.h"
 #include "softbus_conn_manager.h"
 #include "softbus_def.h"
@@ -33,19 +34,33 @@
 #include "softbus_utils.h"
 
 #define INVALID_DATA (-1)
+#define TCP_RECV_ROUND_MAX 8
+#define TCP_FRAME_ALIGN sizeof(int64_t)
 
 static int32_t g_tcpMaxConnNum;
 static int32_t g_tcpTimeOut;
 static int32_t g_tcpMaxLen;
 static char g_localIp[IP_LEN];
 
+/* bytes in [r, w) are received but not yet dispatched, a partial frame is moved to the front before reading */
+typedef struct {
+    char *data;
+    uint32_t size;
+    uint32_t r;
+    uint32_t w;
+} TcpRecvBuf;
+
 typedef struct TcpConnInfoNode {
     ListNode node;
     uint32_t connectionId;
     ConnectionInfo info;
+    TcpRecvBuf *recvBuf;
+    bool recvBusy; /* recvBuf is lent to the listener thread */
 } TcpConnInfoNode;
 
 static SoftBusList *g_tcpConnInfoList = NULL;
+/* indexes the nodes of g_tcpConnInfoList, updated with its lock held */
+static ConnIdTable g_tcpConnTable;
 static SoftbusBaseListener *g_tcpListener = NULL;
 static const ConnectCallback *g_tcpConnCallback;
 
@@ -63,12 +78,26 @@ int32_t TcpGetConnNum(void)
     return g_tcpConnInfoList->cnt;
 }
 
+static void FreeRecvBuf(TcpRecvBuf *buf)
+{
+    if (buf == NULL) {
+        return;
+    }
+    SoftBusFree(buf->data);
+    SoftBusFree(buf);
+}
+
+static void FreeTcpConnInfoNode(TcpConnInfoNode *item)
+{
+    FreeRecvBuf(item->recvBuf);
+    SoftBusFree(item);
+}
+
 int32_t AddTcpConnInfo(TcpConnInfoNode *item)
 {
     if (item == NULL || g_tcpConnInfoList == NULL) {
         return SOFTBUS_INVALID_PARAM;
     }
-    TcpConnInfoNode *temp = NULL;
     if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return SOFTBUS_LOCK_ERR;
@@ -78,13 +107,11 @@ int32_t AddTcpConnInfo(TcpConnInfoNode *item)
         (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
         return SOFTBUS_ERR;
     }
-    LIST_FOR_EACH_ENTRY(temp, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
-        if (temp->connectionId == item->connectionId) {
-            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
-                "ConnectionId:%08x ready in ConnectionInfoList.", item->connectionId);
-            (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
-            return SOFTBUS_ERR;
-        }
+    if (ConnIdTableAdd(&g_tcpConnTable, item->connectionId, item) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
+            "ConnectionId:%08x ready in ConnectionInfoList.", item->connectionId);
+        (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+        return SOFTBUS_ERR;
     }
     ListInit(&item->node);
     ListAdd(&g_tcpConnInfoList->list, &item->node);
@@ -98,28 +125,24 @@ int32_t DelTcpConnInfo(uint32_t connectionId, ConnectionInfo *info)
     if (g_tcpConnInfoList == NULL) {
         return SOFTBUS_ERR;
     }
-    TcpConnInfoNode *item = NULL;
     if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
         return SOFTBUS_LOCK_ERR;
     }
-    LIST_FOR_EACH_ENTRY(item, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
-        if (item->connectionId == connectionId) {
-            if (info != NULL) {
-                if (memcpy_s((void *)info, sizeof(ConnectionInfo), (void *)&item->info,
-                    sizeof(ConnectionInfo)) != EOK) {
-                    SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memcpy_s failed.");
-                    (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
-                    return SOFTBUS_MEM_ERR;
-                }
-            }
-            TcpShutDown(item->info.info.ipInfo.fd);
-            ListDelete(&item->node);
-            SoftBusFree(item);
-            g_tcpConnInfoList->cnt--;
-            (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
-            return SOFTBUS_OK;
+    TcpConnInfoNode *item = (TcpConnInfoNode *)ConnIdTableRemove(&g_tcpConnTable, connectionId);
+    if (item != NULL) {
+        int32_t ret = SOFTBUS_OK;
+        if (info != NULL && memcpy_s((void *)info, sizeof(ConnectionInfo), (void *)&item->info,
+            sizeof(ConnectionInfo)) != EOK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "memcpy_s failed.");
+            ret = SOFTBUS_MEM_ERR;
         }
+        TcpShutDown(item->info.info.ipInfo.fd);
+        ListDelete(&item->node);
+        FreeTcpConnInfoNode(item);
+        g_tcpConnInfoList->cnt--;
+        (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+        return ret;
     }
     (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
@@ -167,44 +190,169 @@ EXIT:
     return SOFTBUS_ERR;
 }
 
-static char *RecvData(const ConnPktHead *head, int32_t fd, int32_t len)
+/* SOFTBUS_MALLOC_ERR when the connection exists but has no buffer to read into */
+static int32_t AcquireRecvBuf(uint32_t connectionId, TcpRecvBuf **recvBuf)
+{
+    if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        return SOFTBUS_LOCK_ERR;
+    }
+    int32_t ret = SOFTBUS_ERR;
+    TcpRecvBuf *buf = NULL;
+    TcpConnInfoNode *item = NULL;
+    if (ConnIdTableReadLock(&g_tcpConnTable) == SOFTBUS_OK) {
+        item = (TcpConnInfoNode *)ConnIdTableFind(&g_tcpConnTable, connectionId);
+        ConnIdTableUnlock(&g_tcpConnTable);
+    }
+    if (item != NULL && !item->recvBusy) {
+        if (item->recvBuf == NULL) {
+            item->recvBuf = (TcpRecvBuf *)SoftBusCalloc(sizeof(TcpRecvBuf));
+        }
+        if (item->recvBuf != NULL && item->recvBuf->data == NULL) {
+            item->recvBuf->size = sizeof(ConnPktHead) + (uint32_t)g_tcpMaxLen;
+            item->recvBuf->data = (char *)SoftBusMalloc(item->recvBuf->size);
+            if (item->recvBuf->data == NULL) {
+                FreeRecvBuf(item->recvBuf);
+                item->recvBuf = NULL;
+            }
+        }
+        buf = item->recvBuf;
+        if (buf != NULL) {
+            item->recvBuf = NULL;
+            item->recvBusy = true;
+        }
+        ret = (buf != NULL) ? SOFTBUS_OK : SOFTBUS_MALLOC_ERR;
+    }
+    (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+    *recvBuf = buf;
+    return ret;
+}
+
+static void ReleaseRecvBuf(uint32_t connectionId, TcpRecvBuf *buf)
+{
+    if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+        FreeRecvBuf(buf);
+        return;
+    }
+    TcpConnInfoNode *item = NULL;
+    if (ConnIdTableReadLock(&g_tcpConnTable) == SOFTBUS_OK) {
+        item = (TcpConnInfoNode *)ConnIdTableFind(&g_tcpConnTable, connectionId);
+        ConnIdTableUnlock(&g_tcpConnTable);
+    }
+    if (item != NULL && item->recvBusy) {
+        item->recvBuf = buf;
+        item->recvBusy = false;
+        (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+        return;
+    }
+    (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+    /* the connection went away while its data was being dispatched */
+    FreeRecvBuf(buf);
+}
+
+static void CompactRecvBuf(TcpRecvBuf *buf)
+{
+    if (buf->r == 0) {
+        return;
+    }
+    if (buf->w > buf->r && memmove_s(buf->data, buf->size, buf->data + buf->r, buf->w - buf->r) != EOK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "compact recv buf failed");
+    }
+    buf->w -= buf->r;
+    buf->r = 0;
+}
+
+static int32_t DispatchFrames(uint32_t connectionId, TcpRecvBuf *buf)
 {
     uint32_t headSize = sizeof(ConnPktHead);
-    ssize_t recvLen;
-    if (len > g_tcpMaxLen) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data out of max data length, shutdown");
-        return NULL;
+    ConnPktHead head;
+    while (buf->w - buf->r >= headSize) {
+        if (memcpy_s(&head, headSize, buf->data + buf->r, headSize) != EOK) {
+            return SOFTBUS_MEM_ERR;
+        }
+        if (head.len < 0 || head.len > g_tcpMaxLen) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data out of max data length, shutdown");
+            return SOFTBUS_ERR;
+        }
+        uint32_t frameLen = headSize + (uint32_t)head.len;
+        if (buf->w - buf->r < frameLen) {
+            break;
+        }
+        /* receivers get the same alignment a freshly allocated packet used to have */
+        if (buf->r % TCP_FRAME_ALIGN != 0) {
+            CompactRecvBuf(buf);
+        }
+        g_tcpConnCallback->OnDataReceived(connectionId, head.module, head.seq, buf->data + buf->r, frameLen);
+        buf->r += frameLen;
     }
-    char *data = (char *)SoftBusCalloc(headSize + len);
-    if (data == NULL) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data malloc err");
-        return NULL;
+    if (buf->r == buf->w) {
+        buf->r = 0;
+        buf->w = 0;
     }
-    if (memcpy_s(data, headSize, head, headSize) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Tcp recv data copy head failed");
-        goto EXIT;
+    return SOFTBUS_OK;
+}
+
+static int32_t RecvFrames(uint32_t connectionId, int32_t fd, TcpRecvBuf *buf)
+{
+    for (int32_t round = 0; round < TCP_RECV_ROUND_MAX; round++) {
+        CompactRecvBuf(buf);
+        uint32_t space = buf->size - buf->w;
+        ssize_t bytes = RecvTcpDataNoWait(fd, buf->data + buf->w, space);
+        if (bytes < 0) {
+            return SOFTBUS_TCPCONNECTION_SOCKET_ERR;
+        }
+        if (bytes == 0) {
+            break;
+        }
+        buf->w += (uint32_t)bytes;
+        int32_t ret = DispatchFrames(connectionId, buf);
+        if (ret != SOFTBUS_OK) {
+            return ret;
+        }
+        if ((uint32_t)bytes < space) {
+            break;
+        }
     }
-    recvLen = RecvTcpData(fd, data + headSize, len, g_tcpTimeOut);
-    if (recvLen != len) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "receiveData: error occurred!");
-        goto EXIT;
+    return SOFTBUS_OK;
+}
+
+static int32_t TcpOnWritable(uint32_t connectionId, int32_t fd)
+{
+    /* the write trigger is one-shot, TcpGetSendWindow arms it again when the window runs low */
+    (void)DelTrigger(PROXY, fd, WRITE_TRIGGER);
+    if (g_tcpConnCallback->OnWritable != NULL) {
+        g_tcpConnCallback->OnWritable(connectionId);
     }
-    return data;
-EXIT:
-    SoftBusFree(data);
-    return NULL;
+    return SOFTBUS_OK;
 }
 
 int32_t TcpOnDataEvent(int32_t events, int32_t fd)
 {
-    if (g_tcpListener == NULL || events != SOFTBUS_SOCKET_IN) {
+    if (g_tcpListener == NULL || g_tcpConnInfoList == NULL) {
         return SOFTBUS_ERR;
     }
     uint32_t connectionId = CalTcpConnectionId(fd);
-    ConnPktHead head;
-    uint32_t headSize = sizeof(ConnPktHead);
-    ssize_t bytes = RecvTcpData(fd, (char *)&head, headSize, g_tcpTimeOut);
-    if (bytes <= 0) {
+    if (events == SOFTBUS_SOCKET_OUT) {
+        return TcpOnWritable(connectionId, fd);
+    }
+    if (events != SOFTBUS_SOCKET_IN) {
+        return SOFTBUS_ERR;
+    }
+    TcpRecvBuf *buf = NULL;
+    int32_t ret = AcquireRecvBuf(connectionId, &buf);
+    if (ret == SOFTBUS_OK) {
+        ret = RecvFrames(connectionId, fd, buf);
+        ReleaseRecvBuf(connectionId, buf);
+    } else if (ret == SOFTBUS_MALLOC_ERR) {
+        /* the unread data would fire the level-triggered listener again at once, drop the connection instead */
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "no recv buf for fd:%d, shutdown", fd);
+        ret = SOFTBUS_TCPCONNECTION_SOCKET_ERR;
+    } else {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "no recv buf for fd:%d", fd);
+        return SOFTBUS_ERR;
+    }
+    if (ret == SOFTBUS_TCPCONNECTION_SOCKET_ERR) {
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_INFO, "TcpOnDataEvent Disconnect fd:%d", fd);
         (void)DelTrigger(PROXY, fd, RW_TRIGGER);
         ConnectionInfo *info = SoftBusCalloc(sizeof(ConnectionInfo));
@@ -213,18 +361,11 @@ int32_t TcpOnDataEvent(int32_t events, int32_t fd)
         }
         SoftBusFree(info);
         return SOFTBUS_OK;
-    } else if (bytes != (ssize_t)headSize) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Recv Head failed.");
-        return SOFTBUS_ERR;
-    }
-    char *data = RecvData(&head, fd, head.len);
-    if (data == NULL) {
+    } else if (ret != SOFTBUS_OK) {
         (void)DelTrigger(PROXY, fd, RW_TRIGGER);
         DelTcpConnInfo(connectionId, NULL);
         return SOFTBUS_ERR;
     }
-    g_tcpConnCallback->OnDataReceived(connectionId, head.module, head.seq, data, headSize + head.len);
-    SoftBusFree(data);
     return SOFTBUS_OK;
 }
 
@@ -247,8 +388,9 @@ static void DelAllConnInfo(void)
         }
         item = LIST_ENTRY((&g_tcpConnInfoList->list)->next, TcpConnInfoNode, node);
         ListDelete(&item->node);
+        (void)ConnIdTableRemove(&g_tcpConnTable, item->connectionId);
         TcpShutDown(item->info.info.ipInfo.fd);
-        SoftBusFree(item);
+        FreeTcpConnInfoNode(item);
         g_tcpConnInfoList->cnt--;
     }
     ListInit(&g_tcpConnInfoList->list);
@@ -344,7 +486,8 @@ int32_t TcpDisconnectDeviceNow(const ConnectOption *option)
         if (strcmp(option->info.ipOption.ip, item->info.info.ipInfo.ip) == 0) {
             TcpShutDown(item->info.info.ipInfo.fd);
             ListDelete(&item->node);
-            SoftBusFree(item);
+            (void)ConnIdTableRemove(&g_tcpConnTable, item->connectionId);
+            FreeTcpConnInfoNode(item);
             g_tcpConnInfoList->cnt--;
             item = itemPrev;
         }
@@ -356,31 +499,34 @@ int32_t TcpDisconnectDeviceNow(const ConnectOption *option)
     return SOFTBUS_OK;
 }
 
+static int32_t GetTcpConnFd(uint32_t connectionId)
+{
+    int32_t fd = -1;
+    if (ConnIdTableReadLock(&g_tcpConnTable) != SOFTBUS_OK) {
+        return -1;
+    }
+    TcpConnInfoNode *item = (TcpConnInfoNode *)ConnIdTableFind(&g_tcpConnTable, connectionId);
+    if (item != NULL) {
+        fd = item->info.info.ipInfo.fd;
+    }
+    ConnIdTableUnlock(&g_tcpConnTable);
+    if (fd == -1) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "connectionId:%08x not found.", connectionId);
+    }
+    return fd;
+}
+
 int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32_t pid, int32_t flag)
 {
     (void)pid;
-    TcpConnInfoNode *item = NULL;
     if (g_tcpConnInfoList == NULL) {
         return SOFTBUS_ERR;
     }
     if (data == NULL || len <= 0) {
         return SOFTBUS_INVALID_PARAM;
     }
-    int32_t fd = -1;
-    if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
-        return SOFTBUS_LOCK_ERR;
-    }
-    LIST_FOR_EACH_ENTRY(item, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
-        if (item->connectionId == connectionId) {
-            fd = item->info.info.ipInfo.fd;
-            break;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+    int32_t fd = GetTcpConnFd(connectionId);
     if (fd == -1) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR,
-            "TcpPostBytes failed, connectionId:%08x not found.", connectionId);
         return SOFTBUS_ERR;
     }
     int32_t bytes = SendTcpData(fd, data, len, flag);
@@ -390,6 +536,71 @@ int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32
     return SOFTBUS_OK;
 }
 
+int32_t TcpPostBytesVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t pid, int32_t flag)
+{
+    (void)pid;
+    if (g_tcpConnInfoList == NULL) {
+        return SOFTBUS_ERR;
+    }
+    if (iov == NULL || iovCnt <= 0 || iovCnt > TCP_SEND_IOV_MAX) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    struct iovec vec[TCP_SEND_IOV_MAX];
+    ssize_t len = 0;
+    for (int32_t i = 0; i < iovCnt; i++) {
+        vec[i].iov_base = (void *)iov[i].base;
+        vec[i].iov_len = (size_t)iov[i].len;
+        len += iov[i].len;
+    }
+    int32_t fd = GetTcpConnFd(connectionId);
+    if (fd == -1) {
+        return SOFTBUS_ERR;
+    }
+    if (SendTcpDataV(fd, vec, iovCnt, flag) != len) {
+        return SOFTBUS_TCPCONNECTION_SOCKET_ERR;
+    }
+    return SOFTBUS_OK;
+}
+
+int32_t TcpGetSendWindow(uint32_t connectionId, uint32_t *window)
+{
+    if (g_tcpConnInfoList == NULL) {
+        return SOFTBUS_ERR;
+    }
+    if (window == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    int32_t fd = GetTcpConnFd(connectionId);
+    if (fd == -1) {
+        return SOFTBUS_ERR;
+    }
+    int32_t space = GetTcpSendWindow(fd);
+    if (space < 0) {
+        return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+    }
+    *window = (uint32_t)space;
+    if (*window < CONN_SEND_WINDOW_LOW && AddTrigger(PROXY, fd, WRITE_TRIGGER) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "arm write trigger failed, fd:%d", fd);
+    }
+    return SOFTBUS_OK;
+}
+
+int32_t TcpGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit)
+{
+    if (g_tcpConnInfoList == NULL) {
+        return SOFTBUS_ERR;
+    }
+    if (limit == NULL) {
+        return SOFTBUS_INVALID_PARAM;
+    }
+    if (GetTcpConnFd(connectionId) == -1) {
+        return SOFTBUS_ERR;
+    }
+    limit->sendUnit = 0;
+    limit->recvMax = sizeof(ConnPktHead) + (uint32_t)g_tcpMaxLen;
+    return SOFTBUS_OK;
+}
+
 int32_t TcpGetConnectionInfo(uint32_t connectionId, ConnectionInfo *info)
 {
     if (g_tcpConnInfoList == NULL) {
@@ -399,23 +610,20 @@ int32_t TcpGetConnectionInfo(uint32_t connectionId, ConnectionInfo *info)
         SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "info is NULL.");
         return SOFTBUS_INVALID_PARAM;
     }
-    TcpConnInfoNode *item = NULL;
-    if (pthread_mutex_lock(&g_tcpConnInfoList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "lock failed");
+    if (ConnIdTableReadLock(&g_tcpConnTable) != SOFTBUS_OK) {
         return SOFTBUS_LOCK_ERR;
     }
-    LIST_FOR_EACH_ENTRY(item, &g_tcpConnInfoList->list, TcpConnInfoNode, node) {
-        if (item->connectionId == connectionId) {
-            int32_t ret = memcpy_s(info, sizeof(ConnectionInfo), &item->info, sizeof(ConnectionInfo));
-            (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
-            if (ret != EOK) {
-                return SOFTBUS_MEM_ERR;
-            }
-            return SOFTBUS_OK;
+    TcpConnInfoNode *item = (TcpConnInfoNode *)ConnIdTableFind(&g_tcpConnTable, connectionId);
+    if (item != NULL) {
+        int32_t ret = memcpy_s(info, sizeof(ConnectionInfo), &item->info, sizeof(ConnectionInfo));
+        ConnIdTableUnlock(&g_tcpConnTable);
+        if (ret != EOK) {
+            return SOFTBUS_MEM_ERR;
         }
+        return SOFTBUS_OK;
     }
     info->isAvailable = false;
-    (void)pthread_mutex_unlock(&g_tcpConnInfoList->lock);
+    ConnIdTableUnlock(&g_tcpConnTable);
     SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "ConnectionId:%08x is not exists.", connectionId);
     return SOFTBUS_ERR;
 }
@@ -510,15 +718,24 @@ ConnectFuncInterface *ConnInitTcp(const ConnectCallback *callback)
     interface->DisconnectDevice = TcpDisconnectDevice;
     interface->DisconnectDeviceNow = TcpDisconnectDeviceNow;
     interface->PostBytes = TcpPostBytes;
+    interface->PostBytesVec = TcpPostBytesVec;
+    interface->GetSendWindow = TcpGetSendWindow;
+    interface->GetLinkLimit = TcpGetLinkLimit;
     interface->GetConnectionInfo = TcpGetConnectionInfo;
     interface->StartLocalListening = TcpStartListening;
     interface->StopLocalListening = TcpStopListening;
     g_tcpConnCallback = callback;
 
     if (g_tcpConnInfoList == NULL) {
+        if (ConnIdTableInit(&g_tcpConnTable) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Create tcpConnTable failed.");
+            SoftBusFree(interface);
+            return NULL;
+        }
         g_tcpConnInfoList = CreateSoftBusList();
         if (g_tcpConnInfoList == NULL) {
             SoftBusLog(SOFTBUS_LOG_CONN, SOFTBUS_LOG_ERROR, "Create tcpConnInfoList failed.");
+            ConnIdTableDeinit(&g_tcpConnTable);
             SoftBusFree(interface);
             return NULL;
         }
@@ -530,6 +747,7 @@ ConnectFuncInterface *ConnInitTcp(const ConnectCallback *callback)
             SoftBusFree(interface);
             DestroySoftBusList(g_tcpConnInfoList);
             g_tcpConnInfoList = NULL;
+            ConnIdTableDeinit(&g_tcpConnTable);
             return NULL;
         }
     }
@@ -57,6 +57,30 @@ int32_t TcpPostBytes(uint32_t connectionId, const char *data, int32_t len, int32
     return SOFTBUS_OK;
 }
 
+int32_t TcpPostBytesVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t pid, int32_t flag)
+{
+    (void)connectionId;
+    (void)iov;
+    (void)iovCnt;
+    (void)pid;
+    (void)flag;
+    return SOFTBUS_OK;
+}
+
+int32_t TcpGetSendWindow(uint32_t connectionId, uint32_t *window)
+{
+    (void)connectionId;
+    (void)window;
+    return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+}
+
+int32_t TcpGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit)
+{
+    (void)connectionId;
+    (void)limit;
+    return SOFTBUS_CONN_MANAGER_OP_NOT_SUPPORT;
+}
+
 int32_t TcpGetConnectionInfo(uint32_t connectionId, ConnectionInfo *Info)
 {
     (void)connectionId;
@@ -52,6 +52,7 @@ public:
     int32_t StartTimeSync(const char *pkgName, const char *targetNetworkId, int32_t accuracy,
         int32_t period) override;
     int32_t StopTimeSync(const char *pkgName, const char *targetNetworkId) override;
+    int Dump(int fd, const std::vector<std::u16string> &args) override;
 
 protected:
     void OnStart() override;
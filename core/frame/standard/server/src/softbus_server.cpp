@@ -18,6 +18,7 @@
 #include "ipc_skeleton.h"
 #include "ipc_types.h"
 #include "lnn_bus_center_ipc.h"
+#include "message_handler.h"
 #include "securec.h"
 #include "softbus_conn_interface.h"
 #include "softbus_disc_server.h"
@@ -205,6 +206,13 @@ int32_t SoftBusServer::StopTimeSync(const char *pkgName, const char *targetNetwo
     return LnnIpcStopTimeSync(pkgName, targetNetworkId);
 }
 
+int SoftBusServer::Dump(int fd, const std::vector<std::u16string> &args)
+{
+    (void)args;
+    DumpLooperStats(fd);
+    return SOFTBUS_OK;
+}
+
 void SoftBusServer::OnStart()
 {
     SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_INFO, "SoftBusServer OnStart called!\n");
@@ -18,6 +18,7 @@
 
 #include <pthread.h>
 #include <stdint.h>
+#include <time.h>
 
 #include "common_list.h"
 #include "softbus_def.h"
@@ -34,19 +35,36 @@ enum {
     PENDING_TYPE_BUTT,
 };
 
+/* packets a channel may have sent and not yet had acked before the next send waits */
+#define PENDING_WINDOW_DEFAULT 8
+
 typedef struct {
-    ListNode node;
-    pthread_cond_t cond;
-    pthread_mutex_t lock;
+    ListNode node;     /* (channelId, seq) hash bucket, or the free pool */
+    ListNode chanNode; /* in flight packets of the channel, oldest first */
+    ListNode timeNode; /* in flight packets of the type, earliest deadline first */
     int32_t channelId;
     int32_t seq;
-    bool finded;
+    int32_t result;
+    struct timespec deadline; /* CLOCK_MONOTONIC */
 } PendingPktInfo;
 
+/*
+ * result is SOFTBUS_OK on ack, SOFTBUS_TIMOUT when none came in time, SOFTBUS_TRANS_PENDING_CHANNEL_CLOSED
+ * when the channel went away, or the reason given to CancelPendingPacket. Called without the pending lock.
+ */
+typedef void (*PendingPktComplete)(int32_t channelId, int32_t seqNum, int32_t result);
+
 int32_t PendingInit(int type);
 void PendingDeinit(int type);
-int32_t ProcPendingPacket(int32_t channelId, int32_t seqNum, int type);
+void PendingSetWindow(int type, uint32_t window);
+void PendingSetCompleteCallback(int type, PendingPktComplete complete);
+
+/* registers seqNum before it is sent, blocks only while the channel already has a full window in flight */
+int32_t AddPendingPacket(int32_t channelId, int32_t seqNum, int type);
+/* the ack for seqNum arrived */
 int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type);
+/* seqNum was never sent, or must stop waiting for reason */
+int32_t CancelPendingPacket(int32_t channelId, int32_t seqNum, int type, int32_t reason);
 int32_t DelPendingPacket(int32_t channelId, int type);
 
 #ifdef __cplusplus
@@ -15,156 +15,502 @@
 
 #include "trans_pending_pkt.h"
 
-#include <sys/time.h>
-#include <unistd.h>
-
 #include "softbus_adapter_mem.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_utils.h"
 
 #define TIME_OUT 2
-#define USECTONSEC 1000
+#define MS_PER_SEC 1000
+#define NS_PER_MS 1000000
+#define PENDING_HASH_MULTIPLIER 0x9E3779B1U
+#define PENDING_PKT_BUCKET_BITS 8
+#define PENDING_CHAN_BUCKET_BITS 6
+#define PENDING_PKT_BUCKET_NUM (1U << PENDING_PKT_BUCKET_BITS)
+#define PENDING_CHAN_BUCKET_NUM (1U << PENDING_CHAN_BUCKET_BITS)
+#define PENDING_POOL_MAX_FREE 64
+#define HASH_BITS 32
+
+/* a channel with packets in flight or senders waiting for its window, its cond is reused from the pool */
+typedef struct {
+    ListNode node; /* channel hash bucket, or the free pool */
+    ListNode pkts; /* in flight packets of the channel, oldest first */
+    pthread_cond_t cond;
+    int32_t channelId;
+    uint32_t inFlight;
+    uint32_t waiters;
+} PendingChannel;
+
+typedef struct {
+    pthread_mutex_t lock;
+    bool inited;
+    uint32_t window;
+    PendingPktComplete complete;
+    ListNode pktBucket[PENDING_PKT_BUCKET_NUM];
+    ListNode chanBucket[PENDING_CHAN_BUCKET_NUM];
+    ListNode timeline; /* every in flight packet, earliest deadline first */
+    ListNode pktPool;
+    uint32_t pktPoolCnt;
+    ListNode chanPool;
+    uint32_t chanPoolCnt;
+} PendingQueue;
+
+static PendingQueue g_pending[PENDING_TYPE_BUTT];
+
+static bool IsTypeValid(int type)
+{
+    return type >= PENDING_TYPE_PROXY && type < PENDING_TYPE_BUTT;
+}
+
+static void GetNow(struct timespec *now)
+{
+    now->tv_sec = 0;
+    now->tv_nsec = 0;
+    (void)clock_gettime(CLOCK_MONOTONIC, now);
+}
+
+static bool IsExpired(const struct timespec *deadline, const struct timespec *now)
+{
+    return (now->tv_sec > deadline->tv_sec) ||
+        (now->tv_sec == deadline->tv_sec && now->tv_nsec >= deadline->tv_nsec);
+}
+
+static int InitWaiterCond(pthread_cond_t *cond)
+{
+#ifdef __LITEOS_M__
+    return pthread_cond_init(cond, NULL);
+#else
+    /* deadlines are CLOCK_MONOTONIC, so the window wait has to time out on the same clock */
+    pthread_condattr_t condAttr;
+    if (pthread_condattr_init(&condAttr) != 0) {
+        return -1;
+    }
+    (void)pthread_condattr_setclock(&condAttr, CLOCK_MONOTONIC);
+    int ret = pthread_cond_init(cond, &condAttr);
+    (void)pthread_condattr_destroy(&condAttr);
+    return ret;
+#endif
+}
+
+static uint32_t PktBucket(int32_t channelId, int32_t seqNum)
+{
+    uint32_t hash = (((uint32_t)channelId * PENDING_HASH_MULTIPLIER) ^ (uint32_t)seqNum) * PENDING_HASH_MULTIPLIER;
+    return hash >> (HASH_BITS - PENDING_PKT_BUCKET_BITS);
+}
+
+static uint32_t ChanBucket(int32_t channelId)
+{
+    return ((uint32_t)channelId * PENDING_HASH_MULTIPLIER) >> (HASH_BITS - PENDING_CHAN_BUCKET_BITS);
+}
+
+static PendingPktInfo *FindPktLocked(PendingQueue *queue, int32_t channelId, int32_t seqNum)
+{
+    PendingPktInfo *item = NULL;
+    LIST_FOR_EACH_ENTRY(item, &queue->pktBucket[PktBucket(channelId, seqNum)], PendingPktInfo, node) {
+        if (item->channelId == channelId && item->seq == seqNum) {
+            return item;
+        }
+    }
+    return NULL;
+}
+
+static PendingChannel *FindChanLocked(PendingQueue *queue, int32_t channelId)
+{
+    PendingChannel *chan = NULL;
+    LIST_FOR_EACH_ENTRY(chan, &queue->chanBucket[ChanBucket(channelId)], PendingChannel, node) {
+        if (chan->channelId == channelId) {
+            return chan;
+        }
+    }
+    return NULL;
+}
+
+static PendingChannel *GetChanLocked(PendingQueue *queue, int32_t channelId)
+{
+    PendingChannel *chan = FindChanLocked(queue, channelId);
+    if (chan != NULL) {
+        return chan;
+    }
+    if (!IsListEmpty(&queue->chanPool)) {
+        chan = LIST_ENTRY(queue->chanPool.next, PendingChannel, node);
+        ListDelete(&chan->node);
+        queue->chanPoolCnt--;
+    } else {
+        chan = (PendingChannel *)SoftBusCalloc(sizeof(PendingChannel));
+        if (chan == NULL) {
+            return NULL;
+        }
+        if (InitWaiterCond(&chan->cond) != 0) {
+            SoftBusFree(chan);
+            return NULL;
+        }
+    }
+    chan->channelId = channelId;
+    chan->inFlight = 0;
+    chan->waiters = 0;
+    ListInit(&chan->pkts);
+    ListAdd(&queue->chanBucket[ChanBucket(channelId)], &chan->node);
+    return chan;
+}
+
+/* hands chan back once nothing is in flight on it and nobody waits for its window */
+static void PutChanLocked(PendingQueue *queue, PendingChannel *chan)
+{
+    if (chan->inFlight != 0 || chan->waiters != 0) {
+        return;
+    }
+    ListDelete(&chan->node);
+    if (queue->chanPoolCnt < PENDING_POOL_MAX_FREE) {
+        ListAdd(&queue->chanPool, &chan->node);
+        queue->chanPoolCnt++;
+        return;
+    }
+    (void)pthread_cond_destroy(&chan->cond);
+    SoftBusFree(chan);
+}
+
+static PendingPktInfo *AllocPktLocked(PendingQueue *queue)
+{
+    if (IsListEmpty(&queue->pktPool)) {
+        return (PendingPktInfo *)SoftBusCalloc(sizeof(PendingPktInfo));
+    }
+    PendingPktInfo *item = LIST_ENTRY(queue->pktPool.next, PendingPktInfo, node);
+    ListDelete(&item->node);
+    queue->pktPoolCnt--;
+    return item;
+}
+
+static void FreePktLocked(PendingQueue *queue, PendingPktInfo *item)
+{
+    if (queue->pktPoolCnt < PENDING_POOL_MAX_FREE) {
+        ListAdd(&queue->pktPool, &item->node);
+        queue->pktPoolCnt++;
+        return;
+    }
+    SoftBusFree(item);
+}
+
+/* unlinks item and moves it to done, its channel record stays until the caller puts it */
+static void CompletePktLocked(PendingChannel *chan, PendingPktInfo *item, int32_t result, ListNode *done)
+{
+    item->result = result;
+    ListDelete(&item->node);
+    ListDelete(&item->chanNode);
+    ListDelete(&item->timeNode);
+    ListTailInsert(done, &item->node);
+    chan->inFlight--;
+}
+
+/* deadlines are taken at insertion from one clock, so the timeline is sorted and only its head can expire */
+static void ExpirePendingLocked(PendingQueue *queue, ListNode *done)
+{
+    struct timespec now;
+    GetNow(&now);
+    while (!IsListEmpty(&queue->timeline)) {
+        PendingPktInfo *item = LIST_ENTRY(queue->timeline.next, PendingPktInfo, timeNode);
+        if (!IsExpired(&item->deadline, &now)) {
+            break;
+        }
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "chan %d seq %d not acked", item->channelId, item->seq);
+        PendingChannel *chan = FindChanLocked(queue, item->channelId);
+        CompletePktLocked(chan, item, SOFTBUS_TIMOUT, done);
+        (void)pthread_cond_signal(&chan->cond);
+        PutChanLocked(queue, chan);
+    }
+}
+
+/* softbus timer ticks until deadline, rounded up and at least one */
+static uint32_t TicksUntil(const struct timespec *deadline, const struct timespec *now)
+{
+    if (IsExpired(deadline, now)) {
+        return 1;
+    }
+    int64_t ms = (int64_t)(deadline->tv_sec - now->tv_sec) * MS_PER_SEC +
+        (int64_t)(deadline->tv_nsec - now->tv_nsec) / NS_PER_MS;
+    int64_t ticks = (ms + TIMER_TIMEOUT - 1) / TIMER_TIMEOUT;
+    return (ticks < 1) ? 1 : (uint32_t)ticks;
+}
 
-static SoftBusList *g_pendingList[PENDING_TYPE_BUTT] = {NULL, NULL};
+/*
+ * one wheel timer per type follows the head of the timeline. It is only moved when the timeline stops being
+ * empty; when the head is acked first the timer fires early and re-arms for the new head. The softbus timer is
+ * not aligned with the deadlines, so it may also fire up to a tick before the head is due and re-arms then.
+ */
+static void ArmExpireTimerLocked(int type, PendingQueue *queue)
+{
+    if (IsListEmpty(&queue->timeline)) {
+        return;
+    }
+    PendingPktInfo *head = LIST_ENTRY(queue->timeline.next, PendingPktInfo, timeNode);
+    struct timespec now;
+    GetNow(&now);
+    if (TimerWheelArm(SOFTBUS_PENDING_PKT_TIMER_FUN, (uint32_t)type, TicksUntil(&head->deadline, &now)) !=
+        SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pending[%d] arm expire timer failed", type);
+    }
+}
+
+static void NotifyComplete(PendingQueue *queue, ListNode *done)
+{
+    if (IsListEmpty(done)) {
+        return;
+    }
+    PendingPktInfo *item = NULL;
+    if (queue->complete != NULL) {
+        LIST_FOR_EACH_ENTRY(item, done, PendingPktInfo, node) {
+            queue->complete(item->channelId, item->seq, item->result);
+        }
+    }
+    PendingPktInfo *next = NULL;
+    (void)pthread_mutex_lock(&queue->lock);
+    LIST_FOR_EACH_ENTRY_SAFE(item, next, done, PendingPktInfo, node) {
+        ListDelete(&item->node);
+        FreePktLocked(queue, item);
+    }
+    (void)pthread_mutex_unlock(&queue->lock);
+}
+
+/* acks that never come are found by this timer, not only by the next send or ack of the type */
+static void PendingOnExpireTimer(uint32_t key)
+{
+    int type = (int)key;
+    if (!IsTypeValid(type)) {
+        return;
+    }
+    PendingQueue *queue = &g_pending[type];
+    if (!queue->inited) {
+        return;
+    }
+
+    ListNode done;
+    ListInit(&done);
+    (void)pthread_mutex_lock(&queue->lock);
+    ExpirePendingLocked(queue, &done);
+    ArmExpireTimerLocked(type, queue);
+    (void)pthread_mutex_unlock(&queue->lock);
+    NotifyComplete(queue, &done);
+}
 
 int32_t PendingInit(int type)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    if (!IsTypeValid(type)) {
         return SOFTBUS_ERR;
     }
 
-    g_pendingList[type] = CreateSoftBusList();
-    if (g_pendingList[type] == NULL) {
+    PendingQueue *queue = &g_pending[type];
+    if (TimerWheelRegister(SOFTBUS_PENDING_PKT_TIMER_FUN, PendingOnExpireTimer) != SOFTBUS_OK) {
         return SOFTBUS_ERR;
     }
+    if (pthread_mutex_init(&queue->lock, NULL) != 0) {
+        return SOFTBUS_ERR;
+    }
+    for (uint32_t i = 0; i < PENDING_PKT_BUCKET_NUM; i++) {
+        ListInit(&queue->pktBucket[i]);
+    }
+    for (uint32_t i = 0; i < PENDING_CHAN_BUCKET_NUM; i++) {
+        ListInit(&queue->chanBucket[i]);
+    }
+    ListInit(&queue->timeline);
+    ListInit(&queue->pktPool);
+    ListInit(&queue->chanPool);
+    queue->pktPoolCnt = 0;
+    queue->chanPoolCnt = 0;
+    queue->window = (queue->window == 0) ? PENDING_WINDOW_DEFAULT : queue->window;
+    queue->inited = true;
     return SOFTBUS_OK;
 }
 
 void PendingDeinit(int type)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    if (!IsTypeValid(type)) {
         return;
     }
 
-    if (g_pendingList[type] != NULL) {
-        DestroySoftBusList(g_pendingList[type]);
-        g_pendingList[type] = NULL;
+    PendingQueue *queue = &g_pending[type];
+    TimerWheelCancel(SOFTBUS_PENDING_PKT_TIMER_FUN, (uint32_t)type);
+    if (queue->inited) {
+        PendingPktInfo *item = NULL;
+        PendingPktInfo *next = NULL;
+        LIST_FOR_EACH_ENTRY_SAFE(item, next, &queue->timeline, PendingPktInfo, timeNode) {
+            ListDelete(&item->timeNode);
+            SoftBusFree(item);
+        }
+        LIST_FOR_EACH_ENTRY_SAFE(item, next, &queue->pktPool, PendingPktInfo, node) {
+            ListDelete(&item->node);
+            SoftBusFree(item);
+        }
+        PendingChannel *chan = NULL;
+        PendingChannel *nextChan = NULL;
+        for (uint32_t i = 0; i < PENDING_CHAN_BUCKET_NUM; i++) {
+            LIST_FOR_EACH_ENTRY_SAFE(chan, nextChan, &queue->chanBucket[i], PendingChannel, node) {
+                ListDelete(&chan->node);
+                ListAdd(&queue->chanPool, &chan->node);
+            }
+        }
+        LIST_FOR_EACH_ENTRY_SAFE(chan, nextChan, &queue->chanPool, PendingChannel, node) {
+            ListDelete(&chan->node);
+            (void)pthread_cond_destroy(&chan->cond);
+            SoftBusFree(chan);
+        }
+        (void)pthread_mutex_destroy(&queue->lock);
+        queue->inited = false;
     }
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "PendigPackManagerDeinit init ok");
 }
 
-int32_t ProcPendingPacket(int32_t channelId, int32_t seqNum, int type)
+void PendingSetWindow(int type, uint32_t window)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
-        return SOFTBUS_ERR;
+    if (IsTypeValid(type) && window > 0) {
+        g_pending[type].window = window;
     }
+}
 
-    PendingPktInfo *item;
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pending[%d] list not inited.", type);
-        return SOFTBUS_ERR;
+void PendingSetCompleteCallback(int type, PendingPktComplete complete)
+{
+    if (IsTypeValid(type)) {
+        g_pending[type].complete = complete;
     }
+}
 
-    pthread_mutex_lock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->seq == seqNum && item->channelId == channelId) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PendingPacket already Created");
-            pthread_mutex_unlock(&pendingList->lock);
-            return SOFTBUS_ERR;
+/* waits, with the lock held, until chan has room in the window; the oldest packet expiring also makes room */
+static void WaitWindowLocked(PendingQueue *queue, PendingChannel *chan, ListNode *done)
+{
+    chan->waiters++;
+    for (;;) {
+        ExpirePendingLocked(queue, done);
+        if (chan->inFlight < queue->window) {
+            break;
         }
+        PendingPktInfo *oldest = LIST_ENTRY(chan->pkts.next, PendingPktInfo, chanNode);
+        struct timespec deadline = oldest->deadline;
+        (void)pthread_cond_timedwait(&chan->cond, &queue->lock, &deadline);
     }
-    item = (PendingPktInfo *)SoftBusMalloc(sizeof(PendingPktInfo));
+    chan->waiters--;
+}
+
+static int32_t InsertPktLocked(int type, PendingQueue *queue, PendingChannel *chan, int32_t seqNum)
+{
+    if (FindPktLocked(queue, chan->channelId, seqNum) != NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "PendingPacket already Created");
+        return SOFTBUS_ERR;
+    }
+    PendingPktInfo *item = AllocPktLocked(queue);
     if (item == NULL) {
-        pthread_mutex_unlock(&pendingList->lock);
         return SOFTBUS_MALLOC_ERR;
     }
-
-    pthread_mutex_init(&item->lock, NULL);
-    pthread_cond_init(&item->cond, NULL);
-    item->channelId = channelId;
+    item->channelId = chan->channelId;
     item->seq = seqNum;
-    item->finded = false;
-
-    ListAdd(&pendingList->list, &item->node);
-    pendingList->cnt++;
-    pthread_mutex_unlock(&pendingList->lock);
-
-    struct timespec outtime;
-    struct timeval now;
-    gettimeofday(&now, NULL);
-    outtime.tv_sec = now.tv_sec + TIME_OUT;
-    outtime.tv_nsec = now.tv_usec * USECTONSEC;
-
-    pthread_mutex_lock(&item->lock);
-    pthread_cond_timedwait(&item->cond, &item->lock, &outtime);
+    item->result = SOFTBUS_OK;
+    GetNow(&item->deadline);
+    item->deadline.tv_sec += TIME_OUT;
+    bool wasIdle = IsListEmpty(&queue->timeline);
+    ListAdd(&queue->pktBucket[PktBucket(chan->channelId, seqNum)], &item->node);
+    ListTailInsert(&chan->pkts, &item->chanNode);
+    ListTailInsert(&queue->timeline, &item->timeNode);
+    chan->inFlight++;
+    if (wasIdle) {
+        ArmExpireTimerLocked(type, queue);
+    }
+    return SOFTBUS_OK;
+}
 
-    int32_t ret = SOFTBUS_OK;
-    if (item->finded != true) {
-        ret = SOFTBUS_TIMOUT;
+int32_t AddPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    if (!IsTypeValid(type)) {
+        return SOFTBUS_ERR;
     }
-    pthread_mutex_unlock(&item->lock);
 
-    pthread_mutex_lock(&pendingList->lock);
-    ListDelete(&item->node);
-    pthread_mutex_destroy(&item->lock);
-    pthread_cond_destroy(&item->cond);
-    SoftBusFree(item);
-    pendingList->cnt--;
-    pthread_mutex_unlock(&pendingList->lock);
+    PendingQueue *queue = &g_pending[type];
+    if (!queue->inited) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pending[%d] list not inited.", type);
+        return SOFTBUS_ERR;
+    }
 
+    ListNode done;
+    ListInit(&done);
+    int32_t ret = SOFTBUS_MALLOC_ERR;
+    (void)pthread_mutex_lock(&queue->lock);
+    PendingChannel *chan = GetChanLocked(queue, channelId);
+    if (chan != NULL) {
+        /* a repeated seq is refused up front rather than after waiting for the window */
+        if (FindPktLocked(queue, channelId, seqNum) == NULL) {
+            WaitWindowLocked(queue, chan, &done);
+        }
+        ret = InsertPktLocked(type, queue, chan, seqNum);
+        PutChanLocked(queue, chan);
+    }
+    (void)pthread_mutex_unlock(&queue->lock);
+    NotifyComplete(queue, &done);
     return ret;
 }
 
-int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type)
+static int32_t FinishPendingPacket(int32_t channelId, int32_t seqNum, int type, int32_t result)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    if (!IsTypeValid(type)) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "type[%d] illegal.", type);
         return SOFTBUS_ERR;
     }
 
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
+    PendingQueue *queue = &g_pending[type];
+    if (!queue->inited) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pendind list not exist");
         return SOFTBUS_ERR;
     }
 
-    PendingPktInfo *item = NULL;
-    pthread_mutex_lock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->seq == seqNum && item->channelId == channelId) {
-            item->finded = true;
-            pthread_cond_signal(&item->cond);
-            pthread_mutex_unlock(&pendingList->lock);
-            return SOFTBUS_OK;
-        }
+    int32_t ret = SOFTBUS_ERR;
+    ListNode done;
+    ListInit(&done);
+    (void)pthread_mutex_lock(&queue->lock);
+    PendingPktInfo *item = FindPktLocked(queue, channelId, seqNum);
+    if (item != NULL) {
+        PendingChannel *chan = FindChanLocked(queue, channelId);
+        CompletePktLocked(chan, item, result, &done);
+        (void)pthread_cond_signal(&chan->cond);
+        PutChanLocked(queue, chan);
+        ret = SOFTBUS_OK;
     }
-    pthread_mutex_unlock(&pendingList->lock);
-    return SOFTBUS_ERR;
+    ExpirePendingLocked(queue, &done);
+    (void)pthread_mutex_unlock(&queue->lock);
+    NotifyComplete(queue, &done);
+    return ret;
+}
+
+int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    return FinishPendingPacket(channelId, seqNum, type, SOFTBUS_OK);
+}
+
+int32_t CancelPendingPacket(int32_t channelId, int32_t seqNum, int type, int32_t reason)
+{
+    return FinishPendingPacket(channelId, seqNum, type, reason);
 }
 
 int32_t DelPendingPacket(int32_t channelId, int type)
 {
-    if (type < PENDING_TYPE_PROXY || type >= PENDING_TYPE_BUTT) {
+    if (!IsTypeValid(type)) {
         return SOFTBUS_ERR;
     }
 
-    SoftBusList *pendingList = g_pendingList[type];
-    if (pendingList == NULL) {
+    PendingQueue *queue = &g_pending[type];
+    if (!queue->inited) {
         return SOFTBUS_ERR;
     }
 
-    PendingPktInfo *item = NULL;
-    pthread_mutex_lock(&pendingList->lock);
-    LIST_FOR_EACH_ENTRY(item, &pendingList->list, PendingPktInfo, node) {
-        if (item->channelId == channelId) {
-            pthread_cond_signal(&item->cond);
-            pthread_mutex_unlock(&pendingList->lock);
-            return SOFTBUS_OK;
+    ListNode done;
+    ListInit(&done);
+    (void)pthread_mutex_lock(&queue->lock);
+    PendingChannel *chan = FindChanLocked(queue, channelId);
+    if (chan != NULL) {
+        PendingPktInfo *item = NULL;
+        PendingPktInfo *next = NULL;
+        LIST_FOR_EACH_ENTRY_SAFE(item, next, &chan->pkts, PendingPktInfo, chanNode) {
+            CompletePktLocked(chan, item, SOFTBUS_TRANS_PENDING_CHANNEL_CLOSED, &done);
         }
+        (void)pthread_cond_broadcast(&chan->cond);
+        PutChanLocked(queue, chan);
     }
-    pthread_mutex_unlock(&pendingList->lock);
+    (void)pthread_mutex_unlock(&queue->lock);
+    NotifyComplete(queue, &done);
     return SOFTBUS_OK;
 }
-
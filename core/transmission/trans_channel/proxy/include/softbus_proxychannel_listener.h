@@ -17,10 +17,11 @@
 #define SOFTBUS_PROXYCHANNEL_LISTENER_H
 #include <stdint.h>
 #include "softbus_app_info.h"
+#include "softbus_proxychannel_message.h"
 
 int32_t OnProxyChannelOpened(int32_t channelId, const AppInfo *appInfo, unsigned char isServer);
 int32_t OnProxyChannelOpenFailed(int32_t channelId, const AppInfo *appInfo);
 int32_t OnProxyChannelClosed(int32_t channelId, const AppInfo *appInfo);
-int32_t OnProxyChannelMsgReceived(int32_t channelId, const AppInfo *appInfo, const char *data, uint32_t len);
+int32_t OnProxyChannelMsgReceived(const ProxyChannelDataView *chan, const char *data, uint32_t len);
 
 #endif
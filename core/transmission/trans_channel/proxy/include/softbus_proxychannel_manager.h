@@ -33,9 +33,10 @@ void TransProxyDelByConnId(uint32_t connId);
 void TransProxyOpenProxyChannelSuccess(int32_t chanId);
 void TransProxyOpenProxyChannelFail(int32_t channelId, const AppInfo *appInfo);
 void TransProxyonMessageReceived(const ProxyMessage *msg);
-int32_t TransProxyGetSessionKeyByChanId(int32_t channelId, char *sessionKey, int32_t sessionKeySize);
+/* returns a referenced context, to be dropped with SoftBusReleaseCipherCtx */
+SoftBusCipherCtx *TransProxyGetCipherCtxByChanId(int32_t channelId);
 int16_t TransProxyGetNewMyId(void);
-int32_t TransProxyGetSendMsgChanInfo(int32_t channelId, ProxyChannelInfo *chanInfo);
+int32_t TransProxyGetSendMsgChanInfo(int32_t channelId, ProxyChannelDataView *chan);
 void TransProxyDelChanByReqId(int32_t reqId);
 int32_t TransProxyCreateChanInfo(ProxyChannelInfo *chan, int32_t channelId, const AppInfo *appInfo);
 void TransProxyChanProcessByReqId(int32_t reqId, uint32_t connId);
@@ -17,6 +17,7 @@
 #define SOFTBUS_PROXYCHANNEL_MESSAGE_H
 #include "stdint.h"
 #include "common_list.h"
+#include "softbus_adapter_crypto.h"
 #include "softbus_app_info.h"
 #include "softbus_conn_interface.h"
 
@@ -48,6 +49,7 @@ typedef enum {
 #define JSON_KEY_PKG_NAME "PKG_NAME"
 #define JSON_KEY_SESSION_KEY "SESSION_KEY"
 #define JSON_KEY_REQUEST_ID "REQUEST_ID"
+#define JSON_KEY_MAX_SLICE_LEN "MAX_SLICE_LEN"
 
 typedef struct {
     uint8_t type; // MsgType //VESION
@@ -98,7 +100,7 @@ typedef struct {
     int32_t reqId;
     int8_t isServer;
     int8_t status;
-    uint16_t timeout;
+    uint32_t lastActive; /* TimerWheelNow() of the last traffic or state change */
     int16_t myId;
     int16_t peerId;
     uint32_t connId;
@@ -107,23 +109,54 @@ typedef struct {
     char identity[IDENTITY_LEN + 1];
     AppInfo appInfo;
     int32_t chiperSide;
+    /* owned by the item in the channel list, copies must go through TransProxyGetCipherCtxByChanId */
+    SoftBusCipherCtx *cipherCtx;
+    uint32_t peerSliceMax; /* largest slice the peer takes, from the handshake; 0 when it did not say */
 } ProxyChannelInfo;
 
+/* what one data packet needs of its channel, snapshot on the stack instead of a whole ProxyChannelInfo */
+typedef struct {
+    int32_t channelId;
+    int8_t status;
+    int16_t myId;
+    int16_t peerId;
+    uint32_t connId;
+    AppType appType;
+    uint32_t peerSliceMax;
+    char pkgName[PKG_NAME_SIZE_MAX];
+} ProxyChannelDataView;
+
+#define SLICE_NUM_MAX 128
+/* slice length of peers that do not send JSON_KEY_MAX_SLICE_LEN, and the most they take */
+#define PROXY_SLICE_LEN_LEGACY 1024
+/* keeps the largest message within SLICE_NUM_MAX slices */
+#define PROXY_SLICE_LEN_MIN 256
+#define SLICE_BITMAP_WORDS (SLICE_NUM_MAX / 32)
+
+/* one message under reassembly, slices land at sliceSeq * sliceLen in whatever order they arrive */
 typedef struct {
     int32_t active;
-    int32_t timeout;
+    uint32_t lastActive; /* TimerWheelNow() when the last slice arrived */
+    int32_t msgId;
     int32_t sliceNumber;
-    int32_t expectedSeq;
+    int32_t recvNumber;
+    int32_t sliceLen; /* length of every slice but the last, 0 until one of them arrived */
     int32_t dataLen;
     int32_t bufLen;
     char *data;
+    int32_t tailLen;
+    char *tail; /* the last slice when it beat every other one, copied into data once sliceLen is known */
+    uint32_t bitmap[SLICE_BITMAP_WORDS];
 } SliceProcessor;
 
 #define PROCESSOR_MAX 3
+#define SLICE_LANE_MSG_MAX 4
 typedef struct {
     ListNode head;
     int32_t channelId;
-    SliceProcessor processor[PROCESSOR_MAX];
+    bool timerArmed;
+    /* a lane per priority, each with a few messages in flight */
+    SliceProcessor processor[PROCESSOR_MAX][SLICE_LANE_MSG_MAX];
 } ChannelSliceProcessor;
 
 int32_t TransProxyUnpackHandshakeAckMsg(const char *msg, ProxyChannelInfo *chanInfo);
@@ -41,6 +41,7 @@ typedef enum {
 int32_t TransProxyPostSessionData(int32_t channelId, const uint8_t *data, uint32_t len, SessionPktType flags);
 int32_t TransOnNormalMsgReceived(const char *pkgName, int32_t channelId, const char *data, uint32_t len);
 int32_t TransProxyDelSliceProcessorByChannelId(int32_t channelId);
+uint32_t TransProxyGetRecvSliceMax(uint32_t connId);
 int32_t TransProxyTransNetWorkMsg(ProxyMessageHead *msghead, const ProxyChannelInfo *info,
     const char *payLoad, int payLoadLen, int priority);
 void TransSliceManagerDeInit(void);
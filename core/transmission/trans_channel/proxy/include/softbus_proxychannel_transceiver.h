@@ -39,6 +39,8 @@ int32_t TransProxyTransInit(void);
 int32_t TransProxyCloseConnChannel(uint32_t connectionId);
 int32_t TransProxyOpenConnChannel(const AppInfo *appInfo, const ConnectOption *connInfo, int32_t *channelId);
 int32_t TransProxyTransSendMsg(uint32_t connectionId, char *buf, int32_t len, int32_t priority);
+/* iov is borrowed, the caller still owns and frees every segment */
+int32_t TransProxyTransSendMsgVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t priority);
 int32_t TransProxyGetConnectOption(uint32_t connectionId, ConnectOption *info);
 void TransCreateConnByConnId(uint32_t connId);
 int32_t TransDecConnRefByConnId(uint32_t connId);
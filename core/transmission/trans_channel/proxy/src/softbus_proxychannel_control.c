@@ -26,24 +26,25 @@
 #include "softbus_proxychannel_transceiver.h"
 #include "softbus_utils.h"
 
-int32_t TransProxySendMessage(ProxyChannelInfo *info, const char *payLoad, int32_t payLoadLen, int32_t priority)
+int32_t TransProxySendMessage(const ProxyChannelDataView *chan, const char *payLoad, int32_t payLoadLen,
+    int32_t priority)
 {
     char *buf = NULL;
     int32_t bufLen = 0;
     ProxyMessageHead msgHead = {0};
 
     msgHead.type = (PROXYCHANNEL_MSG_TYPE_NORMAL & FOUR_BIT_MASK) | (VERSION << VERSION_SHIFT);
-    if (info->appInfo.appType != APP_TYPE_NORMAL) {
+    if (chan->appType != APP_TYPE_NORMAL) {
         msgHead.chiper = (msgHead.chiper | ENCRYPTED);
     }
-    msgHead.myId = info->myId;
-    msgHead.peerId = info->peerId;
-    if (TransProxyPackMessage(&msgHead, info->connId, payLoad, payLoadLen, &buf, &bufLen) != SOFTBUS_OK) {
+    msgHead.myId = chan->myId;
+    msgHead.peerId = chan->peerId;
+    if (TransProxyPackMessage(&msgHead, chan->connId, payLoad, payLoadLen, &buf, &bufLen) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
         return SOFTBUS_TRANS_PROXY_PACKMSG_ERR;
     }
 
-    return TransProxyTransSendMsg(info->connId, buf, bufLen, priority);
+    return TransProxyTransSendMsg(chan->connId, buf, bufLen, priority);
 }
 
 int32_t TransProxyHandshake(ProxyChannelInfo *info)
@@ -148,24 +148,23 @@ int32_t OnProxyChannelClosed(int32_t channelId, const AppInfo *appInfo)
     return ret;
 }
 
-int32_t OnProxyChannelMsgReceived(int32_t channelId, const AppInfo *appInfo,
-                                  const char *data, uint32_t len)
+int32_t OnProxyChannelMsgReceived(const ProxyChannelDataView *chan, const char *data, uint32_t len)
 {
     int32_t ret = SOFTBUS_OK;
 
-    if (appInfo == NULL || data == NULL || len == 0) {
+    if (chan == NULL || data == NULL || len == 0) {
         return SOFTBUS_INVALID_PARAM;
     }
 
-    switch (appInfo->appType) {
+    switch (chan->appType) {
         case APP_TYPE_NORMAL:
-            TransOnNormalMsgReceived(appInfo->myData.pkgName, channelId, data, len);
+            TransOnNormalMsgReceived(chan->pkgName, chan->channelId, data, len);
             break;
         case APP_TYPE_AUTH:
             ret = SOFTBUS_ERR;
             break;
         case APP_TYPE_INNER:
-            NotifyNetworkingMsgReceived(channelId, data, len);
+            NotifyNetworkingMsgReceived(chan->channelId, data, len);
             break;
         default:
             ret = SOFTBUS_ERR;
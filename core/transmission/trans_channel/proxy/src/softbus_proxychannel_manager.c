@@ -22,6 +22,7 @@
 #include "common_list.h"
 #include "softbus_adapter_crypto.h"
 #include "softbus_adapter_mem.h"
+#include "softbus_conn_id_table.h"
 #include "softbus_conn_interface.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
@@ -31,6 +32,7 @@
 #include "softbus_proxychannel_message.h"
 #include "softbus_proxychannel_session.h"
 #include "softbus_proxychannel_transceiver.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_utils.h"
 #include "trans_pending_pkt.h"
 
@@ -38,31 +40,91 @@
 #define PROXY_CHANNEL_BT_IDLE_TIMEOUT 240 // 4min
 #define PROXY_CHANNEL_IDLE_TIMEOUT 15 // 10800 = 3 hour
 #define PROXY_CHANNEL_TCP_IDLE_TIMEOUT 43200 // tcp 24 hour
+#define PROXY_CHANNEL_LOCK_NUM 16
 
 static SoftBusList *g_proxyChannelList = NULL;
 static pthread_mutex_t g_myIdLock;
 
-static int32_t MyIdIsValid(int16_t myId)
+/*
+ * Every item of g_proxyChannelList is also indexed by channelId, which is the local myId as well, so the
+ * per-packet lookups take the index read lock instead of scanning the list under its mutex. The fields
+ * a lookup touches in place are guarded by a lock striped on channelId.
+ * Lock order: list lock -> index write lock, list lock -> channel lock, index read lock -> channel lock.
+ */
+static ConnIdTable g_proxyChannelIndex;
+static pthread_mutex_t g_proxyChannelLock[PROXY_CHANNEL_LOCK_NUM];
+
+static pthread_mutex_t *TransProxyChanLock(int32_t channelId)
 {
-    ProxyChannelInfo *item = NULL;
+    return &g_proxyChannelLock[(uint32_t)channelId % PROXY_CHANNEL_LOCK_NUM];
+}
 
-    if (g_proxyChannelList == NULL) {
-        return SOFTBUS_ERR;
+/* on success the index stays read locked and the channel lock held until TransProxyPutChan */
+static ProxyChannelInfo *TransProxyGetChan(int32_t channelId)
+{
+    if (g_proxyChannelList == NULL || ConnIdTableReadLock(&g_proxyChannelIndex) != SOFTBUS_OK) {
+        return NULL;
     }
+    ProxyChannelInfo *item = (ProxyChannelInfo *)ConnIdTableFind(&g_proxyChannelIndex, (uint32_t)channelId);
+    if (item == NULL) {
+        ConnIdTableUnlock(&g_proxyChannelIndex);
+        return NULL;
+    }
+    (void)pthread_mutex_lock(TransProxyChanLock(channelId));
+    return item;
+}
 
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
+static void TransProxyPutChan(const ProxyChannelInfo *item)
+{
+    (void)pthread_mutex_unlock(TransProxyChanLock(item->channelId));
+    ConnIdTableUnlock(&g_proxyChannelIndex);
+}
+
+/* called with the list lock held, lookups in flight finish before the item can be freed */
+static void TransProxyUnlinkChan(ProxyChannelInfo *item)
+{
+    (void)ConnIdTableRemove(&g_proxyChannelIndex, (uint32_t)item->channelId);
+    TimerWheelCancel(SOFTBUS_PROXYCHANNEL_TIMER_FUN, (uint32_t)item->channelId);
+    ListDelete(&(item->node));
+    g_proxyChannelList->cnt--;
+}
+
+/* how long a channel may go without traffic or a state change in status, 0 when it never times out */
+static uint32_t TransProxyChanTimeLimit(int8_t status)
+{
+    switch (status) {
+        case PROXY_CHANNEL_STATUS_PYH_CONNECTING:
+        case PROXY_CHANNEL_STATUS_HANDSHAKEING:
+        case PROXY_CHANNEL_STATUS_KEEPLIVEING:
+            return PROXY_CHANNEL_CONTROL_TIMEOUT;
+        case PROXY_CHANNEL_STATUS_COMPLETED:
+            return PROXY_CHANNEL_BT_IDLE_TIMEOUT;
+        default:
+            return 0;
     }
+}
 
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->myId == myId) {
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_ERR;
-        }
+static void TransProxyFillDataView(const ProxyChannelInfo *item, ProxyChannelDataView *chan)
+{
+    chan->channelId = item->channelId;
+    chan->status = item->status;
+    chan->myId = item->myId;
+    chan->peerId = item->peerId;
+    chan->connId = item->connId;
+    chan->appType = item->appInfo.appType;
+    chan->peerSliceMax = item->peerSliceMax;
+    (void)memcpy_s(chan->pkgName, sizeof(chan->pkgName), item->appInfo.myData.pkgName,
+        sizeof(item->appInfo.myData.pkgName));
+}
+
+static int32_t MyIdIsValid(int16_t myId)
+{
+    if (g_proxyChannelList == NULL || ConnIdTableReadLock(&g_proxyChannelIndex) != SOFTBUS_OK) {
+        return SOFTBUS_ERR;
     }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_OK;
+    bool used = (ConnIdTableFind(&g_proxyChannelIndex, (uint32_t)myId) != NULL);
+    ConnIdTableUnlock(&g_proxyChannelIndex);
+    return used ? SOFTBUS_ERR : SOFTBUS_OK;
 }
 
 static bool IsLittleEndianCPU(void)
@@ -157,12 +219,15 @@ static int32_t TransProxyUpdateAckInfo(ProxyChannelInfo *info)
 
     LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if ((item->myId == info->myId) && (strncmp(item->identity, info->identity, sizeof(item->identity)) == 0)) {
+            (void)pthread_mutex_lock(TransProxyChanLock(item->channelId));
             item->peerId = info->peerId;
+            item->peerSliceMax = info->peerSliceMax;
             item->status = PROXY_CHANNEL_STATUS_COMPLETED;
-            item->timeout = 0;
+            item->lastActive = TimerWheelNow();
             (void)memcpy_s(&(item->appInfo.peerData), sizeof(item->appInfo.peerData),
                            &(info->appInfo.peerData), sizeof(info->appInfo.peerData));
             (void)memcpy_s(info, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
+            (void)pthread_mutex_unlock(TransProxyChanLock(item->channelId));
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return SOFTBUS_OK;
         }
@@ -171,6 +236,13 @@ static int32_t TransProxyUpdateAckInfo(ProxyChannelInfo *info)
     return SOFTBUS_ERR;
 }
 
+/* called as an item leaves the channel list, packets already holding the context keep their reference */
+static void TransProxyReleaseChanCipher(ProxyChannelInfo *chan)
+{
+    SoftBusReleaseCipherCtx(chan->cipherCtx);
+    chan->cipherCtx = NULL;
+}
+
 static void TransProxyAddChanItem(ProxyChannelInfo *chan)
 {
     if (g_proxyChannelList == NULL) {
@@ -183,7 +255,19 @@ static void TransProxyAddChanItem(ProxyChannelInfo *chan)
         SoftBusFree(chan);
         return;
     }
+    if (ConnIdTableAdd(&g_proxyChannelIndex, (uint32_t)chan->channelId, chan) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "index chan (%d) fail", chan->channelId);
+        (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
+        SoftBusFree(chan);
+        return;
+    }
     ListAdd(&(g_proxyChannelList->list), &(chan->node));
+    /* armed once, traffic only moves lastActive and the timer re-arms itself for what is left */
+    chan->lastActive = TimerWheelNow();
+    if (TransProxyChanTimeLimit(chan->status) != 0) {
+        (void)TimerWheelArm(SOFTBUS_PROXYCHANNEL_TIMER_FUN, (uint32_t)chan->channelId,
+            TransProxyChanTimeLimit(chan->status));
+    }
     g_proxyChannelList->cnt++;
     (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
     return;
@@ -191,27 +275,13 @@ static void TransProxyAddChanItem(ProxyChannelInfo *chan)
 
 int32_t TransProxyGetChanByChanId(int32_t chanId, ProxyChannelInfo *chan)
 {
-    ProxyChannelInfo *item = NULL;
-    ProxyChannelInfo *nextNode = NULL;
-
-    if (g_proxyChannelList == NULL) {
+    ProxyChannelInfo *item = TransProxyGetChan(chanId);
+    if (item == NULL) {
         return SOFTBUS_ERR;
     }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
-    }
-
-    LIST_FOR_EACH_ENTRY_SAFE(item, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == chanId) {
-            (void)memcpy_s(chan, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_OK;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_ERR;
+    (void)memcpy_s(chan, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
+    TransProxyPutChan(item);
+    return SOFTBUS_OK;
 }
 
 void TransProxyDelChanByReqId(int32_t reqId)
@@ -231,10 +301,10 @@ void TransProxyDelChanByReqId(int32_t reqId)
     LIST_FOR_EACH_ENTRY_SAFE(item, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if ((item->reqId == reqId) &&
             (item->status == PROXY_CHANNEL_STATUS_PYH_CONNECTING)) {
-            ListDelete(&(item->node));
+            TransProxyUnlinkChan(item);
+            TransProxyReleaseChanCipher(item);
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "del item (%d)", item->channelId);
             TransProxyPostOpenFailMsgToLoop(item);
-            g_proxyChannelList->cnt--;
         }
     }
     (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
@@ -257,9 +327,9 @@ void TransProxyDelChanByChanId(int32_t chanlId)
 
     LIST_FOR_EACH_ENTRY_SAFE(item, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if (item->channelId == chanlId) {
-            ListDelete(&(item->node));
+            TransProxyUnlinkChan(item);
+            TransProxyReleaseChanCipher(item);
             SoftBusFree(item);
-            g_proxyChannelList->cnt--;
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "del chan info!");
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return;
@@ -284,8 +354,10 @@ void TransProxyChanProcessByReqId(int32_t reqId, uint32_t connId)
 
     LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if (item->reqId == reqId && item->status == PROXY_CHANNEL_STATUS_PYH_CONNECTING) {
+            (void)pthread_mutex_lock(TransProxyChanLock(item->channelId));
             item->status = PROXY_CHANNEL_STATUS_HANDSHAKEING;
             item->connId = connId;
+            (void)pthread_mutex_unlock(TransProxyChanLock(item->channelId));
             TransAddConnRefByConnId(connId);
             TransProxyPostHandshakeMsgToLoop(item->channelId);
         }
@@ -316,9 +388,9 @@ void TransProxyDelByConnId(uint32_t connId)
             } else {
                 OnProxyChannelClosed(removeNode->channelId, &(removeNode->appInfo));
             }
-            ListDelete(&(removeNode->node));
+            TransProxyUnlinkChan(removeNode);
+            TransProxyReleaseChanCipher(removeNode);
             SoftBusFree(removeNode);
-            g_proxyChannelList->cnt--;
         }
     }
     (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
@@ -341,12 +413,12 @@ static int32_t TransProxyDelByChannelId(int32_t channelId, ProxyChannelInfo *cha
 
     LIST_FOR_EACH_ENTRY_SAFE(removeNode, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if (removeNode->channelId == channelId) {
+            TransProxyUnlinkChan(removeNode);
+            TransProxyReleaseChanCipher(removeNode);
             if (channelInfo != NULL) {
                 (void)memcpy_s(channelInfo, sizeof(ProxyChannelInfo), removeNode, sizeof(ProxyChannelInfo));
             }
-            ListDelete(&(removeNode->node));
             SoftBusFree(removeNode);
-            g_proxyChannelList->cnt--;
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return SOFTBUS_OK;
         }
@@ -371,10 +443,10 @@ static int32_t TransProxyResetChan(ProxyChannelInfo *chanInfo)
 
     LIST_FOR_EACH_ENTRY_SAFE(removeNode, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if (ResetChanIsEqual(removeNode->status, removeNode, chanInfo) == SOFTBUS_OK) {
+            TransProxyUnlinkChan(removeNode);
+            TransProxyReleaseChanCipher(removeNode);
             (void)memcpy_s(chanInfo, sizeof(ProxyChannelInfo), removeNode, sizeof(ProxyChannelInfo));
-            ListDelete(&(removeNode->node));
             SoftBusFree(removeNode);
-            g_proxyChannelList->cnt--;
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return SOFTBUS_OK;
         }
@@ -384,9 +456,18 @@ static int32_t TransProxyResetChan(ProxyChannelInfo *chanInfo)
     return SOFTBUS_ERR;
 }
 
-static int32_t TransProxyGetRecvMsgChanInfo(int16_t myId, int16_t peerId, ProxyChannelInfo *chanInfo)
+static int32_t TransProxyGetRecvMsgChanInfo(int16_t myId, int16_t peerId, ProxyChannelDataView *chan)
 {
-    ProxyChannelInfo *item = NULL;
+    /* myId is our channelId, the list is only scanned for a peer that lost track of it */
+    ProxyChannelInfo *item = TransProxyGetChan(myId);
+    if (item != NULL) {
+        if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
+            item->lastActive = TimerWheelNow();
+        }
+        TransProxyFillDataView(item, chan);
+        TransProxyPutChan(item);
+        return SOFTBUS_OK;
+    }
 
     if (g_proxyChannelList == NULL) {
         return SOFTBUS_ERR;
@@ -398,11 +479,13 @@ static int32_t TransProxyGetRecvMsgChanInfo(int16_t myId, int16_t peerId, ProxyC
     }
 
     LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->myId == myId || item->peerId == peerId) {
+        if (item->peerId == peerId) {
+            (void)pthread_mutex_lock(TransProxyChanLock(item->channelId));
             if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
-                item->timeout = 0;
+                item->lastActive = TimerWheelNow();
             }
-            (void)memcpy_s(chanInfo, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
+            TransProxyFillDataView(item, chan);
+            (void)pthread_mutex_unlock(TransProxyChanLock(item->channelId));
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return SOFTBUS_OK;
         }
@@ -426,11 +509,13 @@ static int32_t TransProxyKeepAlvieChan(ProxyChannelInfo *chanInfo)
 
     LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
         if (ChanIsEqual(item, chanInfo) == SOFTBUS_OK) {
+            (void)pthread_mutex_lock(TransProxyChanLock(item->channelId));
             if (item->status == PROXY_CHANNEL_STATUS_KEEPLIVEING || item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
-                item->timeout = 0;
+                item->lastActive = TimerWheelNow();
                 item->status = PROXY_CHANNEL_STATUS_COMPLETED;
             }
             (void)memcpy_s(chanInfo, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
+            (void)pthread_mutex_unlock(TransProxyChanLock(item->channelId));
             (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
             return SOFTBUS_OK;
         }
@@ -439,137 +524,73 @@ static int32_t TransProxyKeepAlvieChan(ProxyChannelInfo *chanInfo)
     return SOFTBUS_ERR;
 }
 
-int32_t TransProxyGetSendMsgChanInfo(int32_t channelId, ProxyChannelInfo *chanInfo)
+int32_t TransProxyGetSendMsgChanInfo(int32_t channelId, ProxyChannelDataView *chan)
 {
-    ProxyChannelInfo *item = NULL;
-
-    if (g_proxyChannelList == NULL) {
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
         return SOFTBUS_ERR;
     }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
+    if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
+        item->lastActive = TimerWheelNow();
     }
-
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == channelId) {
-            if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
-                item->timeout = 0;
-            }
-            (void)memcpy_s(chanInfo, sizeof(ProxyChannelInfo), item, sizeof(ProxyChannelInfo));
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_OK;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_ERR;
+    TransProxyFillDataView(item, chan);
+    TransProxyPutChan(item);
+    return SOFTBUS_OK;
 }
 
 int32_t TransProxyGetNewChanSeq(int32_t channelId)
 {
-    ProxyChannelInfo *item = NULL;
     int32_t seq = 0;
-
-    if (g_proxyChannelList == NULL) {
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
         return seq;
     }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return seq;
-    }
-
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == channelId) {
-            seq = item->seq;
-            item->seq++;
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return seq;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
+    seq = item->seq;
+    item->seq++;
+    TransProxyPutChan(item);
     return seq;
 }
 
 int32_t TransProxySetChiperSide(int32_t channelId, int32_t side)
 {
-    ProxyChannelInfo *item = NULL;
-
-    if (g_proxyChannelList == NULL) {
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
         return SOFTBUS_ERR;
     }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
-    }
-
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == channelId) {
-            item->chiperSide = side;
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_OK;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_ERR;
+    item->chiperSide = side;
+    TransProxyPutChan(item);
+    return SOFTBUS_OK;
 }
 
 int32_t TransProxyGetChiperSide(int32_t channelId, int32_t *side)
 {
-    ProxyChannelInfo *item = NULL;
-
-    if (g_proxyChannelList == NULL) {
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
         return SOFTBUS_ERR;
     }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
-    }
-
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == channelId) {
-            *side = item->chiperSide;
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_OK;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_ERR;
+    *side = item->chiperSide;
+    TransProxyPutChan(item);
+    return SOFTBUS_OK;
 }
 
-int32_t TransProxyGetSessionKeyByChanId(int32_t channelId, char *sessionKey, int32_t sessionKeySize)
+SoftBusCipherCtx *TransProxyGetCipherCtxByChanId(int32_t channelId)
 {
-    ProxyChannelInfo *item = NULL;
-
-    if (g_proxyChannelList == NULL) {
-        return SOFTBUS_ERR;
-    }
-
-    if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
-        return SOFTBUS_ERR;
-    }
-
-    LIST_FOR_EACH_ENTRY(item, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        if (item->channelId == channelId) {
-            if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
-                item->timeout = 0;
-            }
-            if (memcpy_s(sessionKey, sessionKeySize, item->appInfo.sessionKey,
-                sizeof(item->appInfo.sessionKey)) != EOK) {
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s fail!");
-                (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-                return SOFTBUS_ERR;
-            }
-            (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-            return SOFTBUS_OK;
-        }
-    }
-    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
-    return SOFTBUS_ERR;
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
+        return NULL;
+    }
+    if (item->status == PROXY_CHANNEL_STATUS_COMPLETED) {
+        item->lastActive = TimerWheelNow();
+    }
+    /* the key schedule is built on first use and lives as long as the channel */
+    if (item->cipherCtx == NULL) {
+        item->cipherCtx = SoftBusCreateCipherCtx((const unsigned char *)item->appInfo.sessionKey,
+            sizeof(item->appInfo.sessionKey));
+    }
+    SoftBusCipherCtx *ctx = item->cipherCtx;
+    SoftBusAcquireCipherCtx(ctx);
+    TransProxyPutChan(item);
+    return ctx;
 }
 
 void TransProxyProcessHandshakeAckMsg(const ProxyMessage *msg)
@@ -580,6 +601,8 @@ void TransProxyProcessHandshakeAckMsg(const ProxyMessage *msg)
     }
 
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "recv ack msg");
+    /* the peer's max slice len is clamped to what this link takes */
+    info->connId = msg->connId;
     if (TransProxyUnpackHandshakeAckMsg(msg->data, info) != SOFTBUS_OK) {
         SoftBusFree(info);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "UnpackHandshakeAckMsg fail");
@@ -608,6 +631,8 @@ void TransProxyProcessHandshakeMsg(const ProxyMessage *msg)
         return;
     }
 
+    /* the peer's max slice len is clamped to what this link takes */
+    chan->connId = msg->connId;
     if (TransProxyUnpackHandshakeMsg(msg->data, chan) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "UnpackHandshakeMsg fail");
         SoftBusFree(chan);
@@ -638,7 +663,6 @@ void TransProxyProcessHandshakeMsg(const ProxyMessage *msg)
 
     chan->isServer = 1;
     chan->status = PROXY_CHANNEL_STATUS_COMPLETED;
-    chan->connId = msg->connId;
     chan->myId = newChanId;
     chan->channelId = newChanId;
     chan->peerId = msg->msgHead.peerId;
@@ -742,20 +766,15 @@ void TransProxyProcessKeepAliveAck(const ProxyMessage *msg)
 
 void TransProxyProcessDataRecv(const ProxyMessage *msg)
 {
-    ProxyChannelInfo *info = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
-    if (info == NULL) {
-        return;
-    }
+    ProxyChannelDataView chan;
 
-    if (TransProxyGetRecvMsgChanInfo(msg->msgHead.myId, msg->msgHead.peerId, info) != SOFTBUS_OK) {
+    if (TransProxyGetRecvMsgChanInfo(msg->msgHead.myId, msg->msgHead.peerId, &chan) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR,
             "data recv get info fail mid %d pid %d", msg->msgHead.myId, msg->msgHead.peerId);
-        SoftBusFree(info);
         return;
     }
 
-    OnProxyChannelMsgReceived(info->channelId, &(info->appInfo), msg->data, msg->dateLen);
-    SoftBusFree(info);
+    OnProxyChannelMsgReceived(&chan, msg->data, msg->dateLen);
 }
 
 void TransProxyonMessageReceived(const ProxyMessage *msg)
@@ -897,28 +916,19 @@ int32_t TransProxyCloseProxyChannel(int32_t channelId)
 
 int32_t TransProxySendMsg(int32_t channelId, const char *data, int32_t dataLen, int32_t priority)
 {
-    int32_t ret;
-    ProxyChannelInfo *info = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
-    if (info == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc in trans proxy send message.id[%d]", channelId);
-        return SOFTBUS_MALLOC_ERR;
-    }
+    ProxyChannelDataView chan;
 
-    if (TransProxyGetSendMsgChanInfo(channelId, info) != SOFTBUS_OK) {
+    if (TransProxyGetSendMsgChanInfo(channelId, &chan) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId err %d", channelId);
-        SoftBusFree(info);
         return SOFTBUS_TRANS_PROXY_SEND_CHANNELID_INVALID;
     }
 
-    if (info->status != PROXY_CHANNEL_STATUS_COMPLETED && info->status != PROXY_CHANNEL_STATUS_KEEPLIVEING) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", info->status);
-        SoftBusFree(info);
+    if (chan.status != PROXY_CHANNEL_STATUS_COMPLETED && chan.status != PROXY_CHANNEL_STATUS_KEEPLIVEING) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", chan.status);
         return SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
     }
 
-    ret = TransProxySendMessage(info, (char *)data, dataLen, priority);
-    SoftBusFree(info);
-    return ret;
+    return TransProxySendMessage(&chan, data, dataLen, priority);
 }
 void TransProxyTimerItemProc(const ListNode *proxyProcList)
 {
@@ -928,6 +938,7 @@ void TransProxyTimerItemProc(const ListNode *proxyProcList)
 
     LIST_FOR_EACH_ENTRY_SAFE(removeNode, nextNode, proxyProcList, ProxyChannelInfo, node) {
         ListDelete(&(removeNode->node));
+        TransProxyReleaseChanCipher(removeNode);
         if (removeNode->status == PROXY_CHANNEL_STATUS_TIMEOUT) {
             connId = removeNode->connId;
             ProxyChannelInfo *resetMsg = SoftBusMalloc(sizeof(ProxyChannelInfo));
@@ -950,52 +961,92 @@ void TransProxyTimerItemProc(const ListNode *proxyProcList)
     }
 }
 
-void TransProxyTimerProc(void)
+/* true when the channel expired and has to leave the list, else *remain is what is left of its deadline */
+static bool TransProxyCheckChanTimeout(ProxyChannelInfo *item, uint32_t *remain)
+{
+    uint32_t limit = TransProxyChanTimeLimit(item->status);
+    uint32_t idle = TimerWheelNow() - item->lastActive;
+
+    *remain = 0;
+    if (limit == 0) {
+        return false;
+    }
+    if (idle < limit) {
+        *remain = limit - idle;
+        return false;
+    }
+    if (item->status == PROXY_CHANNEL_STATUS_HANDSHAKEING || item->status == PROXY_CHANNEL_STATUS_PYH_CONNECTING) {
+        item->status = PROXY_CHANNEL_STATUS_HANDSHAKE_TIMEOUT;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) handshake is timeout", item->myId);
+    } else if (item->status == PROXY_CHANNEL_STATUS_KEEPLIVEING) {
+        item->status = PROXY_CHANNEL_STATUS_TIMEOUT;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) keepalvie is timeout", item->myId);
+    } else {
+        item->status = PROXY_CHANNEL_STATUS_TIMEOUT;
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) is idle", item->myId);
+    }
+    return true;
+}
+
+static void TransProxyOnChanTimer(uint32_t key)
 {
-    ProxyChannelInfo *removeNode = NULL;
-    ProxyChannelInfo *nextNode = NULL;
     ListNode proxyProcList;
+    uint32_t remain = 0;
 
-    if (g_proxyChannelList == 0 || g_proxyChannelList->cnt == 0) {
+    if (g_proxyChannelList == NULL) {
         return;
     }
     if (pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock mutex fail!");
         return;
     }
+    /* the channel may have been closed, or its id reused, since the timer was armed */
+    ProxyChannelInfo *item = TransProxyGetChan((int32_t)key);
+    if (item == NULL) {
+        (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
+        return;
+    }
+    bool expired = TransProxyCheckChanTimeout(item, &remain);
+    TransProxyPutChan(item);
 
     ListInit(&proxyProcList);
-    LIST_FOR_EACH_ENTRY_SAFE(removeNode, nextNode, &g_proxyChannelList->list, ProxyChannelInfo, node) {
-        removeNode->timeout++;
-        if (removeNode->status == PROXY_CHANNEL_STATUS_HANDSHAKEING ||
-            removeNode->status == PROXY_CHANNEL_STATUS_PYH_CONNECTING) {
-            if (removeNode->timeout >= PROXY_CHANNEL_CONTROL_TIMEOUT) {
-                removeNode->status = PROXY_CHANNEL_STATUS_HANDSHAKE_TIMEOUT;
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) handshake is timeout", removeNode->myId);
-                ListDelete(&(removeNode->node));
-                ListAdd(&proxyProcList, &(removeNode->node));
-                g_proxyChannelList->cnt--;
-            }
-        }
-        if (removeNode->status == PROXY_CHANNEL_STATUS_KEEPLIVEING) {
-            if (removeNode->timeout >= PROXY_CHANNEL_CONTROL_TIMEOUT) {
-                removeNode->status = PROXY_CHANNEL_STATUS_TIMEOUT;
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) keepalvie is timeout", removeNode->myId);
-                ListDelete(&(removeNode->node));
-                ListAdd(&proxyProcList, &(removeNode->node));
-                g_proxyChannelList->cnt--;
-            }
-        }
-        if (removeNode->status == PROXY_CHANNEL_STATUS_COMPLETED) {
-            if (removeNode->timeout >= PROXY_CHANNEL_BT_IDLE_TIMEOUT) {
-                removeNode->status = PROXY_CHANNEL_STATUS_TIMEOUT;
-                ListDelete(&(removeNode->node));
-                ListAdd(&proxyProcList, &(removeNode->node));
-                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel (%d) is idle", removeNode->myId);
-                g_proxyChannelList->cnt--;
-            }
-        }
+    if (expired) {
+        /* the channel lock is dropped before unlinking, the index write lock must never wait under it */
+        TransProxyUnlinkChan(item);
+        ListAdd(&proxyProcList, &(item->node));
+    } else if (remain > 0) {
+        (void)TimerWheelArm(SOFTBUS_PROXYCHANNEL_TIMER_FUN, key, remain);
+    }
+    (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
+    TransProxyTimerItemProc(&proxyProcList);
+}
+
+/*
+ * A message the peer never acked leaves a hole in the stream, so the channel is closed like an idle one and the
+ * client hears of it through OnChannelClosed. Send errors were already returned to the caller, and a channel
+ * that went away has been reported by whoever closed it.
+ */
+static void TransProxyOnPendingComplete(int32_t channelId, int32_t seqNum, int32_t result)
+{
+    if (result != SOFTBUS_TIMOUT) {
+        return;
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "chan %d msg seq %d not acked, close it", channelId, seqNum);
+    if (g_proxyChannelList == NULL || pthread_mutex_lock(&g_proxyChannelList->lock) != 0) {
+        return;
     }
+    ProxyChannelInfo *item = TransProxyGetChan(channelId);
+    if (item == NULL) {
+        (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
+        return;
+    }
+    item->status = PROXY_CHANNEL_STATUS_TIMEOUT;
+    TransProxyPutChan(item);
+
+    ListNode proxyProcList;
+    ListInit(&proxyProcList);
+    TransProxyUnlinkChan(item);
+    ListAdd(&proxyProcList, &(item->node));
     (void)pthread_mutex_unlock(&g_proxyChannelList->lock);
     TransProxyTimerItemProc(&proxyProcList);
 }
@@ -1006,6 +1057,12 @@ int32_t TransProxyManagerInit(const IServerChannelCallBack *cb)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "init lock failed");
         return SOFTBUS_ERR;
     }
+    for (int32_t i = 0; i < PROXY_CHANNEL_LOCK_NUM; i++) {
+        if (pthread_mutex_init(&g_proxyChannelLock[i], NULL) != 0) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "init chan lock failed");
+            return SOFTBUS_ERR;
+        }
+    }
 
     if (TransProxySetCallBack(cb) != SOFTBUS_OK) {
         return SOFTBUS_ERR;
@@ -1016,8 +1073,13 @@ int32_t TransProxyManagerInit(const IServerChannelCallBack *cb)
         return SOFTBUS_ERR;
     }
 
+    if (ConnIdTableInit(&g_proxyChannelIndex) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "init chan index failed");
+        return SOFTBUS_ERR;
+    }
     g_proxyChannelList = CreateSoftBusList();
     if (g_proxyChannelList == NULL) {
+        ConnIdTableDeinit(&g_proxyChannelIndex);
         return SOFTBUS_ERR;
     }
 
@@ -1025,9 +1087,11 @@ int32_t TransProxyManagerInit(const IServerChannelCallBack *cb)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans proxy pending init failed.");
         return SOFTBUS_ERR;
     }
+    PendingSetCompleteCallback(PENDING_TYPE_PROXY, TransProxyOnPendingComplete);
 
-    if (RegisterTimeoutCallback(SOFTBUS_PROXYCHANNEL_TIMER_FUN, TransProxyTimerProc) != SOFTBUS_OK) {
+    if (TimerWheelRegister(SOFTBUS_PROXYCHANNEL_TIMER_FUN, TransProxyOnChanTimer) != SOFTBUS_OK) {
         DestroySoftBusList(g_proxyChannelList);
+        ConnIdTableDeinit(&g_proxyChannelIndex);
         return SOFTBUS_ERR;
     }
 
@@ -1084,9 +1148,9 @@ void TransProxyDeathCallback(const char *pkgName)
         if (strcmp(item->appInfo.myData.pkgName, pkgName) == 0) {
             TransProxyResetPeer(item);
             (void)TransProxyCloseConnChannel(item->connId);
-            ListDelete(&(item->node));
+            TransProxyUnlinkChan(item);
+            TransProxyReleaseChanCipher(item);
             SoftBusFree(item);
-            g_proxyChannelList->cnt--;
             continue;
         }
     }
@@ -24,6 +24,7 @@
 #include "softbus_json_utils.h"
 #include "softbus_log.h"
 #include "softbus_proxychannel_manager.h"
+#include "softbus_proxychannel_session.h"
 #include "softbus_proxychannel_transceiver.h"
 #include "softbus_utils.h"
 
@@ -196,6 +197,24 @@ static int32_t PackHandshakeMsgForNormal(SessionKeyBase64 *sessionBase64, AppInf
     return SOFTBUS_OK;
 }
 
+/*
+ * a peer that leaves the key out slices by PROXY_SLICE_LEN_LEGACY and takes no more. The peer's value is
+ * capped at what this end takes on chan->connId, a larger slice would not fit the link either way.
+ */
+static void UnpackPeerSliceMax(const cJSON *root, ProxyChannelInfo *chan)
+{
+    int32_t sliceMax = 0;
+    if (!GetJsonObjectNumberItem(root, JSON_KEY_MAX_SLICE_LEN, &sliceMax)) {
+        return;
+    }
+    if (sliceMax < PROXY_SLICE_LEN_MIN) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "ignore peer max slice len %d", sliceMax);
+        return;
+    }
+    uint32_t localMax = TransProxyGetRecvSliceMax(chan->connId);
+    chan->peerSliceMax = ((uint32_t)sliceMax < localMax) ? (uint32_t)sliceMax : localMax;
+}
+
 char *TransProxyPackHandshakeMsg(ProxyChannelInfo *info)
 {
     cJSON *root = 0;
@@ -213,7 +232,8 @@ char *TransProxyPackHandshakeMsg(ProxyChannelInfo *info)
         !AddStringToJsonObject(root, JSON_KEY_IDENTITY, info->identity) ||
         !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId) ||
         !AddStringToJsonObject(root, JSON_KEY_SRC_BUS_NAME, appInfo->myData.sessionName) ||
-        !AddStringToJsonObject(root, JSON_KEY_DST_BUS_NAME, appInfo->peerData.sessionName)) {
+        !AddStringToJsonObject(root, JSON_KEY_DST_BUS_NAME, appInfo->peerData.sessionName) ||
+        !AddNumberToJsonObject(root, JSON_KEY_MAX_SLICE_LEN, (int32_t)TransProxyGetRecvSliceMax(info->connId))) {
         cJSON_Delete(root);
         return NULL;
     }
@@ -266,7 +286,8 @@ char *TransProxyPackHandshakeAckMsg(ProxyChannelInfo *chan)
     }
 
     if (!AddStringToJsonObject(root, JSON_KEY_IDENTITY, chan->identity) ||
-        !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId)) {
+        !AddStringToJsonObject(root, JSON_KEY_DEVICE_ID, appInfo->myData.deviceId) ||
+        !AddNumberToJsonObject(root, JSON_KEY_MAX_SLICE_LEN, (int32_t)TransProxyGetRecvSliceMax(chan->connId))) {
         cJSON_Delete(root);
         return NULL;
     }
@@ -312,6 +333,7 @@ int32_t TransProxyUnpackHandshakeAckMsg(const char *msg, ProxyChannelInfo *chanI
                                  sizeof(appInfo->peerData.pkgName))) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "no item to get pkg name");
     }
+    UnpackPeerSliceMax(root, chanInfo);
     cJSON_Delete(root);
     return SOFTBUS_OK;
 }
@@ -359,6 +381,7 @@ int32_t TransProxyUnpackHandshakeMsg(const char *msg, ProxyChannelInfo *chan)
         return SOFTBUS_ERR;
     }
     appInfo->appType = (AppType)appType;
+    UnpackPeerSliceMax(root, chan);
 
     if (appInfo->appType == APP_TYPE_NORMAL) {
         int32_t ret = UnpackHandshakeMsgForNormal(root, appInfo, sessionKey, BASE64KEY);
@@ -27,6 +27,7 @@
 #include "softbus_proxychannel_manager.h"
 #include "softbus_proxychannel_transceiver.h"
 #include "softbus_tcp_socket.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_transmission_interface.h"
 #include "softbus_utils.h"
 #include "trans_pending_pkt.h"
@@ -37,6 +38,9 @@
 #define USECTONSEC 1000
 #define PACK_HEAD_LEN (sizeof(PacketHead))
 #define DATA_HEAD_SIZE (4 * 1024)  // donot knoe bytes 1024 or message (4 * 1024)
+#define SLICE_BITS_PER_WORD 32
+#define SLICE_MEM_MAX (1024 * 1024) // reassembly buffers of all channels together
+#define SLICE_PACKET_TIMEOUT 10  //  10s
 
 typedef struct {
     unsigned char *inData;
@@ -60,6 +64,7 @@ typedef struct  {
 } PacketHead;
 
 static SoftBusList *g_channelSliceProcessorList = NULL;
+static uint32_t g_sliceMemUsed = 0; // guarded by g_channelSliceProcessorList->lock
 int32_t TransProxyTransDataSendMsg(int32_t channelId, const char *payLoad, int payLoadLen, ProxyPacketType flag);
 
 int32_t NotifyClientMsgReceived(const char *pkgName, int32_t channelId, const char *data, uint32_t len,
@@ -113,23 +118,18 @@ SendPriority ProxyTypeToConnPri(ProxyPacketType proxyType)
 
 static int32_t TransProxyEncryptPacketData(int32_t channelId, int32_t seq, ProxyDataInfo *dataInfo)
 {
-    char sessionKey[SESSION_KEY_LENGTH] = {0};
-    AesGcmCipherKey cipherKey = {0};
     uint32_t checkLen;
 
-    if (TransProxyGetSessionKeyByChanId(channelId, sessionKey, sizeof(sessionKey)) != SOFTBUS_OK) {
+    SoftBusCipherCtx *cipherCtx = TransProxyGetCipherCtxByChanId(channelId);
+    if (cipherCtx == NULL) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId(%d) session key err", channelId);
         return SOFTBUS_ERR;
     }
 
     checkLen = dataInfo->inLen + OVERHEAD_LEN;
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s key error.");
-        return SOFTBUS_ERR;
-    }
-    int32_t ret = SoftBusEncryptDataWithSeq(&cipherKey, dataInfo->inData, dataInfo->inLen,
-        dataInfo->outData, &(dataInfo->outLen), seq);
+    int32_t ret = SoftBusCipherCtxSeal(cipherCtx, seq, dataInfo->inData, dataInfo->inLen,
+        dataInfo->outData, &(dataInfo->outLen));
+    SoftBusReleaseCipherCtx(cipherCtx);
     if (ret != SOFTBUS_OK || dataInfo->outLen != checkLen) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Trans Proxy encrypt error. %d ", ret);
         return SOFTBUS_ENCRYPT_ERR;
@@ -139,23 +139,15 @@ static int32_t TransProxyEncryptPacketData(int32_t channelId, int32_t seq, Proxy
 
 static int32_t TransProxyDecryptPacketData(int32_t channelId, int32_t seq, ProxyDataInfo *dataInfo)
 {
-    char sessionKey[SESSION_KEY_LENGTH] = {0};
-    AesGcmCipherKey cipherKey = {0};
-    int ret;
-
-    if (TransProxyGetSessionKeyByChanId(channelId, sessionKey, sizeof(sessionKey)) != SOFTBUS_OK) {
+    (void)seq;
+    SoftBusCipherCtx *cipherCtx = TransProxyGetCipherCtxByChanId(channelId);
+    if (cipherCtx == NULL) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "DecryptPacket get chan fail channid %d.", channelId);
         return SOFTBUS_ERR;
     }
-    cipherKey.keyLen = SESSION_KEY_LENGTH; // 256 bit encryption
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
-        return SOFTBUS_ERR;
-    }
-    (void)memset_s(sessionKey, sizeof(sessionKey), 0, sizeof(sessionKey));
-    ret = SoftBusDecryptDataWithSeq(&cipherKey, dataInfo->inData, dataInfo->inLen,
-        dataInfo->outData, &(dataInfo->outLen), seq);
-    (void)memset_s(&cipherKey, sizeof(AesGcmCipherKey), 0, sizeof(AesGcmCipherKey));
+    int32_t ret = SoftBusCipherCtxOpen(cipherCtx, dataInfo->inData, dataInfo->inLen,
+        dataInfo->outData, &(dataInfo->outLen));
+    SoftBusReleaseCipherCtx(cipherCtx);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans proxy Decrypt Data fail. %d ", ret);
         return SOFTBUS_ERR;
@@ -233,14 +225,19 @@ static int32_t TransProxyTransDataSendSyncMsg(int32_t channelId, const char *pay
 {
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "send syncmsg chanid[%d] seq[%d] dataLen[%d] type[%d]",
         channelId, seq, payLoadLen, flag);
-    int32_t ret = TransProxyTransDataSendMsg(channelId, payLoad, payLoadLen, flag);
+    /*
+     * registered before sending so an ack can never beat it. The call returns once the message is queued,
+     * a missing ack closes the channel from TransProxyOnPendingComplete.
+     */
+    int32_t ret = AddPendingPacket(channelId, seq, PENDING_TYPE_PROXY);
     if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxyTransDataSendSyncMsg err,ret :%d", ret);
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "proxy add pending fail.[%d]", ret);
         return ret;
     }
-    ret = ProcPendingPacket(channelId, seq, PENDING_TYPE_PROXY);
+    ret = TransProxyTransDataSendMsg(channelId, payLoad, payLoadLen, flag);
     if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "proxy send sync msg fail.[%d]", ret);
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxyTransDataSendSyncMsg err,ret :%d", ret);
+        (void)CancelPendingPacket(channelId, seq, PENDING_TYPE_PROXY, ret);
     }
     return ret;
 }
@@ -280,47 +277,41 @@ int32_t TransProxyPostSessionData(int32_t channelId, const unsigned char *data,
     ProxyPacketType type = SessionTypeToPacketType(flags);
     return TransProxyPostPacketData(channelId, data, len, type);
 }
-static int32_t TransProxyGetBufLen(void)
+static uint32_t TransProxySliceMaxLen(int32_t priority)
 {
-#define MAX_SEND_LENGTH 1024
-    return MAX_SEND_LENGTH;
+    uint32_t maxDataLen = (priority == PROXY_CHANNEL_PRORITY_MESSAGE) ?
+        PROXY_MESSAGE_LENGTH_MAX : PROXY_BYTES_LENGTH_MAX;
+    return maxDataLen + DATA_HEAD_SIZE + OVERHEAD_LEN;
 }
 
-static char *TransProxyPackAppNormalMsg(const ProxyMessageHead *msg, const SliceHead *sliceHead, const char *payLoad,
-    int32_t datalen, int32_t *outlen)
+uint32_t TransProxyGetRecvSliceMax(uint32_t connId)
 {
-    char *buf = NULL;
-    int bufLen;
-    int connHeadLen;
-    int dstLen;
-
-    connHeadLen = ConnGetHeadSize();
-    bufLen = PROXY_CHANNEL_HEAD_LEN + connHeadLen + sizeof(SliceHead) + datalen;
-    buf = (char*)SoftBusCalloc(bufLen);
-    if (buf == NULL) {
-        return NULL;
+    ConnLinkLimit limit = {0};
+    uint32_t overhead = ConnGetHeadSize() + MSG_SLICE_HEAD_LEN;
+    if (ConnGetLinkLimit(connId, &limit) != SOFTBUS_OK || limit.recvMax < overhead + PROXY_SLICE_LEN_MIN) {
+        return PROXY_SLICE_LEN_LEGACY;
     }
+    uint32_t sliceMax = limit.recvMax - overhead;
+    uint32_t msgMax = TransProxySliceMaxLen(PROXY_CHANNEL_PRORITY_BYTES);
+    return (sliceMax < msgMax) ? sliceMax : msgMax;
+}
 
-    if (memcpy_s(buf + connHeadLen, bufLen - connHeadLen, msg, sizeof(ProxyMessageHead)) != EOK) {
-        SoftBusFree(buf);
-        return NULL;
-    }
-    dstLen = bufLen - connHeadLen - sizeof(ProxyMessageHead);
-    if (memcpy_s(buf + connHeadLen + sizeof(ProxyMessageHead), dstLen, sliceHead, sizeof(SliceHead)) != EOK) {
-        SoftBusFree(buf);
-        return NULL;
+/* as long as the peer takes, cut down to one link write on links that split packets */
+static int32_t TransProxyGetSliceLen(const ProxyChannelDataView *info)
+{
+    uint32_t sliceLen = (info->peerSliceMax != 0) ? info->peerSliceMax : PROXY_SLICE_LEN_LEGACY;
+    ConnLinkLimit limit = {0};
+    if (ConnGetLinkLimit(info->connId, &limit) != SOFTBUS_OK) {
+        return (int32_t)((sliceLen < PROXY_SLICE_LEN_LEGACY) ? sliceLen : PROXY_SLICE_LEN_LEGACY);
     }
-    dstLen = bufLen - connHeadLen - MSG_SLICE_HEAD_LEN;
-    if (memcpy_s(buf + connHeadLen + MSG_SLICE_HEAD_LEN, dstLen, payLoad, datalen) != EOK) {
-        SoftBusFree(buf);
-        return NULL;
+    uint32_t overhead = ConnGetHeadSize() + MSG_SLICE_HEAD_LEN;
+    if (limit.sendUnit >= overhead + PROXY_SLICE_LEN_MIN && limit.sendUnit - overhead < sliceLen) {
+        sliceLen = limit.sendUnit - overhead;
     }
-
-    *outlen = bufLen;
-    return buf;
+    return (int32_t)sliceLen;
 }
 
-static int32_t TransProxyTransAppNormalMsg(const ProxyChannelInfo *info, const char *payLoad, int payLoadLen,
+static int32_t TransProxyTransAppNormalMsg(const ProxyChannelDataView *info, const char *payLoad, int payLoadLen,
     ProxyPacketType flag)
 {
     int32_t dataLen;
@@ -328,40 +319,56 @@ static int32_t TransProxyTransAppNormalMsg(const ProxyChannelInfo *info, const c
     int32_t singleLen;
     int32_t sliceNum;
 
-    singleLen = TransProxyGetBufLen();
+    singleLen = TransProxyGetSliceLen(info);
     if (singleLen <= 0) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "getBuflen msg error");
         return SOFTBUS_ERR;
     }
     sliceNum = (payLoadLen + singleLen - 1) / singleLen;
+    if (sliceNum > SLICE_NUM_MAX) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "len %d needs %d slices of %d", payLoadLen, sliceNum,
+            singleLen);
+        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_EXCEED_LENGTH;
+    }
+    /* refuse up front rather than leave the peer with a message that misses its tail slices */
+    uint32_t window = 0;
+    uint32_t needLen = (uint32_t)payLoadLen + (uint32_t)sliceNum * (MSG_SLICE_HEAD_LEN + ConnGetHeadSize());
+    if (ConnGetSendWindow(info->connId, &window) == SOFTBUS_OK && window < needLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "send window %u short of %u", window, needLen);
+        return SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL;
+    }
     ProxyMessageHead msgHead = {0};
     msgHead.type = (PROXYCHANNEL_MSG_TYPE_NORMAL & FOUR_BIT_MASK) | (VERSION << VERSION_SHIFT);
     msgHead.myId = info->myId;
     msgHead.peerId = info->peerId;
+    /* the packet seq tags every slice so the peer can reassemble several messages of one priority at once */
+    int32_t msgId = (payLoadLen >= (int)sizeof(PacketHead)) ? ((const PacketHead *)payLoad)->seq : 0;
     for (int i = 0; i < sliceNum; i++) {
-        char *buf = NULL;
-        int bufLen = 0;
         SliceHead slicehead = {0};
         slicehead.priority = ProxyTypeToProxyIndex(flag);
         slicehead.sliceNum = sliceNum;
         slicehead.sliceSeq = i;
+        slicehead.reserved = msgId;
         if (sliceNum > 1) {
-            dataLen = (i == (sliceNum - 1)) ? (payLoadLen - i * MAX_SEND_LENGTH) : MAX_SEND_LENGTH;
-            offset = i * MAX_SEND_LENGTH;
+            dataLen = (i == (sliceNum - 1)) ? (payLoadLen - i * singleLen) : singleLen;
+            offset = i * singleLen;
         } else {
             dataLen = payLoadLen;
             offset = 0;
         }
 
-        buf = TransProxyPackAppNormalMsg(&msgHead, &slicehead, payLoad + offset, dataLen, &bufLen);
-        if (buf == NULL) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
-            return SOFTBUS_TRANS_PROXY_PACKMSG_ERR;
-        }
+        /* the slice goes out as proxy head, slice head and a window into payLoad, nothing is flattened here */
+        ConnIoVec iov[] = {
+            { (const char *)&msgHead, sizeof(ProxyMessageHead) },
+            { (const char *)&slicehead, sizeof(SliceHead) },
+            { payLoad + offset, dataLen },
+        };
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "slice: i:%d", i);
-        if (TransProxyTransSendMsg(info->connId, buf, bufLen, ProxyTypeToConnPri(flag)) != SOFTBUS_OK) {
+        int32_t ret = TransProxyTransSendMsgVec(info->connId, iov, sizeof(iov) / sizeof(iov[0]),
+            ProxyTypeToConnPri(flag));
+        if (ret != SOFTBUS_OK) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
-            return SOFTBUS_TRANS_PROXY_SENDMSG_ERR;
+            return (ret == SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL) ? ret : SOFTBUS_TRANS_PROXY_SENDMSG_ERR;
         }
     }
     return SOFTBUS_OK;
@@ -383,30 +390,21 @@ int32_t TransProxyTransNetWorkMsg(ProxyMessageHead *msghead, const ProxyChannelI
 
 int32_t TransProxyTransDataSendMsg(int32_t channelId, const char *payLoad, int payLoadLen, ProxyPacketType flag)
 {
-    int ret = SOFTBUS_OK;
-    ProxyChannelInfo *info = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
-    if (info == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc fail when trans proxy trans data");
-        return SOFTBUS_MALLOC_ERR;
-    }
-    if (TransProxyGetSendMsgChanInfo(channelId, info) != SOFTBUS_OK) {
+    ProxyChannelDataView chan;
+
+    if (TransProxyGetSendMsgChanInfo(channelId, &chan) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channelId err %d", channelId);
-        ret = SOFTBUS_TRANS_PROXY_SEND_CHANNELID_INVALID;
-        goto EXIT;
+        return SOFTBUS_TRANS_PROXY_SEND_CHANNELID_INVALID;
     }
 
-    if ((info->status != PROXY_CHANNEL_STATUS_COMPLETED && info->status != PROXY_CHANNEL_STATUS_KEEPLIVEING)) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", info->status);
-        ret = SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
-        goto EXIT;
+    if ((chan.status != PROXY_CHANNEL_STATUS_COMPLETED && chan.status != PROXY_CHANNEL_STATUS_KEEPLIVEING)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "status is err %d", chan.status);
+        return SOFTBUS_TRANS_PROXY_CHANNLE_STATUS_INVALID;
     }
-    ret = TransProxyTransAppNormalMsg(info, payLoad, payLoadLen, flag);
+    int32_t ret = TransProxyTransAppNormalMsg(&chan, payLoad, payLoadLen, flag);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "pack msg error");
-        goto EXIT;
     }
-EXIT:
-    SoftBusFree(info);
     return ret;
 }
 
@@ -512,16 +510,21 @@ static int32_t TransProxyProcessSessionData(const char *pkgName, int32_t channel
     return SOFTBUS_OK;
 }
 
+/* dataLen comes from the peer, it must fit in what actually arrived behind the head */
 static int32_t TransProxyNoSubPacketProc(const char *pkgName, int32_t channelId, const char *data, uint32_t len)
 {
+    if (len < sizeof(PacketHead)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "packet len %u shorter than its head", len);
+        return SOFTBUS_TRANS_INVALID_DATA_LENGTH;
+    }
     PacketHead *head = (PacketHead*)data;
     if ((uint32_t)head->magicNumber != MAGIC_NUMBER) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid magicNumber %x", head->magicNumber);
         return SOFTBUS_ERR;
     }
-    if (head->dataLen <= 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid dataLen %d", head->dataLen);
-        return SOFTBUS_ERR;
+    if (head->dataLen <= 0 || (uint32_t)head->dataLen > len - sizeof(PacketHead)) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid dataLen %d, packet len %u", head->dataLen, len);
+        return SOFTBUS_TRANS_INVALID_DATA_LENGTH;
     }
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "NoSubPacketProc dataLen[%d] inputLen[%d]", head->dataLen,  len);
     int32_t ret = TransProxyProcessSessionData(pkgName, channelId, head, data + sizeof(PacketHead));
@@ -542,7 +545,8 @@ static int32_t TransProxyCheckSliceHead(const SliceHead *head)
         return SOFTBUS_ERR;
     }
 
-    if (head->sliceNum != 1 && head->sliceSeq >= head->sliceNum) {
+    if (head->sliceNum < 1 || head->sliceNum > SLICE_NUM_MAX ||
+        (head->sliceNum != 1 && (head->sliceSeq < 0 || head->sliceSeq >= head->sliceNum))) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "sliceNum %d sliceSeq %d", head->sliceNum, head->sliceSeq);
         return SOFTBUS_ERR;
     }
@@ -572,108 +576,143 @@ static ChannelSliceProcessor *TransProxyGetChannelSliceProcessor(int32_t channel
     return node;
 }
 
-static void TransProxyClearProcessor(SliceProcessor *processor)
+static char *TransProxySliceMemAlloc(uint32_t len)
 {
-    if (processor->data != NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "slice processor data not null");
-        SoftBusFree(processor->data);
-        processor->data = NULL;
+    if (len > SLICE_MEM_MAX - g_sliceMemUsed) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "slice memory used %u, refuse %u more", g_sliceMemUsed, len);
+        return NULL;
     }
-    processor->active = false;
-    processor->bufLen = 0;
-    processor->dataLen = 0;
-    processor->expectedSeq = 0;
-    processor->sliceNumber = 0;
-    processor->timeout = 0;
+    char *buf = (char *)SoftBusMalloc(len);
+    if (buf != NULL) {
+        g_sliceMemUsed += len;
+    }
+    return buf;
 }
 
-static int32_t TransProxyFirstSliceProcess(SliceProcessor *processor, const SliceHead *head,
-    const char *data, uint32_t len)
+static void TransProxySliceMemFree(char *buf, uint32_t len)
 {
-    TransProxyClearProcessor(processor);
-
-    uint32_t maxDataLen = (head->priority == PROXY_CHANNEL_PRORITY_MESSAGE) ?
-        PROXY_MESSAGE_LENGTH_MAX : PROXY_BYTES_LENGTH_MAX;
-    uint32_t maxLen = maxDataLen + DATA_HEAD_SIZE + OVERHEAD_LEN;
-    processor->data = (char *)SoftBusCalloc(maxLen);
-    if (processor->data == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc fail when proc first slice package");
-        return SOFTBUS_MALLOC_ERR;
-    }
-    processor->bufLen = maxLen;
-    if (memcpy_s(processor->data, maxLen, data, len) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy fail hen proc first slice package");
-        return SOFTBUS_SLICE_ERROR;
+    if (buf != NULL) {
+        g_sliceMemUsed -= len;
+        SoftBusFree(buf);
     }
-    processor->sliceNumber = head->sliceNum;
-    processor->expectedSeq = 1;
-    processor->dataLen = len;
-    processor->active = true;
-    processor->timeout = 0;
+}
 
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "FirstSliceProcess ok");
-    return SOFTBUS_OK;
+static void TransProxyClearProcessor(SliceProcessor *processor)
+{
+    TransProxySliceMemFree(processor->data, (uint32_t)processor->bufLen);
+    TransProxySliceMemFree(processor->tail, (uint32_t)processor->tailLen);
+    (void)memset_s(processor, sizeof(SliceProcessor), 0, sizeof(SliceProcessor));
 }
 
-static int32_t TransProxySliceProcessChkPkgIsValid(const SliceProcessor *processor, const SliceHead *head,
-    const char *data, uint32_t len)
+/* the slot reassembling head's message, a free or the stalest slot of the lane when it is a new one */
+static SliceProcessor *TransProxyGetSliceProcessor(SliceProcessor *lane, const SliceHead *head)
 {
-    if (head->sliceNum != processor->sliceNumber ||
-        head->sliceSeq != processor->expectedSeq) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "unmatched normal slice received");
-        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_NO_INVALID;
+    SliceProcessor *processor = NULL;
+    for (int32_t i = 0; i < SLICE_LANE_MSG_MAX; i++) {
+        processor = &lane[i];
+        if (!processor->active || processor->msgId != head->reserved) {
+            continue;
+        }
+        /* a peer without message ids reuses 0, a clash means the previous message lost a slice */
+        uint32_t bit = 1U << ((uint32_t)head->sliceSeq % SLICE_BITS_PER_WORD);
+        if (processor->sliceNumber == head->sliceNum &&
+            (processor->bitmap[head->sliceSeq / SLICE_BITS_PER_WORD] & bit) == 0) {
+            return processor;
+        }
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "msg %d restarts, %d/%d slices dropped",
+            processor->msgId, processor->recvNumber, processor->sliceNumber);
+        TransProxyClearProcessor(processor);
+        break;
     }
-    if ((int32_t)len + processor->dataLen > processor->bufLen) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "data len invalid");
-        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_EXCEED_LENGTH;
+
+    SliceProcessor *oldest = NULL;
+    processor = NULL;
+    for (int32_t i = 0; i < SLICE_LANE_MSG_MAX; i++) {
+        if (!lane[i].active) {
+            processor = &lane[i];
+            break;
+        }
+        uint32_t idle = TimerWheelNow() - lane[i].lastActive;
+        oldest = (oldest == NULL || idle > TimerWheelNow() - oldest->lastActive) ? &lane[i] : oldest;
     }
-    if (processor->data == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "data NULL");
-        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_DATA_NULL;
+    if (processor == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lane full, drop msg %d", oldest->msgId);
+        TransProxyClearProcessor(oldest);
+        processor = oldest;
     }
-    return SOFTBUS_OK;
+    processor->active = true;
+    processor->msgId = head->reserved;
+    processor->sliceNumber = head->sliceNum;
+    return processor;
 }
 
-static int32_t TransProxyNormalSliceProcess(SliceProcessor *processor, const SliceHead *head,
-    const char *data, uint32_t len)
+/* the buffer is sized once the first full slice tells the slice length */
+static int32_t TransProxySliceAllocData(SliceProcessor *processor, int32_t priority, int32_t sliceLen)
 {
-    int32_t ret = TransProxySliceProcessChkPkgIsValid(processor, head, data, len);
-    if (ret != SOFTBUS_OK) {
-        return ret;
+    uint32_t maxLen = TransProxySliceMaxLen(priority);
+    uint32_t bufLen = (uint32_t)sliceLen * (uint32_t)processor->sliceNumber;
+    if (bufLen - (uint32_t)sliceLen >= maxLen) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "%d slices of %d exceed %u", processor->sliceNumber,
+            sliceLen, maxLen);
+        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_EXCEED_LENGTH;
     }
-    if (memcpy_s(processor->data + processor->dataLen, processor->bufLen - processor->dataLen, data, len) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy fail when proc normal slice");
-        return SOFTBUS_MEM_ERR;
+    processor->data = TransProxySliceMemAlloc(bufLen);
+    if (processor->data == NULL) {
+        return SOFTBUS_MALLOC_ERR;
     }
-    processor->expectedSeq++;
-    processor->dataLen += len;
-    processor->timeout = 0;
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "NormalSliceProcess ok");
-    return ret;
+    processor->bufLen = (int32_t)bufLen;
+    processor->sliceLen = sliceLen;
+    if (processor->tail == NULL) {
+        return SOFTBUS_OK;
+    }
+    if (processor->tailLen > sliceLen) {
+        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_EXCEED_LENGTH;
+    }
+    int32_t offset = (processor->sliceNumber - 1) * sliceLen;
+    (void)memcpy_s(processor->data + offset, processor->bufLen - offset, processor->tail, processor->tailLen);
+    TransProxySliceMemFree(processor->tail, (uint32_t)processor->tailLen);
+    processor->tail = NULL;
+    processor->tailLen = 0;
+    return SOFTBUS_OK;
 }
 
-static int32_t TransProxyLastSliceProcess(SliceProcessor *processor, const SliceHead *head,
-    const char *data, uint32_t len, const char *pkgName, int32_t channelId)
+static int32_t TransProxySliceStore(SliceProcessor *processor, const SliceHead *head, const char *data, uint32_t len)
 {
-    int32_t ret = TransProxySliceProcessChkPkgIsValid(processor, head, data, len);
-    if (ret == SOFTBUS_OK) {
-        return ret;
+    bool isLast = (head->sliceSeq == head->sliceNum - 1);
+    if (len == 0 || len > TransProxySliceMaxLen(head->priority)) {
+        return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_EXCEED_LENGTH;
     }
-    if (memcpy_s(processor->data + processor->dataLen, processor->bufLen - processor->dataLen, data, len) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy fail when proc last slice");
-        return SOFTBUS_MEM_ERR;
+    if (!isLast && processor->sliceLen == 0) {
+        int32_t ret = TransProxySliceAllocData(processor, head->priority, (int32_t)len);
+        if (ret != SOFTBUS_OK) {
+            return ret;
+        }
     }
-    processor->expectedSeq++;
-    processor->dataLen += len;
-
-    ret = TransProxyNoSubPacketProc(pkgName, channelId, processor->data, processor->dataLen);
-    if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "process packets err");
-        return ret;
+    if (processor->sliceLen == 0) {
+        /* only the last slice so far, park it until a full one tells where it goes */
+        processor->tail = TransProxySliceMemAlloc(len);
+        if (processor->tail == NULL) {
+            return SOFTBUS_MALLOC_ERR;
+        }
+        processor->tailLen = (int32_t)len;
+        (void)memcpy_s(processor->tail, len, data, len);
+    } else {
+        if ((isLast && (int32_t)len > processor->sliceLen) || (!isLast && (int32_t)len != processor->sliceLen)) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "slice %d len %u, expect %d", head->sliceSeq, len,
+                processor->sliceLen);
+            return SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_NO_INVALID;
+        }
+        int32_t offset = head->sliceSeq * processor->sliceLen;
+        if (memcpy_s(processor->data + offset, processor->bufLen - offset, data, len) != EOK) {
+            return SOFTBUS_MEM_ERR;
+        }
     }
-    TransProxyClearProcessor(processor);
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "LastSliceProcess ok");
-    return ret;
+    uint32_t bit = 1U << ((uint32_t)head->sliceSeq % SLICE_BITS_PER_WORD);
+    processor->bitmap[head->sliceSeq / SLICE_BITS_PER_WORD] |= bit;
+    processor->recvNumber++;
+    processor->dataLen += (int32_t)len;
+    processor->lastActive = TimerWheelNow();
+    return SOFTBUS_OK;
 }
 
 static int TransProxySubPacketProc(const char *pkgName, int32_t channelId, const SliceHead *head,
@@ -697,22 +736,39 @@ static int TransProxySubPacketProc(const char *pkgName, int32_t channelId, const
         return SOFTBUS_ERR;
     }
 
-    int ret;
-    int32_t index = head->priority;
-    SliceProcessor *processor = &(channelProcessor->processor[index]);
-    if (head->sliceSeq == 0) {
-        ret = TransProxyFirstSliceProcess(processor, head, data, len);
-    } else if (head->sliceNum == head->sliceSeq + 1) {
-        ret = TransProxyLastSliceProcess(processor, head, data, len, pkgName, channelId);
-    } else {
-        ret = TransProxyNormalSliceProcess(processor, head, data, len);
+    SliceProcessor *processor = TransProxyGetSliceProcessor(channelProcessor->processor[head->priority], head);
+    int32_t ret = TransProxySliceStore(processor, head, data, len);
+    if (ret != SOFTBUS_OK || processor->recvNumber < processor->sliceNumber) {
+        if (ret != SOFTBUS_OK) {
+            TransProxyClearProcessor(processor);
+        } else if (!channelProcessor->timerArmed) {
+            /* one timer per channel, it re-arms itself while any of its messages is still incomplete */
+            channelProcessor->timerArmed =
+                (TimerWheelArm(SOFTBUS_PROXYSLICE_TIMER_FUN, (uint32_t)channelId, SLICE_PACKET_TIMEOUT) == SOFTBUS_OK);
+        }
+        pthread_mutex_unlock(&g_channelSliceProcessorList->lock);
+        return ret;
     }
-
+    /* complete, the message is handed up outside the lock and its buffer given back after */
+    char *msg = processor->data;
+    int32_t msgLen = processor->dataLen;
+    int32_t bufLen = processor->bufLen;
+    processor->data = NULL;
+    processor->bufLen = 0;
+    TransProxyClearProcessor(processor);
     pthread_mutex_unlock(&g_channelSliceProcessorList->lock);
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "Proxy SubPacket Proc end");
+
+    ret = TransProxyNoSubPacketProc(pkgName, channelId, msg, (uint32_t)msgLen);
     if (ret != SOFTBUS_OK) {
-        TransProxyClearProcessor(processor);
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "process packets err");
     }
+    if (pthread_mutex_lock(&g_channelSliceProcessorList->lock) == 0) {
+        TransProxySliceMemFree(msg, (uint32_t)bufLen);
+        pthread_mutex_unlock(&g_channelSliceProcessorList->lock);
+    } else {
+        SoftBusFree(msg);
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "Proxy SubPacket Proc end");
     return ret;
 }
 #define SLICE_HEAD_LEN (sizeof(PacketHead) + sizeof(SliceHead))
@@ -758,8 +814,11 @@ int32_t TransProxyDelSliceProcessorByChannelId(int32_t channelId)
     LIST_FOR_EACH_ENTRY_SAFE(node, next, &g_channelSliceProcessorList->list, ChannelSliceProcessor, head) {
         if (node->channelId == channelId) {
             for (int i = PROXY_CHANNEL_PRORITY_MESSAGE; i < PROXY_CHANNEL_PRORITY_BUTT; i++) {
-                TransProxyClearProcessor(&(node->processor[i]));
+                for (int j = 0; j < SLICE_LANE_MSG_MAX; j++) {
+                    TransProxyClearProcessor(&(node->processor[i][j]));
+                }
             }
+            TimerWheelCancel(SOFTBUS_PROXYSLICE_TIMER_FUN, (uint32_t)channelId);
             ListDelete(&(node->head));
             SoftBusFree(node);
             g_channelSliceProcessorList->cnt--;
@@ -771,33 +830,50 @@ int32_t TransProxyDelSliceProcessorByChannelId(int32_t channelId)
     return SOFTBUS_OK;
 }
 
-static void TransProxySliceTimerProc(void)
+/* drops the messages of the channel that stalled and returns how long until the next one may, 0 if none */
+static uint32_t TransProxyExpireSlices(ChannelSliceProcessor *channelProcessor)
 {
-#define SLICE_PACKET_TIMEOUT 10  //  10s
-    ChannelSliceProcessor *removeNode = NULL;
-    ChannelSliceProcessor *nextNode = NULL;
+    uint32_t next = 0;
+    for (int i = PROXY_CHANNEL_PRORITY_MESSAGE; i < PROXY_CHANNEL_PRORITY_BUTT; i++) {
+        for (int j = 0; j < SLICE_LANE_MSG_MAX; j++) {
+            SliceProcessor *processor = &(channelProcessor->processor[i][j]);
+            if (processor->active != true) {
+                continue;
+            }
+            uint32_t idle = TimerWheelNow() - processor->lastActive;
+            if (idle >= SLICE_PACKET_TIMEOUT) {
+                SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "drop msg %d, %d/%d slices",
+                    processor->msgId, processor->recvNumber, processor->sliceNumber);
+                TransProxyClearProcessor(processor);
+            } else if (next == 0 || SLICE_PACKET_TIMEOUT - idle < next) {
+                next = SLICE_PACKET_TIMEOUT - idle;
+            }
+        }
+    }
+    return next;
+}
 
-    if (g_channelSliceProcessorList == 0 || g_channelSliceProcessorList->cnt == 0) {
+static void TransProxyOnSliceTimer(uint32_t key)
+{
+    ChannelSliceProcessor *channelProcessor = NULL;
+
+    if (g_channelSliceProcessorList == NULL) {
         return;
     }
-
     if (pthread_mutex_lock(&g_channelSliceProcessorList->lock) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxySliceTimerProc lock mutex fail!");
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "TransProxyOnSliceTimer lock mutex fail!");
         return;
     }
-
-    LIST_FOR_EACH_ENTRY_SAFE(removeNode, nextNode, &g_channelSliceProcessorList->list, ChannelSliceProcessor, head) {
-        for (int i = PROXY_CHANNEL_PRORITY_MESSAGE; i < PROXY_CHANNEL_PRORITY_BUTT; i++) {
-            if (removeNode->processor[i].active == true) {
-                removeNode->processor[i].timeout++;
-                if (removeNode->processor[i].timeout >= SLICE_PACKET_TIMEOUT) {
-                    TransProxyClearProcessor(&removeNode->processor[i]);
-                }
-            }
+    LIST_FOR_EACH_ENTRY(channelProcessor, &g_channelSliceProcessorList->list, ChannelSliceProcessor, head) {
+        if (channelProcessor->channelId != (int32_t)key) {
+            continue;
         }
+        uint32_t next = TransProxyExpireSlices(channelProcessor);
+        channelProcessor->timerArmed =
+            (next != 0 && TimerWheelArm(SOFTBUS_PROXYSLICE_TIMER_FUN, key, next) == SOFTBUS_OK);
+        break;
     }
     (void)pthread_mutex_unlock(&g_channelSliceProcessorList->lock);
-    return;
 }
 
 int32_t TransSliceManagerInit(void)
@@ -806,7 +882,7 @@ int32_t TransSliceManagerInit(void)
     if (g_channelSliceProcessorList == NULL) {
         return SOFTBUS_ERR;
     }
-    if (RegisterTimeoutCallback(SOFTBUS_PROXYSLICE_TIMER_FUN, (void *)TransProxySliceTimerProc) != SOFTBUS_OK) {
+    if (TimerWheelRegister(SOFTBUS_PROXYSLICE_TIMER_FUN, TransProxyOnSliceTimer) != SOFTBUS_OK) {
         DestroySoftBusList(g_channelSliceProcessorList);
         return SOFTBUS_ERR;
     }
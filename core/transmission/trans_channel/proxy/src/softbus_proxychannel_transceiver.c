@@ -211,14 +211,14 @@ void TransProxyFreeLoopMsg(SoftBusMessage *msg)
     if (msg != NULL) {
         if (msg->obj != NULL) {
             SoftBusFree(msg->obj);
+            msg->obj = NULL;
         }
-        SoftBusFree((void *)msg);
     }
 }
 static SoftBusMessage *TransProxyCreateLoopMsg(int32_t what, uint64_t arg1, uint64_t arg2, char *data)
 {
     SoftBusMessage *msg = NULL;
-    msg = SoftBusCalloc(sizeof(SoftBusMessage));
+    msg = MallocMessage();
     if (msg == NULL) {
         return NULL;
     }
@@ -345,14 +345,15 @@ int32_t TransProxyGetConnectOption(uint32_t connectionId, ConnectOption *info)
     return SOFTBUS_OK;
 }
 
+static uint64_t g_proxySendSeq = 1;
+
 int32_t TransProxyTransSendMsg(uint32_t connectionId, char *buf, int32_t len, int32_t priority)
 {
     ConnPostData data = {0};
-    static uint64_t seq = 1;
     int32_t ret;
 
     data.module = MODULE_PROXY_CHANNEL;
-    data.seq = seq++;
+    data.seq = g_proxySendSeq++;
     data.flag = priority;
     data.len = len;
     data.buf = buf;
@@ -366,6 +367,24 @@ int32_t TransProxyTransSendMsg(uint32_t connectionId, char *buf, int32_t len, in
     return SOFTBUS_OK;
 }
 
+int32_t TransProxyTransSendMsgVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t priority)
+{
+    ConnPostVecData data = {0};
+    int32_t ret;
+
+    data.module = MODULE_PROXY_CHANNEL;
+    data.seq = g_proxySendSeq++;
+    data.flag = priority;
+    data.iov = iov;
+    data.iovCnt = iovCnt;
+    ret = ConnPostBytesVec(connectionId, &data);
+    if (ret < 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "conn send iov fail %d", ret);
+        return ret;
+    }
+    return SOFTBUS_OK;
+}
+
 static void TransProxyOnConnected(uint32_t connId, const ConnectionInfo *connInfo)
 {
     (void)connInfo;
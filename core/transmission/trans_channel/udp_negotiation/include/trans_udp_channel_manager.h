@@ -29,7 +29,6 @@ typedef struct {
     ListNode node;
     int64_t seq;
     AppInfo info;
-    uint32_t timeOut;
     UdpChannelStatus status;
 } UdpChannelInfo;
 
@@ -22,6 +22,7 @@
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_utils.h"
 #include "trans_udp_negotiation.h"
 
@@ -29,7 +30,7 @@
 
 static SoftBusList *g_udpChannelMgr = NULL;
 
-static void TransUdpTimerProc(void)
+static void TransUdpOnChannelTimer(uint32_t key)
 {
     if (g_udpChannelMgr == NULL) {
         return;
@@ -39,13 +40,9 @@ static void TransUdpTimerProc(void)
         return;
     }
     UdpChannelInfo *udpChannel = NULL;
-    UdpChannelInfo *nextUdpChannel = NULL;
-    LIST_FOR_EACH_ENTRY_SAFE(udpChannel, nextUdpChannel, &g_udpChannelMgr->list, UdpChannelInfo, node) {
-        if (udpChannel->status == UDP_CHANNEL_STATUS_NEGING) {
-            udpChannel->timeOut++;
-            if (udpChannel->timeOut < MAX_WAIT_CONNECT_TIME) {
-                continue;
-            }
+    LIST_FOR_EACH_ENTRY(udpChannel, &g_udpChannelMgr->list, UdpChannelInfo, node) {
+        /* negotiation may have finished, or the channel gone, since the timer was armed */
+        if (udpChannel->info.myData.channelId == (int32_t)key && udpChannel->status == UDP_CHANNEL_STATUS_NEGING) {
             if (udpChannel->info.udpChannelOptType == TYPE_UDP_CHANNEL_OPEN) {
                 SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "open udp channel time out, notify open failed.");
                 (void)NotifyUdpChannelOpenFailed(&(udpChannel->info));
@@ -57,6 +54,7 @@ static void TransUdpTimerProc(void)
             ListDelete(&(udpChannel->node));
             SoftBusFree(udpChannel);
             g_udpChannelMgr->cnt--;
+            break;
         }
     }
     (void)pthread_mutex_unlock(&g_udpChannelMgr->lock);
@@ -73,7 +71,7 @@ int32_t TransUdpChannelMgrInit(void)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "create udp channel manager list failed.");
         return SOFTBUS_MALLOC_ERR;
     }
-    if (RegisterTimeoutCallback(SOFTBUS_UDP_CHANNEL_TIMER_FUN, TransUdpTimerProc) != SOFTBUS_OK) {
+    if (TimerWheelRegister(SOFTBUS_UDP_CHANNEL_TIMER_FUN, TransUdpOnChannelTimer) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "register udp channel time out callback failed.");
         return SOFTBUS_ERR;
     }
@@ -152,6 +150,7 @@ int32_t TransDelUdpChannel(int32_t channelId)
     UdpChannelInfo *udpChannelNode = NULL;
     LIST_FOR_EACH_ENTRY(udpChannelNode, &(g_udpChannelMgr->list), UdpChannelInfo, node) {
         if (udpChannelNode->info.myData.channelId == channelId) {
+            TimerWheelCancel(SOFTBUS_UDP_CHANNEL_TIMER_FUN, (uint32_t)channelId);
             ReleaseUdpChannelId((int32_t)(udpChannelNode->info.myData.channelId));
             ListDelete(&(udpChannelNode->node));
             SoftBusFree(udpChannelNode);
@@ -283,6 +282,12 @@ int32_t TransSetUdpChannelStatus(int64_t seq, UdpChannelStatus status)
     LIST_FOR_EACH_ENTRY(udpChannelNode, &(g_udpChannelMgr->list), UdpChannelInfo, node) {
         if (udpChannelNode->seq == seq) {
             udpChannelNode->status = status;
+            uint32_t key = (uint32_t)udpChannelNode->info.myData.channelId;
+            if (status == UDP_CHANNEL_STATUS_NEGING) {
+                (void)TimerWheelArm(SOFTBUS_UDP_CHANNEL_TIMER_FUN, key, MAX_WAIT_CONNECT_TIME);
+            } else {
+                TimerWheelCancel(SOFTBUS_UDP_CHANNEL_TIMER_FUN, key);
+            }
             (void)pthread_mutex_unlock(&(g_udpChannelMgr->lock));
             return SOFTBUS_OK;
         }
@@ -197,6 +197,17 @@ typedef struct {
     void (*OnMessageReceived)(int sessionId, const void *data, unsigned int dataLen);
 
     void (*OnStreamReceived)(int sessionId, const StreamData *data, const StreamData *ext, const FrameInfo *param);
+
+    /**
+     * @brief Called when the send window of a session opens again.
+     *
+     * Optional. It is armed by {@link GetSessionSendWindow} reporting a low window and fires once.
+     *
+     * @param sessionId Indicates the session ID.
+     * @since 1.0
+     * @version 1.0
+     */
+    void (*OnSessionWritable)(int sessionId);
 } ISessionListener;
 
 typedef struct {
@@ -298,6 +309,19 @@ int SendMessage(int sessionId, const void *data, unsigned int len);
 
 int SendStream(int sessionId, const StreamData *data, const StreamData *ext, const FrameInfo *param);
 
+/**
+ * @brief Obtains the number of bytes that can be sent on a session without blocking.
+ *
+ * A window below 4096 bytes arms {@link OnSessionWritable} of the session listener.
+ *
+ * @param sessionId Indicates the session ID.
+ * @param window Indicates the pointer to the available send window, in bytes.
+ * @return Returns <b>0</b> if the operation is successful; returns an error code otherwise.
+ * @since 1.0
+ * @version 1.0
+ */
+int GetSessionSendWindow(int sessionId, unsigned int *window);
+
 /**
  * @brief Obtains the session name registered by the local device based on the session ID.
  *
@@ -27,6 +27,7 @@
 #include "softbus_errcode.h"
 #include "softbus_feature_config.h"
 #include "softbus_log.h"
+#include "softbus_utils.h"
 
 static bool g_isInited = false;
 static pthread_mutex_t g_isInitedLock = PTHREAD_MUTEX_INITIALIZER;
@@ -43,6 +44,11 @@ static void ClientModuleDeinit(void)
 static int32_t ClientModuleInit()
 {
     SoftbusConfigInit();
+    /* ticks the session and pending packet timers of this process, a no-op where the server already started it */
+    if (SoftBusTimerInit() == SOFTBUS_ERR) {
+        SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "init softbus timer failed");
+        return SOFTBUS_ERR;
+    }
     if (EventClientInit() == SOFTBUS_ERR) {
         SoftBusLog(SOFTBUS_LOG_COMM, SOFTBUS_LOG_ERROR, "init event manager failed");
         goto ERR_EXIT;
@@ -32,6 +32,7 @@ typedef struct {
     void (*OnStreamReceived)(int32_t channelId, int32_t channelType,
         const StreamData *data, const StreamData *ext, const FrameInfo *param);
     int32_t (*OnGetSessionId)(int32_t channelId, int32_t channelType, int32_t *sessionId);
+    int32_t (*OnSessionWritable)(int32_t channelId, int32_t channelType);
 } IClientSessionCallBack;
 
 IClientSessionCallBack *GetClientSessionCb(void);
@@ -33,7 +33,6 @@ typedef struct {
 
 typedef struct {
     ListNode node;
-    uint16_t timeout;
     int32_t sessionId;
     int32_t channelId;
     ChannelType channelType;
@@ -89,6 +89,28 @@ int SendStream(int sessionId, const StreamData *data, const StreamData *ext, con
     return ClientTransChannelSendStream(channelId, type, data, ext, param);
 }
 
+int GetSessionSendWindow(int sessionId, unsigned int *window)
+{
+    if (window == NULL || sessionId < 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Invalid param");
+        return SOFTBUS_INVALID_PARAM;
+    }
+
+    int32_t channelId = INVALID_CHANNEL_ID;
+    int32_t type = CHANNEL_TYPE_BUTT;
+    int32_t ret = ClientGetChannelBySessionId(sessionId, &channelId, &type);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get channel failed");
+        return ret;
+    }
+    if (type == CHANNEL_TYPE_BUTT) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "channel opening");
+        return SOFTBUS_TRANS_SESSION_OPENING;
+    }
+
+    return ClientTransChannelGetSendWindow(channelId, type, window);
+}
+
 int SendFile(int sessionId, const char *sFileList[], const char *dFileList[], uint32_t fileCnt)
 {
     if ((sFileList == NULL) || (fileCnt == 0)) {
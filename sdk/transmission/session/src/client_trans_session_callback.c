@@ -209,6 +209,21 @@ int32_t TransOnOnStreamRecevied(int32_t channelId, int32_t channelType,
     return SOFTBUS_OK;
 }
 
+int32_t TransOnSessionWritable(int32_t channelId, int32_t channelType)
+{
+    int32_t sessionId;
+    ISessionListener listener = {0};
+    int32_t ret = GetSessionCallbackByChannelId(channelId, channelType, &sessionId, &listener);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get session callback failed");
+        return ret;
+    }
+    if (listener.OnSessionWritable != NULL) {
+        listener.OnSessionWritable(sessionId);
+    }
+    return SOFTBUS_OK;
+}
+
 IClientSessionCallBack *GetClientSessionCb(void)
 {
     g_sessionCb.OnSessionOpened = TransOnSessionOpened;
@@ -217,5 +232,6 @@ IClientSessionCallBack *GetClientSessionCb(void)
     g_sessionCb.OnDataReceived = TransOnDataReceived;
     g_sessionCb.OnStreamReceived = TransOnOnStreamRecevied;
     g_sessionCb.OnGetSessionId = ClientGetSessionIdByChannelId;
+    g_sessionCb.OnSessionWritable = TransOnSessionWritable;
     return &g_sessionCb;
 }
@@ -23,6 +23,7 @@
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
+#include "softbus_timer_wheel.h"
 #include "softbus_utils.h"
 #include "trans_server_proxy.h"
 
@@ -30,12 +31,13 @@
 #define ID_USED 1
 #define SHIFT_3 3
 #define SESSION_MAP_COUNT ((MAX_SESSION_ID + 0x7) >> SHIFT_3)
+#define TRANS_SESSION_TIMEOUT (7 * 24 * 60 * 60) // ticks, one week
 
 static uint8_t g_idFlagBitmap[SESSION_MAP_COUNT];
 
 static SoftBusList *g_clientSessionServerList = NULL;
 
-void TransSessionTimer(void);
+static void TransOnSessionTimeout(uint32_t key);
 
 int TransClientInit(void)
 {
@@ -50,7 +52,7 @@ int TransClientInit(void)
         return SOFTBUS_ERR;
     }
 
-    if (RegisterTimeoutCallback(SOFTBUS_SESSION_TIMER_FUN, TransSessionTimer) != SOFTBUS_OK) {
+    if (TimerWheelRegister(SOFTBUS_SESSION_TIMER_FUN, TransOnSessionTimeout) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "init trans timer failed");
         return SOFTBUS_ERR;
     }
@@ -86,6 +88,7 @@ static int32_t GenerateSessionId(void)
 static void DestroySessionId(int32_t sessionId)
 {
     uint32_t id = (uint32_t)sessionId;
+    TimerWheelCancel(SOFTBUS_SESSION_TIMER_FUN, id);
     g_idFlagBitmap[(id >> SHIFT_3)] &= (~(ID_USED << (id & 0x7)));
 }
 
@@ -135,49 +138,6 @@ void TransClientDeinit(void)
     ClientTransChannelDeinit();
 }
 
-void TransSessionTimer(void)
-{
-#define TRANS_SESSION_TIMEOUT (7 * 24) // hour
-#define TRANS_SESSION_COUNT_TIMEOUT (60 * 60) // count per hour
-    static int32_t count = 0;
-    count++;
-    if (count < TRANS_SESSION_COUNT_TIMEOUT) {
-        return;
-    }
-    count = 0;
-
-    if (g_clientSessionServerList == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "not init");
-        return;
-    }
-
-    if (pthread_mutex_lock(&(g_clientSessionServerList->lock)) != 0) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock failed");
-        return;
-    }
-
-    ClientSessionServer *serverNode = NULL;
-    LIST_FOR_EACH_ENTRY(serverNode, &(g_clientSessionServerList->list), ClientSessionServer, node) {
-        if (IsListEmpty(&(serverNode->sessionList))) {
-            continue;
-        }
-        SessionInfo *sessionNode = NULL;
-        SessionInfo *sessionNodeNext = NULL;
-        LIST_FOR_EACH_ENTRY_SAFE(sessionNode, sessionNodeNext, &(serverNode->sessionList), SessionInfo, node) {
-            sessionNode->timeout++;
-            if (sessionNode->timeout >= TRANS_SESSION_TIMEOUT) {
-                serverNode->listener.session.OnSessionClosed(sessionNode->sessionId);
-                (void)ClientTransCloseChannel(sessionNode->channelId, sessionNode->channelType);
-                DestroySessionId(sessionNode->sessionId);
-                ListDelete(&(sessionNode->node));
-                SoftBusFree(sessionNode);
-            }
-        }
-    }
-    (void)pthread_mutex_unlock(&(g_clientSessionServerList->lock));
-    return;
-}
-
 static bool SessionServerIsExist(const char *sessionName)
 {
     /* need get lock before */
@@ -343,6 +303,32 @@ static int32_t GetSessionById(int32_t sessionId, ClientSessionServer **server, S
     return SOFTBUS_ERR;
 }
 
+static void TransOnSessionTimeout(uint32_t key)
+{
+    if (g_clientSessionServerList == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "not init");
+        return;
+    }
+
+    if (pthread_mutex_lock(&(g_clientSessionServerList->lock)) != 0) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "lock failed");
+        return;
+    }
+
+    /* the session may have been closed since the timer fired */
+    ClientSessionServer *serverNode = NULL;
+    SessionInfo *sessionNode = NULL;
+    if (GetSessionById((int32_t)key, &serverNode, &sessionNode) == SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "session %u time out", key);
+        serverNode->listener.session.OnSessionClosed(sessionNode->sessionId);
+        (void)ClientTransCloseChannel(sessionNode->channelId, sessionNode->channelType);
+        DestroySessionId(sessionNode->sessionId);
+        ListDelete(&(sessionNode->node));
+        SoftBusFree(sessionNode);
+    }
+    (void)pthread_mutex_unlock(&(g_clientSessionServerList->lock));
+}
+
 static int32_t AddSession(const char *sessionName, SessionInfo *session)
 {
     /* need get lock before */
@@ -356,6 +342,7 @@ static int32_t AddSession(const char *sessionName, SessionInfo *session)
             continue;
         }
         ListAdd(&serverNode->sessionList, &session->node);
+        (void)TimerWheelArm(SOFTBUS_SESSION_TIMER_FUN, (uint32_t)session->sessionId, TRANS_SESSION_TIMEOUT);
         return SOFTBUS_OK;
     }
     DestroySessionId(session->sessionId);
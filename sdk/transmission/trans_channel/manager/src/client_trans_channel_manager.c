@@ -104,6 +104,22 @@ int32_t ClientTransChannelSendBytes(int32_t channelId, int32_t type, const void
     return ret;
 }
 
+int32_t ClientTransChannelGetSendWindow(int32_t channelId, int32_t type, uint32_t *window)
+{
+    if (window == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Invalid param");
+        return SOFTBUS_INVALID_PARAM;
+    }
+
+    switch (type) {
+        case CHANNEL_TYPE_TCP_DIRECT:
+            return TransTdcGetSendWindow(channelId, window);
+        default:
+            /* proxy sends are queued by the server, which reports SOFTBUS_CONNECTION_ERR_SENDQUEUE_FULL */
+            return SOFTBUS_NOT_IMPLEMENT;
+    }
+}
+
 int32_t ClientTransChannelSendMessage(int32_t channelId, int32_t type, const void *data, uint32_t len)
 {
     if ((data == NULL) || (len == 0)) {
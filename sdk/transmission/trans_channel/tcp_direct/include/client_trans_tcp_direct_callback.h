@@ -38,6 +38,8 @@ int32_t ClientTransTdcOnSessionOpenFailed(int32_t channelId);
 int32_t ClientTransTdcOnDataReceived(int32_t channelId,
     const void *data, uint32_t len, SessionPktType type);
 
+int32_t ClientTransTdcOnSessionWritable(int32_t channelId);
+
 
 #ifdef __cplusplus
 #if __cplusplus
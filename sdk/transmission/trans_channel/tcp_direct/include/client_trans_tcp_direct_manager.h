@@ -18,6 +18,7 @@
 
 #include "client_trans_session_callback.h"
 #include "client_trans_tcp_direct_message.h"
+#include "softbus_adapter_crypto.h"
 #include "softbus_sequence_verification.h"
 
 #ifdef __cplusplus
@@ -40,6 +41,7 @@ typedef struct {
     ListNode node;
     int32_t channelId;
     TcpDirectChannelDetail detail;
+    SoftBusCipherCtx *cipherCtx; /* owned by the list item, acquire it with TransTdcGetCipherCtx */
 } TcpDirectChannelInfo;
 
 int32_t ClientTransTdcOnChannelOpened(const char *sessionName, const ChannelInfo *channel);
@@ -52,6 +54,9 @@ TcpDirectChannelInfo *TransTdcGetInfoById(int32_t channelId, TcpDirectChannelInf
 TcpDirectChannelInfo *TransTdcGetInfoByFd(int32_t fd, TcpDirectChannelInfo *info);
 TcpDirectChannelInfo *TransTdcGetInfoByIdWithIncSeq(int32_t channelId, TcpDirectChannelInfo *info);
 
+/* returns an acquired context, release it with SoftBusReleaseCipherCtx */
+SoftBusCipherCtx *TransTdcGetCipherCtx(int32_t channelId);
+
 int32_t TransTdcManagerInit(const IClientSessionCallBack *callback);
 void TransTdcManagerDeinit(void);
 
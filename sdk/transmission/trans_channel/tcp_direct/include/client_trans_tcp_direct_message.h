@@ -55,6 +55,7 @@ int32_t TransDelDataBufNode(int32_t channelId);
 int32_t TransAddDataBufNode(int32_t channelId, int32_t fd);
 int32_t TransTdcSendBytes(int32_t channelId, const char *data, uint32_t len);
 int32_t TransTdcSendMessage(int32_t channelId, const char *data, uint32_t len);
+int32_t TransTdcGetSendWindow(int32_t channelId, uint32_t *window);
 
 #ifdef __cplusplus
 }
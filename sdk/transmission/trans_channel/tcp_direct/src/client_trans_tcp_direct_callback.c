@@ -53,3 +53,11 @@ int32_t ClientTransTdcOnDataReceived(int32_t channelId,
     return g_sessionCb.OnDataReceived(channelId, CHANNEL_TYPE_TCP_DIRECT, data, len, type);
 }
 
+int32_t ClientTransTdcOnSessionWritable(int32_t channelId)
+{
+    if (g_sessionCb.OnSessionWritable == NULL) {
+        return SOFTBUS_OK;
+    }
+    return g_sessionCb.OnSessionWritable(channelId, CHANNEL_TYPE_TCP_DIRECT);
+}
+
@@ -59,6 +59,10 @@ static int32_t OnDataEvent(int events, int32_t fd)
             ClientTransTdcOnSessionClosed(channelId);
             return SOFTBUS_ERR;
         }
+    } else if (events == SOFTBUS_SOCKET_OUT) {
+        /* armed by TransTdcGetSendWindow, one report per low window */
+        (void)DelTrigger(DIRECT_CHANNEL_CLIENT, fd, WRITE_TRIGGER);
+        (void)ClientTransTdcOnSessionWritable(channel.channelId);
     }
     return SOFTBUS_OK;
 }
@@ -97,6 +101,6 @@ void TransTdcReleaseFd(int32_t fd)
     if (fd < 0) {
         return;
     }
-    DelTrigger(DIRECT_CHANNEL_CLIENT, fd, READ_TRIGGER);
+    DelTrigger(DIRECT_CHANNEL_CLIENT, fd, RW_TRIGGER);
     TcpShutDown(fd);
 }
@@ -109,27 +109,56 @@ int32_t TransTdcCheckSeq(int32_t fd, int32_t seq)
     return SOFTBUS_ERR;
 }
 
-void TransTdcCloseChannel(int32_t channelId)
+SoftBusCipherCtx *TransTdcGetCipherCtx(int32_t channelId)
 {
-    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "TransCloseTcpDirectChannel, channelId [%d]", channelId);
+    SoftBusCipherCtx *ctx = NULL;
+    TcpDirectChannelInfo *item = NULL;
+    (void)pthread_mutex_lock(&g_tcpDirectChannelInfoList->lock);
+    LIST_FOR_EACH_ENTRY(item, &(g_tcpDirectChannelInfoList->list), TcpDirectChannelInfo, node) {
+        if (item->channelId == channelId) {
+            ctx = item->cipherCtx;
+            SoftBusAcquireCipherCtx(ctx);
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_tcpDirectChannelInfoList->lock);
+    return ctx;
+}
 
+static void TransFreeTcpChannel(TcpDirectChannelInfo *item)
+{
+    SoftBusReleaseCipherCtx(item->cipherCtx);
+    item->cipherCtx = NULL;
+    SoftBusFree(item);
+}
+
+/* SOFTBUS_ERR when channelId was already gone, so only one closer reports the session closed */
+static int32_t TransTdcDelChannel(int32_t channelId)
+{
     TcpDirectChannelInfo *item = NULL;
     (void)pthread_mutex_lock(&g_tcpDirectChannelInfoList->lock);
     LIST_FOR_EACH_ENTRY(item, &(g_tcpDirectChannelInfoList->list), TcpDirectChannelInfo, node) {
         if (item->channelId == channelId) {
             TransTdcReleaseFd(item->detail.fd);
             ListDelete(&item->node);
-            SoftBusFree(item);
+            TransFreeTcpChannel(item);
             item = NULL;
             (void)pthread_mutex_unlock(&g_tcpDirectChannelInfoList->lock);
             DelPendingPacket(channelId, PENDING_TYPE_DIRECT);
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "Delete chanel item success.");
-            return;
+            return SOFTBUS_OK;
         }
     }
 
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "Target channel item not exist.");
     (void)pthread_mutex_unlock(&g_tcpDirectChannelInfoList->lock);
+    return SOFTBUS_ERR;
+}
+
+void TransTdcCloseChannel(int32_t channelId)
+{
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "TransCloseTcpDirectChannel, channelId [%d]", channelId);
+    (void)TransTdcDelChannel(channelId);
 }
 
 static TcpDirectChannelInfo *TransGetNewTcpChannel(const ChannelInfo *channel)
@@ -145,6 +174,11 @@ static TcpDirectChannelInfo *TransGetNewTcpChannel(const ChannelInfo *channel)
         SoftBusFree(item);
         return NULL;
     }
+    item->cipherCtx = SoftBusCreateCipherCtx((const unsigned char *)channel->sessionKey, SESSION_KEY_LENGTH);
+    if (item->cipherCtx == NULL) {
+        SoftBusFree(item);
+        return NULL;
+    }
     return item;
 }
 
@@ -171,20 +205,20 @@ int32_t ClientTransTdcOnChannelOpened(const char *sessionName, const ChannelInfo
 
     if (TransAddDataBufNode(channel->channelId, channel->fd) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "add data buf node fail.");
-        SoftBusFree(item);
+        TransFreeTcpChannel(item);
         goto EXIT_ERR;
     }
     if (TransTdcCreateListener(channel->fd) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans tcp direct create listener failed.");
         TransDelDataBufNode(channel->channelId);
-        SoftBusFree(item);
+        TransFreeTcpChannel(item);
         goto EXIT_ERR;
     }
 
     int32_t ret = SetTcpKeepAlive(channel->fd, HEART_TIME);
     if (ret != SOFTBUS_OK) {
         TransDelDataBufNode(channel->channelId);
-        SoftBusFree(item);
+        TransFreeTcpChannel(item);
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "SetTcpKeepAlive failed.");
         goto EXIT_ERR;
     }
@@ -202,6 +236,23 @@ EXIT_ERR:
     return SOFTBUS_ERR;
 }
 
+/*
+ * SendMessage returned once the message was written, so a missing ack leaves a hole in the stream the app
+ * never hears of. The channel is closed as if the peer had dropped it. Send errors were returned to the
+ * caller already, and a closed channel was reported by whoever closed it.
+ */
+static void TransTdcOnPendingComplete(int32_t channelId, int32_t seqNum, int32_t result)
+{
+    if (result != SOFTBUS_TIMOUT) {
+        return;
+    }
+    SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "channel %d msg seq %d not acked, close it", channelId, seqNum);
+    if (TransTdcDelChannel(channelId) == SOFTBUS_OK) {
+        TransDelDataBufNode(channelId);
+        (void)ClientTransTdcOnSessionClosed(channelId);
+    }
+}
+
 int32_t TransTdcManagerInit(const IClientSessionCallBack *cb)
 {
     g_tcpDirectChannelInfoList = CreateSoftBusList();
@@ -216,6 +267,7 @@ int32_t TransTdcManagerInit(const IClientSessionCallBack *cb)
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "trans direct pending init failed.");
         return SOFTBUS_ERR;
     }
+    PendingSetCompleteCallback(PENDING_TYPE_DIRECT, TransTdcOnPendingComplete);
     SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_INFO, "init tcp direct channel success.");
     return SOFTBUS_OK;
 }
@@ -23,6 +23,7 @@
 #include "common_list.h"
 #include "softbus_adapter_crypto.h"
 #include "softbus_adapter_mem.h"
+#include "softbus_base_listener.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
@@ -32,6 +33,8 @@
 #include "trans_pending_pkt.h"
 
 #define ACK_SIZE 4 // Message ACK 4 bytes
+#define TDC_SEND_WINDOW_LOW 4096
+#define TDC_RECV_BATCH_MAX 8 // frames decrypted per batch call
 static SoftBusList *g_tcpDataList = NULL;
 
 typedef struct {
@@ -43,27 +46,17 @@ typedef struct {
     char *w;
 } ClientDataBuf;
 
-static int32_t TransTdcDecrypt(const char *sessionKey, const char *in, uint32_t inLen, char *out, uint32_t *outLen)
-{
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH; // 256 bit encryption
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
-        return SOFTBUS_ERR;
-    }
-    return SoftBusDecryptData(&cipherKey, (unsigned char*)in, inLen, (unsigned char*)out, outLen);
-}
-
-static int32_t TransTdcEncryptWithSeq(const char *sessionKey, int32_t seqNum, const char *in, uint32_t inLen,
+static int32_t TransTdcEncryptWithSeq(int32_t channelId, int32_t seqNum, const char *in, uint32_t inLen,
     char *out, uint32_t *outLen)
 {
-    AesGcmCipherKey cipherKey = {0};
-    cipherKey.keyLen = SESSION_KEY_LENGTH;
-    if (memcpy_s(cipherKey.key, SESSION_KEY_LENGTH, sessionKey, SESSION_KEY_LENGTH) != EOK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy key error.");
+    SoftBusCipherCtx *ctx = TransTdcGetCipherCtx(channelId);
+    if (ctx == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get cipher ctx error.");
         return SOFTBUS_ERR;
     }
-    int ret = SoftBusEncryptDataWithSeq(&cipherKey, (unsigned char*)in, inLen, (unsigned char*)out, outLen, seqNum);
+    *outLen = inLen + OVERHEAD_LEN;
+    int32_t ret = SoftBusCipherCtxSeal(ctx, seqNum, (const unsigned char *)in, inLen, (unsigned char *)out, outLen);
+    SoftBusReleaseCipherCtx(ctx);
     if (ret != SOFTBUS_OK || *outLen != inLen + OVERHEAD_LEN) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "encrypt error.");
         return SOFTBUS_ENCRYPT_ERR;
@@ -116,7 +109,7 @@ static char *TransTdcPackData(const TcpDirectChannelInfo *channel, const char *d
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memcpy_s error");
         return NULL;
     }
-    if (TransTdcEncryptWithSeq(channel->detail.sessionKey, finalSeq, finalData, len,
+    if (TransTdcEncryptWithSeq(channel->channelId, finalSeq, finalData, len,
         buf + DC_DATA_HEAD_SIZE, outLen) != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "encrypt error");
         SoftBusFree(buf);
@@ -161,6 +154,27 @@ int32_t TransTdcSendBytes(int32_t channelId, const char *data, uint32_t len)
     return SOFTBUS_OK;
 }
 
+int32_t TransTdcGetSendWindow(int32_t channelId, uint32_t *window)
+{
+    TcpDirectChannelInfo channel;
+    (void)memset_s(&channel, sizeof(TcpDirectChannelInfo), 0, sizeof(TcpDirectChannelInfo));
+    if (TransTdcGetInfoById(channelId, &channel) == NULL) {
+        return SOFTBUS_ERR;
+    }
+
+    int32_t space = GetTcpSendWindow(channel.detail.fd);
+    if (space < 0) {
+        return SOFTBUS_NOT_IMPLEMENT;
+    }
+    *window = (uint32_t)space;
+    /* the listener reports the session writable once and drops the trigger again */
+    if (*window < TDC_SEND_WINDOW_LOW &&
+        AddTrigger(DIRECT_CHANNEL_CLIENT, channel.detail.fd, WRITE_TRIGGER) != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "arm write trigger failed");
+    }
+    return SOFTBUS_OK;
+}
+
 int32_t TransTdcSendMessage(int32_t channelId, const char *data, uint32_t len)
 {
     TcpDirectChannelInfo channel;
@@ -169,13 +183,17 @@ int32_t TransTdcSendMessage(int32_t channelId, const char *data, uint32_t len)
         return SOFTBUS_ERR;
     }
 
-    int32_t ret = TransTdcProcessPostData(&channel, data, len, FLAG_MESSAGE);
+    int32_t ret = AddPendingPacket(channelId, channel.detail.sequence, PENDING_TYPE_DIRECT);
     if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "postBytes failed.");
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "add pending failed.");
         return ret;
     }
-
-    return ProcPendingPacket(channelId, channel.detail.sequence, PENDING_TYPE_DIRECT);
+    ret = TransTdcProcessPostData(&channel, data, len, FLAG_MESSAGE);
+    if (ret != SOFTBUS_OK) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "postBytes failed.");
+        (void)CancelPendingPacket(channelId, channel.detail.sequence, PENDING_TYPE_DIRECT, ret);
+    }
+    return ret;
 }
 
 static int32_t TransTdcSendAck(const TcpDirectChannelInfo *channel, int32_t seq)
@@ -295,52 +313,120 @@ static int32_t TransTdcProcessDataByFlag(int32_t flag, int32_t seqNum, const Tcp
     }
 }
 
-static int32_t TransTdcProcessData(int32_t channelId)
+/* SOFTBUS_OK once the frame at offset is complete in the buffer, its length in *frameLen */
+static int32_t TransTdcCheckFrame(const ClientDataBuf *node, uint32_t offset, uint32_t *frameLen)
 {
-    TcpDirectChannelInfo channel;
-    if (TransTdcGetInfoById(channelId, &channel) == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get key fail.");
-        return SOFTBUS_ERR;
+    uint32_t bufLen = (uint32_t)(node->w - node->data) - offset;
+    if (bufLen < DC_DATA_HEAD_SIZE) {
+        return SOFTBUS_DATA_NOT_ENOUGH;
     }
-
-    pthread_mutex_lock(&g_tcpDataList->lock);
-    ClientDataBuf *node = TransGetDataBufNodeById(channelId);
-    if (node == NULL) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "node is null.");
+    const TcpDataPacketHead *pktHead = (const TcpDataPacketHead *)(node->data + offset);
+    if (pktHead->magicNumber != MAGIC_NUMBER) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid data packet head");
         return SOFTBUS_ERR;
     }
-    TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->data);
-    int32_t seqNum = pktHead->seq;
-    int32_t flag = pktHead->flags;
     uint32_t dataLen = pktHead->dataLen;
-    char *plain = (char *)SoftBusCalloc(dataLen - OVERHEAD_LEN);
-    if (plain == NULL) {
+    if (dataLen > node->size - DC_DATA_HEAD_SIZE || dataLen <= OVERHEAD_LEN) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "out of recv data buf size[%d]", dataLen);
+        return SOFTBUS_ERR;
+    }
+    if (bufLen < dataLen + DC_DATA_HEAD_SIZE) {
+        return SOFTBUS_DATA_NOT_ENOUGH;
+    }
+    *frameLen = dataLen + DC_DATA_HEAD_SIZE;
+    return SOFTBUS_OK;
+}
+
+/* decrypts every complete frame in the buffer with one batch call, then drops them from the buffer */
+static int32_t TransTdcOpenFrames(ClientDataBuf *node, SoftBusCipherCtx *ctx, TcpDataPacketHead *heads,
+    SoftBusCipherBatchItem *items, uint32_t *num, char **plain)
+{
+    uint32_t frameLen = 0;
+    uint32_t offset = 0;
+    uint32_t plainSize = 0;
+    int32_t ret = SOFTBUS_OK;
+    *num = 0;
+    while (*num < TDC_RECV_BATCH_MAX) {
+        ret = TransTdcCheckFrame(node, offset, &frameLen);
+        if (ret != SOFTBUS_OK) {
+            break;
+        }
+        heads[*num] = *(const TcpDataPacketHead *)(node->data + offset);
+        items[*num].input = (const unsigned char *)(node->data + offset + DC_DATA_HEAD_SIZE);
+        items[*num].inLen = heads[*num].dataLen;
+        items[*num].outLen = heads[*num].dataLen - OVERHEAD_LEN;
+        plainSize += items[*num].outLen;
+        offset += frameLen;
+        (*num)++;
+    }
+    if (*num == 0) {
+        return ret;
+    }
+    *plain = (char *)SoftBusMalloc(plainSize);
+    if (*plain == NULL) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "malloc fail.");
-        pthread_mutex_unlock(&g_tcpDataList->lock);
         return SOFTBUS_MALLOC_ERR;
     }
-
-    uint32_t plainLen;
-    int ret = TransTdcDecrypt(channel.detail.sessionKey, node->data + DC_DATA_HEAD_SIZE,
-        dataLen, plain, &plainLen);
+    uint32_t plainOffset = 0;
+    for (uint32_t i = 0; i < *num; i++) {
+        items[i].output = (unsigned char *)(*plain + plainOffset);
+        plainOffset += items[i].outLen;
+    }
+    ret = SoftBusCipherCtxOpenBatch(ctx, items, *num);
     if (ret != SOFTBUS_OK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "decrypt fail.");
-        SoftBusFree(plain);
-        pthread_mutex_unlock(&g_tcpDataList->lock);
-        return SOFTBUS_DECRYPT_ERR;
+        ret = SOFTBUS_DECRYPT_ERR;
+    }
+    /* frames up to the first one that failed to open have been consumed */
+    uint32_t used = 0;
+    for (uint32_t i = 0; i < *num && items[i].outLen != 0; i++) {
+        used += heads[i].dataLen + DC_DATA_HEAD_SIZE;
     }
-    char *end = node->data + DC_DATA_HEAD_SIZE + dataLen;
+    char *end = node->data + used;
     if (memmove_s(node->data, node->size, end, node->w - end) != EOK) {
         SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "memmove fail.");
-        pthread_mutex_unlock(&g_tcpDataList->lock);
         return SOFTBUS_MEM_ERR;
     }
-    node->w = node->w - DC_DATA_HEAD_SIZE - dataLen;
+    node->w -= used;
+    return ret;
+}
+
+static int32_t TransTdcProcessData(int32_t channelId)
+{
+    TcpDirectChannelInfo channel;
+    if (TransTdcGetInfoById(channelId, &channel) == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get key fail.");
+        return SOFTBUS_ERR;
+    }
+    /* taken before the data lock, the channel list lock nests outside it */
+    SoftBusCipherCtx *ctx = TransTdcGetCipherCtx(channelId);
+    if (ctx == NULL) {
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "get cipher ctx fail.");
+        return SOFTBUS_ERR;
+    }
+
+    TcpDataPacketHead heads[TDC_RECV_BATCH_MAX];
+    SoftBusCipherBatchItem items[TDC_RECV_BATCH_MAX] = {0};
+    uint32_t num = 0;
+    char *plain = NULL;
+    pthread_mutex_lock(&g_tcpDataList->lock);
+    ClientDataBuf *node = TransGetDataBufNodeById(channelId);
+    if (node == NULL) {
+        pthread_mutex_unlock(&g_tcpDataList->lock);
+        SoftBusReleaseCipherCtx(ctx);
+        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "can not find data buf node.");
+        return SOFTBUS_ERR;
+    }
+    int32_t ret = TransTdcOpenFrames(node, ctx, heads, items, &num, &plain);
     pthread_mutex_unlock(&g_tcpDataList->lock);
+    SoftBusReleaseCipherCtx(ctx);
 
-    ret = TransTdcProcessDataByFlag(flag, seqNum, &channel, plain, plainLen);
-    if (ret != SOFTBUS_OK) {
-        SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "process data fail");
+    for (uint32_t i = 0; plain != NULL && i < num && items[i].outLen != 0; i++) {
+        if (TransTdcProcessDataByFlag(heads[i].flags, heads[i].seq, &channel, (const char *)items[i].output,
+            items[i].outLen) != SOFTBUS_OK) {
+            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "process data fail");
+            ret = (ret == SOFTBUS_OK) ? SOFTBUS_ERR : ret;
+        }
     }
     SoftBusFree(plain);
     return ret;
@@ -349,41 +435,12 @@ static int32_t TransTdcProcessData(int32_t channelId)
 static int32_t TransTdcProcAllData(int32_t channelId)
 {
     while (1) {
-        pthread_mutex_lock(&g_tcpDataList->lock);
-        ClientDataBuf *node = TransGetDataBufNodeById(channelId);
-        if (node == NULL) {
-            pthread_mutex_unlock(&g_tcpDataList->lock);
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "can not find data buf node.");
-            return SOFTBUS_ERR;
-        }
-        uint32_t bufLen = node->w - node->data;
-        if (bufLen < DC_DATA_HEAD_SIZE) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "head not enough, recv biz head next time.");
-            pthread_mutex_unlock(&g_tcpDataList->lock);
-            return SOFTBUS_DATA_NOT_ENOUGH;
-        }
-
-        TcpDataPacketHead *pktHead = (TcpDataPacketHead *)(node->data);
-        if (pktHead->magicNumber != MAGIC_NUMBER) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "invalid data packet head");
-            pthread_mutex_unlock(&g_tcpDataList->lock);
-            return SOFTBUS_ERR;
-        }
-
-        uint32_t dataLen = pktHead->dataLen;
-        if (dataLen > node->size - DC_DATA_HEAD_SIZE) {
-            SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "out of recv data buf size[%d]", dataLen);
-            pthread_mutex_unlock(&g_tcpDataList->lock);
-            return SOFTBUS_ERR;
-        }
-        pthread_mutex_unlock(&g_tcpDataList->lock);
-
-        if (bufLen < dataLen + DC_DATA_HEAD_SIZE) {
+        int32_t ret = TransTdcProcessData(channelId);
+        if (ret == SOFTBUS_DATA_NOT_ENOUGH) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_WARN, "data not enough, recv biz data next time.");
-            return SOFTBUS_DATA_NOT_ENOUGH;
+            return ret;
         }
-
-        if (TransTdcProcessData(channelId) != SOFTBUS_OK) {
+        if (ret != SOFTBUS_OK) {
             SoftBusLog(SOFTBUS_LOG_TRAN, SOFTBUS_LOG_ERROR, "data received failed");
             return SOFTBUS_ERR;
         }
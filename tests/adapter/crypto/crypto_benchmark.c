@@ -0,0 +1,171 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <stdio.h>
+#include <time.h>
+
+#include <securec.h>
+
+#include "mbedtls/gcm.h"
+#include "softbus_adapter_crypto.h"
+#include "softbus_adapter_gcm_accel.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_errcode.h"
+
+#define BENCH_BYTES_PER_SIZE (64 * 1024 * 1024)
+#define BENCH_MIN_ROUNDS 1000
+#define NS_PER_SEC 1000000000ULL
+#define BYTES_PER_MB (1024.0 * 1024.0)
+
+typedef int32_t (*BenchRound)(void *arg, unsigned char *frame, uint32_t len);
+
+typedef struct {
+    mbedtls_gcm_context seal;
+    mbedtls_gcm_context open;
+} MbedKeys;
+
+typedef struct {
+    SoftBusGcmAccelKey *seal;
+    SoftBusGcmAccelKey *open;
+} AccelKeys;
+
+static const uint32_t g_benchSizes[] = { 64, 1024, 4096, 64 * 1024 };
+static unsigned char g_key[SESSION_KEY_LENGTH];
+static unsigned char g_iv[GCM_IV_LEN];
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+/* frame is iv | data | tag, one round seals data in place and opens it again */
+static int32_t MbedRound(void *arg, unsigned char *frame, uint32_t len)
+{
+    MbedKeys *keys = (MbedKeys *)arg;
+    unsigned char *data = frame + GCM_IV_LEN;
+    if (mbedtls_gcm_crypt_and_tag(&keys->seal, MBEDTLS_GCM_ENCRYPT, len, g_iv, GCM_IV_LEN, NULL, 0,
+        data, data, TAG_LEN, data + len) != 0) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    if (mbedtls_gcm_auth_decrypt(&keys->open, len, g_iv, GCM_IV_LEN, NULL, 0, data + len, TAG_LEN,
+        data, data) != 0) {
+        return SOFTBUS_DECRYPT_ERR;
+    }
+    return SOFTBUS_OK;
+}
+
+static int32_t AccelRound(void *arg, unsigned char *frame, uint32_t len)
+{
+    AccelKeys *keys = (AccelKeys *)arg;
+    unsigned char *data = frame + GCM_IV_LEN;
+    if (SoftBusGcmAccelSeal(keys->seal, g_iv, data, len, data, data + len) != SOFTBUS_OK) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    return SoftBusGcmAccelOpen(keys->open, g_iv, data, len, data + len, data);
+}
+
+/* the path the channels take: SoftBusCipherCtx, whichever backend it picked */
+static int32_t CipherCtxRound(void *arg, unsigned char *frame, uint32_t len)
+{
+    SoftBusCipherCtx *ctx = (SoftBusCipherCtx *)arg;
+    uint32_t outLen = len + OVERHEAD_LEN;
+    if (SoftBusCipherCtxSeal(ctx, 0, frame + GCM_IV_LEN, len, frame, &outLen) != SOFTBUS_OK) {
+        return SOFTBUS_ENCRYPT_ERR;
+    }
+    uint32_t plainLen = len;
+    return SoftBusCipherCtxOpen(ctx, frame, outLen, frame + GCM_IV_LEN, &plainLen);
+}
+
+static void RunBench(const char *name, BenchRound round, void *arg)
+{
+    for (uint32_t i = 0; i < sizeof(g_benchSizes) / sizeof(g_benchSizes[0]); i++) {
+        uint32_t len = g_benchSizes[i];
+        unsigned char *frame = (unsigned char *)SoftBusCalloc(len + OVERHEAD_LEN);
+        if (frame == NULL) {
+            printf("%-10s %6u B: malloc failed\n", name, len);
+            return;
+        }
+        uint32_t rounds = BENCH_BYTES_PER_SIZE / len;
+        rounds = (rounds < BENCH_MIN_ROUNDS) ? BENCH_MIN_ROUNDS : rounds;
+        uint64_t start = NowNs();
+        for (uint32_t r = 0; r < rounds; r++) {
+            if (round(arg, frame, len) != SOFTBUS_OK) {
+                printf("%-10s %6u B: round %u failed\n", name, len, r);
+                SoftBusFree(frame);
+                return;
+            }
+        }
+        uint64_t elapsed = NowNs() - start;
+        double mbPerSec = ((double)len * rounds * NS_PER_SEC) / ((double)elapsed * BYTES_PER_MB);
+        printf("%-10s %6u B: %8.1f ns/op %9.1f MB/s (seal+open)\n", name, len,
+            (double)elapsed / rounds, mbPerSec);
+        SoftBusFree(frame);
+    }
+}
+
+static void BenchMbedtls(void)
+{
+    MbedKeys keys;
+    mbedtls_gcm_init(&keys.seal);
+    mbedtls_gcm_init(&keys.open);
+    if (mbedtls_gcm_setkey(&keys.seal, MBEDTLS_CIPHER_ID_AES, g_key, sizeof(g_key) * KEY_BITS_UNIT) == 0 &&
+        mbedtls_gcm_setkey(&keys.open, MBEDTLS_CIPHER_ID_AES, g_key, sizeof(g_key) * KEY_BITS_UNIT) == 0) {
+        RunBench("mbedtls", MbedRound, &keys);
+    }
+    mbedtls_gcm_free(&keys.seal);
+    mbedtls_gcm_free(&keys.open);
+}
+
+static void BenchAccel(void)
+{
+    if (!SoftBusGcmAccelSupported()) {
+        printf("accel      not supported by this cpu\n");
+        return;
+    }
+    AccelKeys keys = {
+        .seal = SoftBusGcmAccelCreateKey(g_key, sizeof(g_key), true),
+        .open = SoftBusGcmAccelCreateKey(g_key, sizeof(g_key), false),
+    };
+    if (keys.seal != NULL && keys.open != NULL) {
+        RunBench("accel", AccelRound, &keys);
+    }
+    SoftBusGcmAccelDestroyKey(keys.seal);
+    SoftBusGcmAccelDestroyKey(keys.open);
+}
+
+static void BenchCipherCtx(void)
+{
+    SoftBusCipherCtx *ctx = SoftBusCreateCipherCtx(g_key, sizeof(g_key));
+    if (ctx == NULL) {
+        return;
+    }
+    RunBench("cipherctx", CipherCtxRound, ctx);
+    SoftBusReleaseCipherCtx(ctx);
+}
+
+int main(void)
+{
+    if (SoftBusGenerateRandomArray(g_key, sizeof(g_key)) != SOFTBUS_OK ||
+        SoftBusGenerateRandomArray(g_iv, sizeof(g_iv)) != SOFTBUS_OK) {
+        printf("generate key failed\n");
+        return -1;
+    }
+    BenchMbedtls();
+    BenchAccel();
+    BenchCipherCtx();
+    return 0;
+}
@@ -13,6 +13,9 @@
  * limitations under the License.
  */
 
+#include <pthread.h>
+#include <time.h>
+
 #include "message_handler.h"
 #include "softbus_adapter_mem.h"
 #include "softbus_log.h"
@@ -28,6 +31,38 @@
 
 #define CASE_FOUR_OBJ_SIZE 100
 
+#define GROUP_THREAD_NUM 2
+#define GROUP_AFFINITY_NUM 4
+#define GROUP_MSG_PER_AFFINITY 100
+#define GROUP_WAIT_SECONDS 5
+#define STATS_DELAY_MILLIS 100
+#define STATS_FAR_DELAY_MILLIS 100000
+#define MICROS_PER_MILLI 1000
+
+#define EXPECT_TRUE(cond) do {                           \
+        if (!(cond)) {                                   \
+            LOG_ERR("[test][error] %s:%d %s", __func__, __LINE__, #cond); \
+            g_failTestCount++;                           \
+        }                                                \
+    } while (0)
+
+static int32_t g_failTestCount = 0;
+
+typedef struct {
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+    uint32_t handled;
+    uint64_t lastArg[GROUP_AFFINITY_NUM];
+    pthread_t thread[GROUP_AFFINITY_NUM];
+    uint32_t outOfOrder;
+    uint32_t threadSwitch;
+} GroupTestRecord;
+
+static GroupTestRecord g_groupRecord = {
+    .lock = PTHREAD_MUTEX_INITIALIZER,
+    .cond = PTHREAD_COND_INITIALIZER,
+};
+
 static void NetworkingHandleMessage(const SoftBusMessage* msg)
 {
     LOG_INFO("NetworkingHandleMessage msg what=%d", msg->what);
@@ -82,3 +117,155 @@ void TestMessageHandler(void)
     msg2->handler = &g_networkingHandler;
     g_networkingHandler.looper->PostMessage(g_networkingHandler.looper, msg2);
 }
+
+// every affinity must stay on one member looper and see its messages in post order
+static void GroupHandleMessage(SoftBusMessage *msg)
+{
+    uint32_t affinity = msg->affinity;
+    if (affinity >= GROUP_AFFINITY_NUM) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_groupRecord.lock);
+    if (msg->arg1 != g_groupRecord.lastArg[affinity] + 1) {
+        g_groupRecord.outOfOrder++;
+    }
+    g_groupRecord.lastArg[affinity] = msg->arg1;
+    if (msg->arg1 == 1) {
+        g_groupRecord.thread[affinity] = pthread_self();
+    } else if (!pthread_equal(g_groupRecord.thread[affinity], pthread_self())) {
+        g_groupRecord.threadSwitch++;
+    }
+    g_groupRecord.handled++;
+    (void)pthread_cond_broadcast(&g_groupRecord.cond);
+    (void)pthread_mutex_unlock(&g_groupRecord.lock);
+}
+
+static void WaitGroupHandled(uint32_t expect)
+{
+    struct timespec deadline;
+    (void)clock_gettime(CLOCK_REALTIME, &deadline);
+    deadline.tv_sec += GROUP_WAIT_SECONDS;
+    (void)pthread_mutex_lock(&g_groupRecord.lock);
+    while (g_groupRecord.handled < expect) {
+        if (pthread_cond_timedwait(&g_groupRecord.cond, &g_groupRecord.lock, &deadline) != 0) {
+            break;
+        }
+    }
+    (void)pthread_mutex_unlock(&g_groupRecord.lock);
+}
+
+void TestMessageHandlerGroup(void)
+{
+    SoftBusLooper *group = CreateNewLooperGroup("Loop-test", GROUP_THREAD_NUM);
+    EXPECT_TRUE(group != NULL);
+    if (group == NULL) {
+        return;
+    }
+    (void)pthread_mutex_lock(&g_groupRecord.lock);
+    g_groupRecord.handled = 0;
+    g_groupRecord.outOfOrder = 0;
+    g_groupRecord.threadSwitch = 0;
+    for (uint32_t i = 0; i < GROUP_AFFINITY_NUM; i++) {
+        g_groupRecord.lastArg[i] = 0;
+    }
+    (void)pthread_mutex_unlock(&g_groupRecord.lock);
+    SoftBusLooper *oldLooper = g_networkingHandler.looper;
+    void (*oldHandleMessage)(SoftBusMessage *msg) = g_networkingHandler.HandleMessage;
+    g_networkingHandler.looper = group;
+    g_networkingHandler.HandleMessage = GroupHandleMessage;
+
+    uint32_t posted = 0;
+    for (uint64_t seq = 1; seq <= GROUP_MSG_PER_AFFINITY; seq++) {
+        for (uint32_t i = 0; i < GROUP_AFFINITY_NUM; i++) {
+            SoftBusMessage *msg = MallocMessage();
+            EXPECT_TRUE(msg != NULL);
+            if (msg == NULL) {
+                continue;
+            }
+            msg->what = CASE_ONE_WHAT;
+            msg->arg1 = seq;
+            msg->affinity = i;
+            msg->handler = &g_networkingHandler;
+            group->PostMessage(group, msg);
+            posted++;
+        }
+    }
+    WaitGroupHandled(posted);
+
+    (void)pthread_mutex_lock(&g_groupRecord.lock);
+    EXPECT_TRUE(g_groupRecord.handled == posted);
+    EXPECT_TRUE(g_groupRecord.outOfOrder == 0);
+    EXPECT_TRUE(g_groupRecord.threadSwitch == 0);
+    for (uint32_t i = 0; i < GROUP_AFFINITY_NUM; i++) {
+        EXPECT_TRUE(g_groupRecord.lastArg[i] == GROUP_MSG_PER_AFFINITY);
+    }
+    (void)pthread_mutex_unlock(&g_groupRecord.lock);
+
+    SoftBusLooperStats stats;
+    EXPECT_TRUE(GetLooperStats(group, &stats) == 0);
+    EXPECT_TRUE(stats.postCount == posted);
+    EXPECT_TRUE(stats.dispatchCount == posted);
+    EXPECT_TRUE(stats.queueDepth == 0);
+    DumpLooper(group);
+
+    DestroyLooper(group);
+    g_networkingHandler.looper = oldLooper;
+    g_networkingHandler.HandleMessage = oldHandleMessage;
+    LOG_INFO("TestMessageHandlerGroup done, fail=%d", g_failTestCount);
+}
+
+// a delayed message counts its delay as dispatch latency, the group peak is the most queued at one time
+void TestLooperStats(void)
+{
+    SoftBusLooper *group = CreateNewLooperGroup("Loop-stats", GROUP_THREAD_NUM);
+    EXPECT_TRUE(group != NULL);
+    if (group == NULL) {
+        return;
+    }
+    SoftBusLooper *oldLooper = g_networkingHandler.looper;
+    void (*oldHandleMessage)(SoftBusMessage *msg) = g_networkingHandler.HandleMessage;
+    g_networkingHandler.looper = group;
+    g_networkingHandler.HandleMessage = GroupHandleMessage;
+    (void)pthread_mutex_lock(&g_groupRecord.lock);
+    g_groupRecord.handled = 0;
+    g_groupRecord.lastArg[0] = 0;
+    (void)pthread_mutex_unlock(&g_groupRecord.lock);
+
+    // one message queued at a time, whichever member it lands on
+    for (uint32_t i = 0; i < GROUP_AFFINITY_NUM; i++) {
+        SoftBusMessage *msg = MallocMessage();
+        EXPECT_TRUE(msg != NULL);
+        if (msg == NULL) {
+            continue;
+        }
+        msg->what = CASE_THREE_WHAT;
+        msg->affinity = i;
+        msg->handler = &g_networkingHandler;
+        group->PostMessageDelay(group, msg, STATS_FAR_DELAY_MILLIS);
+        group->RemoveMessage(group, &g_networkingHandler, CASE_THREE_WHAT);
+    }
+    SoftBusMessage *msg = MallocMessage();
+    EXPECT_TRUE(msg != NULL);
+    if (msg != NULL) {
+        msg->what = CASE_ONE_WHAT;
+        msg->arg1 = 1;
+        msg->handler = &g_networkingHandler;
+        group->PostMessageDelay(group, msg, STATS_DELAY_MILLIS);
+        WaitGroupHandled(1);
+    }
+
+    SoftBusLooperStats stats;
+    EXPECT_TRUE(GetLooperStats(group, &stats) == 0);
+    EXPECT_TRUE(stats.queueDepthHighWater == 1);
+    EXPECT_TRUE(stats.queueDepth == 0);
+    EXPECT_TRUE(stats.postCount == GROUP_AFFINITY_NUM + 1);
+    EXPECT_TRUE(stats.removeCount == GROUP_AFFINITY_NUM);
+    EXPECT_TRUE(stats.dispatchCount == 1);
+    EXPECT_TRUE(stats.dispatchLatency.count == 1);
+    EXPECT_TRUE(stats.dispatchLatency.maxMicros >= STATS_DELAY_MILLIS * MICROS_PER_MILLI);
+
+    DestroyLooper(group);
+    g_networkingHandler.looper = oldLooper;
+    g_networkingHandler.HandleMessage = oldHandleMessage;
+    LOG_INFO("TestLooperStats done, fail=%d", g_failTestCount);
+}
@@ -13,7 +13,11 @@
  * limitations under the License.
  */
 
+#include <algorithm>
 #include <gtest/gtest.h>
+#include <random>
+#include <set>
+#include <vector>
 
 #include "softbus_sequence_verification.h"
 
@@ -21,6 +25,89 @@ using namespace testing::ext;
 
 namespace {
 const int32_t MAX_RECEIVE_SEQUENCE = 5;
+const int32_t PROPERTY_ROUNDS = 64;
+const int32_t PROPERTY_STREAM_LEN = 20000;
+const uint32_t PROPERTY_SEED = 20211;
+
+/* the window as a plain set of seqs on a line that never flips, what IsPassSeqCheck must agree with */
+class SeqWindowModel {
+public:
+    explicit SeqWindowModel(int64_t start) : minSeq_(start), maxSeq_(start) {}
+
+    bool Check(int64_t seq)
+    {
+        if (seq < minSeq_ || seq - maxSeq_ >= SEQ_WINDOW_SIZE) {
+            return false;
+        }
+        if (seq >= maxSeq_) {
+            maxSeq_ = seq + 1;
+            minSeq_ = std::max(minSeq_, maxSeq_ - SEQ_WINDOW_SIZE);
+            seen_.erase(seen_.begin(), seen_.lower_bound(minSeq_));
+        }
+        return seen_.insert(seq).second;
+    }
+
+private:
+    int64_t minSeq_;
+    int64_t maxSeq_;
+    std::set<int64_t> seen_;
+};
+
+int32_t ToWireSeq(int64_t seq)
+{
+    return static_cast<int32_t>(static_cast<uint32_t>(seq));
+}
+
+/* an in order stream reshuffled in runs up to twice the window, with replays and far jumps mixed in */
+std::vector<int64_t> GenerateStream(std::mt19937 &rng, int64_t start)
+{
+    std::vector<int64_t> stream;
+    std::uniform_int_distribution<int32_t> percent(0, 99);
+    std::uniform_int_distribution<int32_t> runLen(1, 2 * SEQ_WINDOW_SIZE);
+    int64_t next = start;
+    while (static_cast<int32_t>(stream.size()) < PROPERTY_STREAM_LEN) {
+        std::vector<int64_t> run;
+        int32_t len = runLen(rng);
+        for (int32_t i = 0; i < len; i++) {
+            run.push_back(next++);
+        }
+        if (percent(rng) < 50) {
+            std::shuffle(run.begin(), run.end(), rng);
+        }
+        for (int64_t seq : run) {
+            stream.push_back(seq);
+            int32_t dice = percent(rng);
+            if (dice < 5) {
+                /* replay of anything sent so far */
+                std::uniform_int_distribution<size_t> pick(0, stream.size() - 1);
+                stream.push_back(stream[pick(rng)]);
+            } else if (dice < 6) {
+                /* forged seq around the far edge of the window */
+                std::uniform_int_distribution<int64_t> far(SEQ_WINDOW_SIZE - 2, SEQ_WINDOW_SIZE + 2);
+                stream.push_back(next + far(rng));
+            }
+        }
+        if (percent(rng) < 3) {
+            /* the sender skips a few seqs for good */
+            next += runLen(rng) / 2;
+        }
+    }
+    return stream;
+}
+
+void CheckAgainstModel(int64_t start, std::mt19937 &rng)
+{
+    SeqVerifyInfo seqInfo = {0};
+    seqInfo.minSeq = ToWireSeq(start);
+    seqInfo.maxSeq = ToWireSeq(start);
+    SeqWindowModel model(start);
+    std::vector<int64_t> stream = GenerateStream(rng, start);
+    for (size_t i = 0; i < stream.size(); i++) {
+        bool expect = model.Check(stream[i]);
+        bool ret = IsPassSeqCheck(&seqInfo, ToWireSeq(stream[i]));
+        ASSERT_EQ(ret, expect) << "start " << start << " index " << i << " seq " << stream[i];
+    }
+}
 }
 
 namespace OHOS {
@@ -120,14 +207,14 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_001,
 
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_002
- * @tc.desc: Verify disorder seq, boundary valueseq(61-1=60[MAX_SEQ_BIAS]).
+ * @tc.desc: Verify disorder seq, boundary valueseq(1 + SEQ_WINDOW_SIZE - 2 < SEQ_WINDOW_SIZE).
  * @tc.type: FUNC
  * @tc.require:
  */
 HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_002, TestSize.Level0)
 {
     SeqVerifyInfo seqInfo = {0};
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {0, 1, 61, 8, 7};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {0, 1, 1 + SEQ_WINDOW_SIZE, 8, 7};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         EXPECT_EQ(ret, true);
@@ -136,14 +223,14 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_002,
 
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_003
- * @tc.desc: Verify disorder seq, boundary valueseq(62-1>60[MAX_SEQ_BIAS]).
+ * @tc.desc: Verify disorder seq, boundary valueseq(2 + SEQ_WINDOW_SIZE - 2 = SEQ_WINDOW_SIZE).
  * @tc.type: FUNC
  * @tc.require:
  */
 HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_003, TestSize.Level0)
 {
     SeqVerifyInfo seqInfo = {0};
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {0, 1, 62, 8, 7};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {0, 1, 2 + SEQ_WINDOW_SIZE, 8, 7};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         if (i < 2) {
@@ -158,7 +245,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_003,
 
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_004
- * @tc.desc: Verify disorder seq, boundary valueseq(99-39=60[MAX_SEQ_BIAS]).
+ * @tc.desc: Verify disorder seq, boundary valueseq(-99 + SEQ_WINDOW_SIZE + 98 < SEQ_WINDOW_SIZE).
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -167,7 +254,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_004,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = -100;
     seqInfo.maxSeq = -100;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-100, -99, -39, -96, -90};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-100, -99, -99 + SEQ_WINDOW_SIZE, -96, -90};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         EXPECT_EQ(ret, true);
@@ -176,7 +263,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_004,
 
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_005
- * @tc.desc: Verify disorder seq, boundary valueseq(99-38>60[MAX_SEQ_BIAS]).
+ * @tc.desc: Verify disorder seq, boundary valueseq(-98 + SEQ_WINDOW_SIZE + 98 = SEQ_WINDOW_SIZE).
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -185,7 +272,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_005,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = -100;
     seqInfo.maxSeq = -100;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-100, -99, -38, -96, -90};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-100, -99, -98 + SEQ_WINDOW_SIZE, -96, -90};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         if (i < 2) {
@@ -201,7 +288,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_005,
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_006
  * @tc.desc: Verify disorder seq, seq flip negative, boundary valueseq.
- * INT32_MIN + 58 - INT32_MIN + INT32_MAX - (INT32_MAX - 1) + 1 = 60[MAX_SEQ_BIAS]
+ * INT32_MIN + SEQ_WINDOW_SIZE - 2 - INT32_MIN + INT32_MAX - (INT32_MAX - 1) + 1 = SEQ_WINDOW_SIZE
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -210,7 +297,8 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_006,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = INT32_MAX - 2;
     seqInfo.maxSeq = INT32_MAX - 2;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {INT32_MAX - 2, INT32_MAX - 1, INT32_MIN + 58, INT32_MIN, INT32_MIN + 7};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {INT32_MAX - 2, INT32_MAX - 1, INT32_MIN + SEQ_WINDOW_SIZE - 2, INT32_MIN,
+        INT32_MIN + 7};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         EXPECT_EQ(ret, true);
@@ -220,7 +308,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_006,
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_007
  * @tc.desc: Verify disorder seq, seq flip negative, boundary valueseq.
- * INT32_MIN + 59 - INT32_MIN + INT32_MAX - (INT32_MAX - 1) + 1 > 60[MAX_SEQ_BIAS]
+ * INT32_MIN + SEQ_WINDOW_SIZE - 1 - INT32_MIN + INT32_MAX - (INT32_MAX - 1) + 1 > SEQ_WINDOW_SIZE
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -229,7 +317,8 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_007,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = INT32_MAX - 2;
     seqInfo.maxSeq = INT32_MAX - 2;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {INT32_MAX - 2, INT32_MAX - 1, INT32_MIN + 59, INT32_MIN, INT32_MIN + 7};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {INT32_MAX - 2, INT32_MAX - 1, INT32_MIN + SEQ_WINDOW_SIZE - 1, INT32_MIN,
+        INT32_MIN + 7};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         if (i < 2) {
@@ -245,7 +334,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_007,
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_008
  * @tc.desc: Verify disorder seq, seq flip positive, boundary valueseq.
- * 31 + 29 = 60[MAX_SEQ_BIAS]
+ * SEQ_WINDOW_SIZE - 29 + 29 = SEQ_WINDOW_SIZE
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -254,7 +343,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_008,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = -30;
     seqInfo.maxSeq = -30;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-30, -29, 31, 0, -3};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-30, -29, SEQ_WINDOW_SIZE - 29, 0, -3};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         EXPECT_EQ(ret, true);
@@ -264,7 +353,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_008,
 /**
  * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_009
  * @tc.desc: Verify disorder seq, seq flip positive, boundary valueseq.
- * 32 + 29 > 60[MAX_SEQ_BIAS]
+ * SEQ_WINDOW_SIZE - 28 + 29 > SEQ_WINDOW_SIZE
  * @tc.type: FUNC
  * @tc.require:
  */
@@ -273,7 +362,7 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_009,
     SeqVerifyInfo seqInfo = {0};
     seqInfo.minSeq = -30;
     seqInfo.maxSeq = -30;
-    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-30, -29, 32, 0, -3};
+    int32_t recvSeq[MAX_RECEIVE_SEQUENCE] = {-30, -29, SEQ_WINDOW_SIZE - 28, 0, -3};
     for (int i = 0; i < MAX_RECEIVE_SEQUENCE; i++) {
         bool ret = IsPassSeqCheck(&seqInfo, recvSeq[i]);
         if (i < 2) {
@@ -521,4 +610,53 @@ HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_LessThanMinCase_00
         }
     }
 }
-}
\ No newline at end of file
+
+/**
+ * @tc.name: Softbus_SeqVerifyTest_Test_DisorderCase_010
+ * @tc.desc: Verify a burst reordered across the whole window, no seq is dropped.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_DisorderCase_010, TestSize.Level0)
+{
+    SeqVerifyInfo seqInfo = {0};
+    for (int32_t recvSeq = SEQ_WINDOW_SIZE - 1; recvSeq >= 0; recvSeq--) {
+        bool ret = IsPassSeqCheck(&seqInfo, recvSeq);
+        EXPECT_EQ(ret, true);
+    }
+    for (int32_t recvSeq = 0; recvSeq < SEQ_WINDOW_SIZE; recvSeq++) {
+        bool ret = IsPassSeqCheck(&seqInfo, recvSeq);
+        EXPECT_EQ(ret, false);
+    }
+}
+
+/**
+ * @tc.name: Softbus_SeqVerifyTest_Test_PropertyCase_001
+ * @tc.desc: Verify random disorder, replay and jump streams against a reference model, seq >= 0.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_PropertyCase_001, TestSize.Level0)
+{
+    std::mt19937 rng(PROPERTY_SEED);
+    for (int32_t i = 0; i < PROPERTY_ROUNDS; i++) {
+        CheckAgainstModel(0, rng);
+    }
+}
+
+/**
+ * @tc.name: Softbus_SeqVerifyTest_Test_PropertyCase_002
+ * @tc.desc: Verify random streams against a reference model, seq flip negative and flip positive.
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SequenceVerificationTest, Softbus_SeqVerifyTest_Test_PropertyCase_002, TestSize.Level0)
+{
+    std::mt19937 rng(PROPERTY_SEED + 1);
+    std::uniform_int_distribution<int64_t> lead(0, PROPERTY_STREAM_LEN);
+    for (int32_t i = 0; i < PROPERTY_ROUNDS; i++) {
+        /* int32 flips to negative at 2^31 and back to positive at 2^32 */
+        CheckAgainstModel((i % 2 == 0 ? INT64_C(0x80000000) : INT64_C(0x100000000)) - lead(rng), rng);
+    }
+}
+}
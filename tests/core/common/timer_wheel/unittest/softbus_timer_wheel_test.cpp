@@ -0,0 +1,231 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <map>
+#include <vector>
+
+#include "softbus_errcode.h"
+#include "softbus_timer_wheel.h"
+#include "softbus_utils.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+/* one slot per level is 64 ticks wide, a level spans 64 times the one below it */
+#define LEVEL1_TICKS 64U
+#define LEVEL2_TICKS (LEVEL1_TICKS * LEVEL1_TICKS)
+#define LEVEL3_TICKS (LEVEL2_TICKS * LEVEL1_TICKS)
+/* the idle timeout client_trans_session_manager.c arms for every session */
+#define TRANS_SESSION_TIMEOUT (7 * 24 * 60 * 60)
+#define TEST_TIMER_FUN SOFTBUS_CONN_TIMER_FUN
+#define REARM_KEY 1000
+#define REARM_TIMES 3
+#define REARM_TICKS 10
+
+/* the wheel is a process wide singleton, so every test works from whatever TimerWheelNow() it starts at */
+static std::map<uint32_t, std::vector<uint32_t>> g_fired;
+static int32_t g_rearmLeft = 0;
+
+static void RecordExpire(uint32_t key)
+{
+    g_fired[key].push_back(TimerWheelNow());
+    if (key == REARM_KEY && g_rearmLeft > 0) {
+        g_rearmLeft--;
+        (void)TimerWheelArm(TEST_TIMER_FUN, key, REARM_TICKS);
+    }
+}
+
+static void Advance(uint32_t ticks)
+{
+    for (uint32_t i = 0; i < ticks; i++) {
+        TimerWheelTick();
+    }
+}
+
+/* lines now up with a level boundary so a delay lands exactly on the edge it is named after */
+static void AlignTo(uint32_t ticks)
+{
+    while ((TimerWheelNow() & (ticks - 1)) != 0) {
+        TimerWheelTick();
+    }
+}
+
+/* arms key for ticks and checks it fires on that very tick, not one earlier or later */
+static void ExpectFiresAfter(uint32_t key, uint32_t ticks)
+{
+    uint32_t start = TimerWheelNow();
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, key, ticks));
+    Advance(ticks - 1);
+    EXPECT_TRUE(g_fired[key].empty()) << "key " << key << " fired early, delay " << ticks;
+    TimerWheelTick();
+    ASSERT_EQ(1U, g_fired[key].size()) << "key " << key << " delay " << ticks;
+    EXPECT_EQ(start + ticks, g_fired[key][0]);
+}
+
+class SoftbusTimerWheelTest : public testing::Test {
+public:
+    static void SetUpTestCase(void)
+    {
+        ASSERT_EQ(SOFTBUS_OK, TimerWheelRegister(TEST_TIMER_FUN, RecordExpire));
+    }
+    static void TearDownTestCase(void) {}
+    void SetUp(void) override
+    {
+        g_fired.clear();
+        g_rearmLeft = 0;
+    }
+    void TearDown(void) override {}
+};
+
+/*
+ * @tc.name: testTimerWheelArm001
+ * @tc.desc: a zero delay fires on the next tick, never on the current one
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelArm001, TestSize.Level1)
+{
+    uint32_t start = TimerWheelNow();
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 1, 0));
+    EXPECT_TRUE(g_fired[1].empty());
+    TimerWheelTick();
+    ASSERT_EQ(1U, g_fired[1].size());
+    EXPECT_EQ(start + 1, g_fired[1][0]);
+    Advance(LEVEL1_TICKS);
+    EXPECT_EQ(1U, g_fired[1].size());
+
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TimerWheelArm(SOFTBUS_MAX_TIMER_FUN_NUM, 1, 1));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, TimerWheelRegister(TEST_TIMER_FUN, NULL));
+}
+
+/*
+ * @tc.name: testTimerWheelArm002
+ * @tc.desc: delays on both sides of the level 0/1 and level 1/2 edges fire on time, from an aligned now and
+ *           from one just past it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelArm002, TestSize.Level1)
+{
+    const uint32_t delays[] = { LEVEL1_TICKS - 1, LEVEL1_TICKS, LEVEL2_TICKS - 1, LEVEL2_TICKS };
+    const uint32_t offsets[] = { 0, 1, LEVEL1_TICKS - 1 };
+    uint32_t key = 0;
+    for (uint32_t offset : offsets) {
+        for (uint32_t delay : delays) {
+            AlignTo(LEVEL2_TICKS);
+            Advance(offset);
+            ExpectFiresAfter(++key, delay);
+        }
+    }
+}
+
+/*
+ * @tc.name: testTimerWheelCascade001
+ * @tc.desc: timers parked on level 2 and level 3 cascade down through every level and fire on time
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelCascade001, TestSize.Level1)
+{
+    AlignTo(LEVEL1_TICKS);
+    Advance(LEVEL1_TICKS / 2);
+    ExpectFiresAfter(1, 3 * LEVEL2_TICKS + 2 * LEVEL1_TICKS + 5);
+    ExpectFiresAfter(2, LEVEL3_TICKS + 2 * LEVEL2_TICKS + 3 * LEVEL1_TICKS + 7);
+    ExpectFiresAfter(3, LEVEL3_TICKS);
+}
+
+/*
+ * @tc.name: testTimerWheelCascade002
+ * @tc.desc: the one week session idle timeout sits on the top level and still fires on its exact tick,
+ *           alongside short timers armed with it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelCascade002, TestSize.Level1)
+{
+    uint32_t start = TimerWheelNow();
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 1, TRANS_SESSION_TIMEOUT));
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 2, LEVEL1_TICKS));
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 3, TRANS_SESSION_TIMEOUT - 1));
+    Advance(TRANS_SESSION_TIMEOUT - 1);
+    EXPECT_TRUE(g_fired[1].empty());
+    ASSERT_EQ(1U, g_fired[2].size());
+    EXPECT_EQ(start + LEVEL1_TICKS, g_fired[2][0]);
+    ASSERT_EQ(1U, g_fired[3].size());
+    EXPECT_EQ(start + TRANS_SESSION_TIMEOUT - 1, g_fired[3][0]);
+    TimerWheelTick();
+    ASSERT_EQ(1U, g_fired[1].size());
+    EXPECT_EQ(start + TRANS_SESSION_TIMEOUT, g_fired[1][0]);
+}
+
+/*
+ * @tc.name: testTimerWheelCancel001
+ * @tc.desc: a cancelled timer never fires, on any level, and re-arming moves a timer instead of adding one
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelCancel001, TestSize.Level1)
+{
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 1, 5));
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 2, LEVEL2_TICKS + 5));
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 3, 5));
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, 3, 20));
+    TimerWheelCancel(TEST_TIMER_FUN, 1);
+    TimerWheelCancel(TEST_TIMER_FUN, 2);
+    Advance(LEVEL2_TICKS + LEVEL1_TICKS);
+    EXPECT_TRUE(g_fired[1].empty());
+    EXPECT_TRUE(g_fired[2].empty());
+    EXPECT_EQ(1U, g_fired[3].size());
+}
+
+/*
+ * @tc.name: testTimerWheelCancel002
+ * @tc.desc: cancelling a timer that already fired, or one never armed, is a no-op and the key can be armed again
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelCancel002, TestSize.Level1)
+{
+    ExpectFiresAfter(1, 3);
+    TimerWheelCancel(TEST_TIMER_FUN, 1);
+    TimerWheelCancel(TEST_TIMER_FUN, 2);
+    TimerWheelCancel(SOFTBUS_MAX_TIMER_FUN_NUM, 1);
+    Advance(LEVEL1_TICKS);
+    EXPECT_EQ(1U, g_fired[1].size());
+    EXPECT_TRUE(g_fired[2].empty());
+
+    g_fired.clear();
+    ExpectFiresAfter(1, LEVEL1_TICKS + 1);
+}
+
+/*
+ * @tc.name: testTimerWheelRearm001
+ * @tc.desc: a callback may re-arm its own key, each round fires once on its own tick
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(SoftbusTimerWheelTest, testTimerWheelRearm001, TestSize.Level1)
+{
+    g_rearmLeft = REARM_TIMES;
+    uint32_t start = TimerWheelNow();
+    EXPECT_EQ(SOFTBUS_OK, TimerWheelArm(TEST_TIMER_FUN, REARM_KEY, REARM_TICKS));
+    Advance(REARM_TICKS * (REARM_TIMES + 2));
+    ASSERT_EQ(static_cast<size_t>(REARM_TIMES + 1), g_fired[REARM_KEY].size());
+    for (uint32_t i = 0; i <= REARM_TIMES; i++) {
+        EXPECT_EQ(start + REARM_TICKS * (i + 1), g_fired[REARM_KEY][i]);
+    }
+}
+}
@@ -15,9 +15,12 @@
 
 #include <gtest/gtest.h>
 #include <pthread.h>
+#include <random>
+#include <time.h>
 
 #include "common_list.h"
 #include "softbus_base_listener.h"
+#include "softbus_conn_id_table.h"
 #include "softbus_def.h"
 #include "softbus_errcode.h"
 #include "softbus_log.h"
@@ -28,7 +31,9 @@
 using namespace testing::ext;
 
 static const int INVALID_FD = -1;
+static const int JOB_WAIT_SECONDS = 5;
 static pthread_mutex_t g_isInitedLock;
+static pthread_cond_t g_countCond = PTHREAD_COND_INITIALIZER;
 static int g_count = 0;
 static int g_port = 6666;
 
@@ -49,10 +54,59 @@ int ThreadPoolTask(void* arg)
 {
     pthread_mutex_lock(&g_isInitedLock);
     g_count++;
+    pthread_cond_broadcast(&g_countCond);
     pthread_mutex_unlock(&g_isInitedLock);
     return SOFTBUS_OK;
 }
 
+static void GetJobDeadline(struct timespec *deadline)
+{
+    clock_gettime(CLOCK_REALTIME, deadline);
+    deadline->tv_sec += JOB_WAIT_SECONDS;
+}
+
+/* waits until ThreadPoolTask has run expect times in all, false on timeout */
+static bool WaitJobCount(int expect)
+{
+    struct timespec deadline;
+    GetJobDeadline(&deadline);
+    pthread_mutex_lock(&g_isInitedLock);
+    while (g_count < expect) {
+        if (pthread_cond_timedwait(&g_countCond, &g_isInitedLock, &deadline) != 0) {
+            break;
+        }
+    }
+    bool reached = (g_count >= expect);
+    pthread_mutex_unlock(&g_isInitedLock);
+    return reached;
+}
+
+/*
+ * a removed PERSISTENT job gives its slot back once a worker pops it again, which happens among
+ * the runs of the other jobs, so each failed add waits for the next run before retrying
+ */
+static int32_t AddJobOnceSlotFree(ThreadPool *pool, JobMode mode, uintptr_t handle)
+{
+    struct timespec deadline;
+    GetJobDeadline(&deadline);
+    int32_t ret = ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, mode, handle);
+    pthread_mutex_lock(&g_isInitedLock);
+    while (ret == SOFTBUS_ERR) {
+        int count = g_count;
+        while (g_count == count) {
+            if (pthread_cond_timedwait(&g_countCond, &g_isInitedLock, &deadline) != 0) {
+                pthread_mutex_unlock(&g_isInitedLock);
+                return ret;
+            }
+        }
+        pthread_mutex_unlock(&g_isInitedLock);
+        ret = ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, mode, handle);
+        pthread_mutex_lock(&g_isInitedLock);
+    }
+    pthread_mutex_unlock(&g_isInitedLock);
+    return ret;
+}
+
 void SoftbusCommonTest::SetUpTestCase(void)
 {
     pthread_mutex_init(&g_isInitedLock, nullptr);
@@ -465,7 +519,7 @@ HWTEST_F(SoftbusCommonTest, testThreadPool004, TestSize.Level1)
     }
     ret = ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, PERSISTENT, (uintptr_t)queueMaxNum);
     EXPECT_EQ(ret, SOFTBUS_ERR);
-    sleep(3);
+    EXPECT_TRUE(WaitJobCount(queueMaxNum + 1));
     ret = (g_count != queueMaxNum) ? SOFTBUS_OK : SOFTBUS_ERR;
     EXPECT_EQ(ret, SOFTBUS_OK);
     for (int i = 0; i < queueMaxNum; i++) {
@@ -499,7 +553,7 @@ HWTEST_F(SoftbusCommonTest, testThreadPool005, TestSize.Level1)
         ret = ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, ONCE, (uintptr_t)i);
         EXPECT_EQ(ret, SOFTBUS_OK);
     }
-    sleep(3);
+    EXPECT_TRUE(WaitJobCount(queueMaxNum));
     EXPECT_EQ(queueMaxNum, g_count);
     for (int i = 0; i < queueMaxNum; i++) {
         ret = ThreadPoolRemoveJob(pool, (uintptr_t)i);
@@ -510,4 +564,244 @@ HWTEST_F(SoftbusCommonTest, testThreadPool005, TestSize.Level1)
         EXPECT_EQ(ret, SOFTBUS_OK);
     }
 };
+
+/*
+* @tc.name: testThreadPool006
+* @tc.desc: test removed PERSISTENT job releases its slot and its handle
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testThreadPool006, TestSize.Level1)
+{
+    int threadNum = 2;
+    int queueMaxNum = 4;
+
+    ThreadPool *pool = ThreadPoolInit(threadNum, queueMaxNum);
+    ASSERT_TRUE(pool != nullptr);
+
+    for (int i = 0; i < queueMaxNum - 1; i++) {
+        EXPECT_EQ(SOFTBUS_OK, ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, PERSISTENT, (uintptr_t)i));
+    }
+    EXPECT_EQ(SOFTBUS_ALREADY_EXISTED, ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, PERSISTENT, (uintptr_t)0));
+    EXPECT_EQ(SOFTBUS_OK, ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, PERSISTENT, (uintptr_t)(queueMaxNum - 1)));
+    EXPECT_EQ(SOFTBUS_ERR, ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, ONCE, (uintptr_t)queueMaxNum));
+    EXPECT_EQ(SOFTBUS_OK, ThreadPoolRemoveJob(pool, (uintptr_t)0));
+    EXPECT_EQ(SOFTBUS_OK, AddJobOnceSlotFree(pool, PERSISTENT, (uintptr_t)0));
+    EXPECT_EQ(SOFTBUS_ERR, ThreadPoolAddJob(pool, ThreadPoolTask, nullptr, ONCE, (uintptr_t)queueMaxNum));
+    EXPECT_EQ(SOFTBUS_OK, ThreadPoolDestroy(pool));
+};
+
+static const uint32_t ID_TABLE_INIT_BITS = 4;
+static const uint32_t ID_TABLE_HASH_BITS = 32;
+static const uint32_t ID_TABLE_HASH_MULTIPLIER = 0x9E3779B1U;
+
+static uint32_t IdTableHomeSlot(uint32_t bits, uint32_t connectionId)
+{
+    return (connectionId * ID_TABLE_HASH_MULTIPLIER) >> (ID_TABLE_HASH_BITS - bits);
+}
+
+/* the next connectionId from start on whose home slot is slot in a table of 1 << bits entries */
+static uint32_t IdTableIdAtSlot(uint32_t bits, uint32_t slot, uint32_t start)
+{
+    uint32_t id = start;
+    while (IdTableHomeSlot(bits, id) != slot) {
+        id++;
+    }
+    return id;
+}
+
+static void *IdTableValue(uint32_t connectionId)
+{
+    return (void *)((uintptr_t)connectionId + 1);
+}
+
+/* the longest run of occupied slots, wrapping past the last one */
+static uint32_t IdTableLongestRun(const ConnIdTable *table)
+{
+    uint32_t longestRun = 0;
+    uint32_t run = 0;
+    for (uint32_t i = 0; i < table->size * 2; i++) {
+        run = (table->entries[i % table->size].value != nullptr) ? run + 1 : 0;
+        longestRun = (run > longestRun) ? run : longestRun;
+    }
+    return (longestRun > table->size) ? table->size : longestRun;
+}
+
+static void *IdTableLookup(ConnIdTable *table, uint32_t connectionId)
+{
+    if (ConnIdTableReadLock(table) != SOFTBUS_OK) {
+        return nullptr;
+    }
+    void *value = ConnIdTableFind(table, connectionId);
+    ConnIdTableUnlock(table);
+    return value;
+}
+
+/*
+* @tc.name: testConnIdTable001
+* @tc.desc: test ConnIdTable add, find and remove
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testConnIdTable001, TestSize.Level1)
+{
+    ConnIdTable table;
+    ASSERT_EQ(SOFTBUS_OK, ConnIdTableInit(&table));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ConnIdTableAdd(&table, 1, nullptr));
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ConnIdTableAdd(nullptr, 1, IdTableValue(1)));
+    EXPECT_EQ(nullptr, IdTableLookup(&table, 1));
+
+    EXPECT_EQ(SOFTBUS_OK, ConnIdTableAdd(&table, 1, IdTableValue(1)));
+    EXPECT_EQ(SOFTBUS_ALREADY_EXISTED, ConnIdTableAdd(&table, 1, IdTableValue(2)));
+    EXPECT_EQ(SOFTBUS_OK, ConnIdTableAdd(&table, 0, IdTableValue(0)));
+    EXPECT_EQ(IdTableValue(1), IdTableLookup(&table, 1));
+    EXPECT_EQ(IdTableValue(0), IdTableLookup(&table, 0));
+    EXPECT_EQ(2U, table.count);
+
+    EXPECT_EQ(IdTableValue(1), ConnIdTableRemove(&table, 1));
+    EXPECT_EQ(nullptr, ConnIdTableRemove(&table, 1));
+    EXPECT_EQ(nullptr, IdTableLookup(&table, 1));
+    EXPECT_EQ(IdTableValue(0), IdTableLookup(&table, 0));
+    EXPECT_EQ(1U, table.count);
+    ConnIdTableDeinit(&table);
+};
+
+/*
+* @tc.name: testConnIdTable002
+* @tc.desc: test ConnIdTable grows past three quarters full and keeps every entry, sequential ids spread out
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testConnIdTable002, TestSize.Level1)
+{
+    const uint32_t idNum = 1000;
+    const uint32_t idBase = 0x20000;
+    ConnIdTable table;
+    ASSERT_EQ(SOFTBUS_OK, ConnIdTableInit(&table));
+    uint32_t size = table.size;
+    for (uint32_t i = 0; i < idNum; i++) {
+        ASSERT_EQ(SOFTBUS_OK, ConnIdTableAdd(&table, idBase + i, IdTableValue(idBase + i)));
+        EXPECT_LE(table.count * 4, table.size * 3);
+        if (table.size != size) {
+            EXPECT_EQ(size * 2, table.size);
+            size = table.size;
+            for (uint32_t j = 0; j <= i; j++) {
+                EXPECT_EQ(IdTableValue(idBase + j), IdTableLookup(&table, idBase + j));
+            }
+        }
+    }
+    EXPECT_EQ(1U << table.bits, table.size);
+
+    /* sequential ids must not pile up in long runs */
+    EXPECT_LT(IdTableLongestRun(&table), 32U);
+
+    for (uint32_t i = 0; i < idNum; i += 2) {
+        EXPECT_EQ(IdTableValue(idBase + i), ConnIdTableRemove(&table, idBase + i));
+    }
+    for (uint32_t i = 0; i < idNum; i++) {
+        EXPECT_EQ((i % 2 == 0) ? nullptr : IdTableValue(idBase + i), IdTableLookup(&table, idBase + i));
+    }
+    ConnIdTableDeinit(&table);
+
+    /* ids that differ only in their high bits, like one fd under several connection types */
+    const uint32_t highShift = 20;
+    const uint32_t highNum = 200;
+    ASSERT_EQ(SOFTBUS_OK, ConnIdTableInit(&table));
+    for (uint32_t i = 0; i < highNum; i++) {
+        ASSERT_EQ(SOFTBUS_OK, ConnIdTableAdd(&table, i << highShift, IdTableValue(i << highShift)));
+    }
+    EXPECT_LT(IdTableLongestRun(&table), 32U);
+    ConnIdTableDeinit(&table);
+};
+
+/*
+* @tc.name: testConnIdTable003
+* @tc.desc: test ConnIdTable backward shift delete on a probe chain that wraps past the last slot
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testConnIdTable003, TestSize.Level1)
+{
+    const uint32_t lastSlot = (1U << ID_TABLE_INIT_BITS) - 1;
+    ConnIdTable table;
+    ASSERT_EQ(SOFTBUS_OK, ConnIdTableInit(&table));
+    ASSERT_EQ(ID_TABLE_INIT_BITS, table.bits);
+    /* a, b and c all want the last slot and wrap to 0 and 1, d wants slot 0 and ends up in 2 */
+    uint32_t a = IdTableIdAtSlot(ID_TABLE_INIT_BITS, lastSlot, 1);
+    uint32_t b = IdTableIdAtSlot(ID_TABLE_INIT_BITS, lastSlot, a + 1);
+    uint32_t c = IdTableIdAtSlot(ID_TABLE_INIT_BITS, lastSlot, b + 1);
+    uint32_t d = IdTableIdAtSlot(ID_TABLE_INIT_BITS, 0, 1);
+    uint32_t ids[] = { a, b, c, d };
+    for (uint32_t id : ids) {
+        ASSERT_EQ(SOFTBUS_OK, ConnIdTableAdd(&table, id, IdTableValue(id)));
+    }
+    EXPECT_EQ(a, table.entries[lastSlot].connectionId);
+    EXPECT_EQ(b, table.entries[0].connectionId);
+    EXPECT_EQ(c, table.entries[1].connectionId);
+    EXPECT_EQ(d, table.entries[2].connectionId);
+
+    /* every later entry of the chain moves back one slot across the wrap, nothing is left behind */
+    EXPECT_EQ(IdTableValue(a), ConnIdTableRemove(&table, a));
+    EXPECT_EQ(b, table.entries[lastSlot].connectionId);
+    EXPECT_EQ(c, table.entries[0].connectionId);
+    EXPECT_EQ(d, table.entries[1].connectionId);
+    EXPECT_EQ(nullptr, table.entries[2].value);
+    for (uint32_t id : { b, c, d }) {
+        EXPECT_EQ(IdTableValue(id), IdTableLookup(&table, id));
+    }
+
+    /* d is at its home slot once c is gone, so it must stay there */
+    EXPECT_EQ(IdTableValue(c), ConnIdTableRemove(&table, c));
+    EXPECT_EQ(b, table.entries[lastSlot].connectionId);
+    EXPECT_EQ(d, table.entries[0].connectionId);
+    EXPECT_EQ(nullptr, table.entries[1].value);
+    EXPECT_EQ(IdTableValue(b), IdTableLookup(&table, b));
+    EXPECT_EQ(IdTableValue(d), IdTableLookup(&table, d));
+    EXPECT_EQ(nullptr, IdTableLookup(&table, a));
+    EXPECT_EQ(nullptr, IdTableLookup(&table, c));
+    ConnIdTableDeinit(&table);
+};
+
+/*
+* @tc.name: testConnIdTable004
+* @tc.desc: test ConnIdTable against a plain array over random add, remove and find
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusCommonTest, testConnIdTable004, TestSize.Level1)
+{
+    const uint32_t keyNum = 512;
+    const uint32_t opNum = 200000;
+    const uint32_t idStride = 37;
+    const uint32_t idType = 2U << 24;
+    void *model[keyNum] = { nullptr };
+    std::mt19937 rng(7);
+    ConnIdTable table;
+    ASSERT_EQ(SOFTBUS_OK, ConnIdTableInit(&table));
+    for (uint32_t op = 0; op < opNum; op++) {
+        uint32_t key = rng() % keyNum;
+        uint32_t id = (key * idStride) | idType;
+        switch (rng() % 3) {
+            case 0: {
+                int32_t ret = ConnIdTableAdd(&table, id, IdTableValue(id));
+                ASSERT_EQ((model[key] != nullptr) ? SOFTBUS_ALREADY_EXISTED : SOFTBUS_OK, ret) << "op " << op;
+                model[key] = IdTableValue(id);
+                break;
+            }
+            case 1:
+                ASSERT_EQ(model[key], ConnIdTableRemove(&table, id)) << "op " << op;
+                model[key] = nullptr;
+                break;
+            default:
+                ASSERT_EQ(model[key], IdTableLookup(&table, id)) << "op " << op;
+                break;
+        }
+    }
+    uint32_t count = 0;
+    for (uint32_t key = 0; key < keyNum; key++) {
+        count += (model[key] != nullptr) ? 1 : 0;
+    }
+    EXPECT_EQ(count, table.count);
+    ConnIdTableDeinit(&table);
+};
 }
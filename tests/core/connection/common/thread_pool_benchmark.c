@@ -0,0 +1,116 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "softbus_errcode.h"
+#include "softbus_thread_pool.h"
+
+#define BENCH_DEFAULT_JOBS 2000000
+#define BENCH_MAX_PRODUCERS 8
+#define NS_PER_SEC 1000000000ULL
+
+typedef struct {
+    int32_t workers;
+    int32_t producers;
+    int32_t queueMaxNum;
+} BenchConfig;
+
+typedef struct {
+    ThreadPool *pool;
+    long jobs;
+} Producer;
+
+/* the configurations quoted when the pool moved to per-worker rings */
+static const BenchConfig g_benchConfigs[] = {
+    { 1, 1, 10 },
+    { 4, 1, 64 },
+    { 4, 4, 64 },
+    { 8, 8, 256 },
+};
+static long g_done;
+
+static uint64_t NowNs(void)
+{
+    struct timespec ts;
+    (void)clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * NS_PER_SEC + (uint64_t)ts.tv_nsec;
+}
+
+static int32_t EmptyJob(void *arg)
+{
+    (void)arg;
+    (void)__atomic_add_fetch(&g_done, 1, __ATOMIC_RELAXED);
+    return SOFTBUS_OK;
+}
+
+/* a full pool is not an error here, the producer retries until a slot frees up */
+static void *ProduceJobs(void *arg)
+{
+    Producer *producer = (Producer *)arg;
+    for (long i = 0; i < producer->jobs; i++) {
+        while (ThreadPoolAddJob(producer->pool, EmptyJob, NULL, ONCE, (uintptr_t)i) != SOFTBUS_OK) {
+            (void)sched_yield();
+        }
+    }
+    return NULL;
+}
+
+static void RunBench(const BenchConfig *config, long totalJobs)
+{
+    ThreadPool *pool = ThreadPoolInit(config->workers, config->queueMaxNum);
+    if (pool == NULL) {
+        printf("workers=%d: init failed\n", config->workers);
+        return;
+    }
+    Producer producer = { .pool = pool, .jobs = totalJobs / config->producers };
+    pthread_t tids[BENCH_MAX_PRODUCERS];
+    int32_t started = 0;
+    __atomic_store_n(&g_done, 0, __ATOMIC_RELAXED);
+    uint64_t start = NowNs();
+    for (; started < config->producers; started++) {
+        if (pthread_create(&tids[started], NULL, ProduceJobs, &producer) != 0) {
+            break;
+        }
+    }
+    for (int32_t i = 0; i < started; i++) {
+        (void)pthread_join(tids[i], NULL);
+    }
+    long expect = producer.jobs * started;
+    while (__atomic_load_n(&g_done, __ATOMIC_RELAXED) < expect) {
+        (void)sched_yield();
+    }
+    uint64_t elapsed = NowNs() - start;
+    printf("workers=%d producers=%d queue=%d jobs=%ld: %.0f jobs/s\n", config->workers, started,
+        config->queueMaxNum, expect, (double)expect * NS_PER_SEC / (double)elapsed);
+    (void)ThreadPoolDestroy(pool);
+}
+
+int main(int argc, char **argv)
+{
+    long totalJobs = (argc > 1) ? atol(argv[1]) : BENCH_DEFAULT_JOBS;
+    if (totalJobs <= 0) {
+        printf("usage: %s [jobs]\n", argv[0]);
+        return -1;
+    }
+    for (size_t i = 0; i < sizeof(g_benchConfigs) / sizeof(g_benchConfigs[0]); i++) {
+        RunBench(&g_benchConfigs[i], totalJobs);
+    }
+    return 0;
+}
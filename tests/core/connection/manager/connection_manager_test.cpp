@@ -32,6 +32,10 @@ static const int SHIFT_BITS = 16;
 static ConnectCallback *g_mangerCb = 0;
 static ConnectionInfo g_connInfo = {0};
 static unsigned int g_connId = 0;
+static int g_postLen = 0;
+static ConnPktHead g_postHead = {0};
+static const unsigned int SEND_WINDOW = 1024;
+static unsigned int g_writableId = 0;
 
 using namespace testing::ext;
 
@@ -66,6 +70,8 @@ int ObjectPostBytes(unsigned int connectionId, const char *data, int len, int pi
     }
     head = (ConnPktHead *)data;
     module = head->module;
+    g_postLen = len;
+    g_postHead = *head;
 
     char *buf = (char *)calloc(1, CONN_HEAD_SIZE + bufLen);
     if (buf == nullptr) {
@@ -118,6 +124,13 @@ int ObjectStopLocalListening(const LocalListenerInfo *info)
     return 0;
 }
 
+int ObjectGetSendWindow(unsigned int connectionId, unsigned int *window)
+{
+    (void)connectionId;
+    *window = SEND_WINDOW;
+    return 0;
+}
+
 ConnectFuncInterface *ConnInitObject(const ConnectCallback *callback)
 {
     if (callback == 0) {
@@ -135,6 +148,7 @@ ConnectFuncInterface *ConnInitObject(const ConnectCallback *callback)
     inter->GetConnectionInfo = ObjectGetConnectionInfo;
     inter->StartLocalListening = ObjectStartLocalListening;
     inter->StopLocalListening = ObjectStopLocalListening;
+    inter->GetSendWindow = ObjectGetSendWindow;
     return inter;
 }
 
@@ -167,6 +181,12 @@ void DataReceivedCB(unsigned int connectionId, ConnModule moduleId, int64_t seq,
     return;
 }
 
+void WritableCB(unsigned int connectionId)
+{
+    g_writableId = connectionId;
+    return;
+}
+
 void ConnectSuccessedCB(unsigned int requestId, unsigned int connectionId, const ConnectionInfo *info)
 {
     printf("ConnectSuccessedCB %u\r\n", connectionId);
@@ -407,4 +427,102 @@ HWTEST_F(SoftbusConnmangerFuncTest, testConnmanger006, TestSize.Level1)
     ConnUnSetConnectCallback(MODULE_TRUST_ENGINE);
     printf("testConnmanger006 ConnUnSetConnectCallback end 11\r\n");
 };
+
+/*
+* @tc.name: testConnmanger007
+* @tc.desc: test post iov chain falls back to one flattened buffer
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusConnmangerFuncTest, testConnmanger007, TestSize.Level1)
+{
+    int ret;
+    ConnectCallback connCb;
+    ConnectOption optionInfo;
+    ConnectResult connRet;
+    const char *head = "proxy head";
+    const char *payload = "send msg iov\r\n";
+
+    connCb.OnConnected = ConnectedCB;
+    connCb.OnDisconnected = DisConnectCB;
+    connCb.OnDataReceived = DataReceivedCB;
+    ret = ConnSetConnectCallback(MODULE_TRUST_ENGINE, &connCb);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+
+    optionInfo.type = CONNECT_BR;
+    connRet.OnConnectFailed = ConnectFailedCB;
+    connRet.OnConnectSuccessed = ConnectSuccessedCB;
+    ret = ConnConnectDevice(&optionInfo, ConnGetNewRequestId(MODULE_TRUST_ENGINE), &connRet);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    ASSERT_TRUE(g_connId != 0);
+
+    ConnIoVec iov[] = {
+        { head, (int)strlen(head) },
+        { payload, (int)strlen(payload) },
+    };
+    ConnPostVecData data = {0};
+    data.module = MODULE_TRUST_ENGINE;
+    data.seq = 1;
+    data.iov = iov;
+    data.iovCnt = 0;
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ConnPostBytesVec(g_connId, &data));
+    data.iovCnt = CONN_POST_IOV_MAX + 1;
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ConnPostBytesVec(g_connId, &data));
+
+    data.iovCnt = sizeof(iov) / sizeof(iov[0]);
+    ret = ConnPostBytesVec(g_connId, &data);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    int payloadLen = (int)(strlen(head) + strlen(payload));
+    EXPECT_EQ(CONN_HEAD_SIZE + payloadLen, g_postLen);
+    EXPECT_EQ(payloadLen, g_postHead.len);
+    EXPECT_EQ(MODULE_TRUST_ENGINE, g_postHead.module);
+
+    ret = ConnDisconnectDevice(g_connId);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    g_connId = 0;
+    ConnUnSetConnectCallback(MODULE_TRUST_ENGINE);
+};
+
+/*
+* @tc.name: testConnmanger008
+* @tc.desc: test send window query and writable notification fan out
+* @tc.type: FUNC
+* @tc.require:
+*/
+HWTEST_F(SoftbusConnmangerFuncTest, testConnmanger008, TestSize.Level1)
+{
+    int ret;
+    ConnectCallback connCb = {0};
+    ConnectOption optionInfo;
+    ConnectResult connRet;
+    unsigned int window = 0;
+
+    connCb.OnConnected = ConnectedCB;
+    connCb.OnDisconnected = DisConnectCB;
+    connCb.OnDataReceived = DataReceivedCB;
+    connCb.OnWritable = WritableCB;
+    ret = ConnSetConnectCallback(MODULE_TRUST_ENGINE, &connCb);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+
+    optionInfo.type = CONNECT_BR;
+    connRet.OnConnectFailed = ConnectFailedCB;
+    connRet.OnConnectSuccessed = ConnectSuccessedCB;
+    ret = ConnConnectDevice(&optionInfo, ConnGetNewRequestId(MODULE_TRUST_ENGINE), &connRet);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    ASSERT_TRUE(g_connId != 0);
+
+    EXPECT_EQ(SOFTBUS_INVALID_PARAM, ConnGetSendWindow(g_connId, nullptr));
+    ret = ConnGetSendWindow(g_connId, &window);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    EXPECT_EQ(SEND_WINDOW, window);
+
+    ASSERT_TRUE(g_mangerCb != nullptr && g_mangerCb->OnWritable != nullptr);
+    g_mangerCb->OnWritable(g_connId);
+    EXPECT_EQ(g_connId, g_writableId);
+
+    ret = ConnDisconnectDevice(g_connId);
+    EXPECT_EQ(SOFTBUS_OK, ret);
+    g_connId = 0;
+    ConnUnSetConnectCallback(MODULE_TRUST_ENGINE);
+};
 }
\ No newline at end of file
@@ -18,5 +18,7 @@
 void TestMain()
 {
     TestMessageHandler();
+    TestMessageHandlerGroup();
+    TestLooperStats();
     BrConnectionTest();
 }
\ No newline at end of file
@@ -0,0 +1,353 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <tuple>
+#include <vector>
+
+#include "softbus_errcode.h"
+#include "softbus_timer_wheel.h"
+#include "softbus_utils.h"
+#include "trans_pending_pkt.h"
+
+using namespace testing::ext;
+
+namespace OHOS {
+#define TEST_TYPE PENDING_TYPE_PROXY
+#define TEST_CHANNEL_A 1
+#define TEST_CHANNEL_B 2
+/* a channel that never has packets, the complete callback deletes it to find out whether the pending lock is held */
+#define TEST_CHANNEL_PROBE 99
+/* a sender that has not returned after this long is taken as blocked */
+#define BLOCKED_MS 200
+/* TIME_OUT of trans_pending_pkt.c is 2s, an expired packet is reported well within this */
+#define EXPIRE_WAIT_MS 5000
+#define SENDER_WAIT_MS 3000
+
+typedef std::tuple<int32_t, int32_t, int32_t> Completion;
+
+static std::mutex g_lock;
+static std::vector<Completion> g_done;
+static std::atomic<bool> g_probeInCallback(false);
+/* a callback ran with the pending lock held and never returned, the table can no longer be torn down */
+static bool g_wedged = false;
+
+static void RecordComplete(int32_t channelId, int32_t seqNum, int32_t result)
+{
+    if (g_probeInCallback) {
+        /* takes the pending lock, so it would never return if the callback ran with it held */
+        (void)DelPendingPacket(TEST_CHANNEL_PROBE, TEST_TYPE);
+    }
+    std::lock_guard<std::mutex> guard(g_lock);
+    g_done.emplace_back(channelId, seqNum, result);
+}
+
+static std::vector<Completion> Completed(void)
+{
+    std::lock_guard<std::mutex> guard(g_lock);
+    return g_done;
+}
+
+/* how often (channelId, seqNum) was completed, and with what result the last time */
+static int32_t CompleteCount(int32_t channelId, int32_t seqNum, int32_t *result = nullptr)
+{
+    int32_t count = 0;
+    for (const Completion &item : Completed()) {
+        if (std::get<0>(item) == channelId && std::get<1>(item) == seqNum) {
+            count++;
+            if (result != nullptr) {
+                *result = std::get<2>(item);
+            }
+        }
+    }
+    return count;
+}
+
+static bool WaitUntil(const std::atomic<bool> &flag, int32_t ms)
+{
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+    while (!flag && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(10));
+    }
+    return flag;
+}
+
+/* AddPendingPacket on its own thread, so the test can see it block and resume */
+class Sender {
+public:
+    Sender(int32_t channelId, int32_t seqNum) : ret_(SOFTBUS_ERR), done_(false)
+    {
+        thread_ = std::thread([this, channelId, seqNum]() {
+            ret_ = AddPendingPacket(channelId, seqNum, TEST_TYPE);
+            done_ = true;
+        });
+    }
+    ~Sender()
+    {
+        if (thread_.joinable()) {
+            thread_.join();
+        }
+    }
+    bool Blocked(void)
+    {
+        return !WaitUntil(done_, BLOCKED_MS);
+    }
+    int32_t Result(int32_t ms)
+    {
+        return WaitUntil(done_, ms) ? ret_.load() : SOFTBUS_TIMOUT;
+    }
+
+private:
+    std::atomic<int32_t> ret_;
+    std::atomic<bool> done_;
+    std::thread thread_;
+};
+
+class TransPendingPktTest : public testing::Test {
+public:
+    TransPendingPktTest()
+    {}
+    ~TransPendingPktTest()
+    {}
+    static void SetUpTestCase(void)
+    {}
+    static void TearDownTestCase(void)
+    {}
+    void SetUp() override
+    {
+        ASSERT_FALSE(g_wedged);
+        {
+            std::lock_guard<std::mutex> guard(g_lock);
+            g_done.clear();
+        }
+        g_probeInCallback = false;
+        ASSERT_EQ(SOFTBUS_OK, PendingInit(TEST_TYPE));
+        PendingSetCompleteCallback(TEST_TYPE, RecordComplete);
+    }
+    void TearDown() override
+    {
+        if (g_wedged) {
+            return;
+        }
+        g_probeInCallback = false;
+        (void)DelPendingPacket(TEST_CHANNEL_A, TEST_TYPE);
+        (void)DelPendingPacket(TEST_CHANNEL_B, TEST_TYPE);
+        PendingSetCompleteCallback(TEST_TYPE, NULL);
+        PendingDeinit(TEST_TYPE);
+    }
+};
+
+/* fills the window of channelId with seqs 0 .. PENDING_WINDOW_DEFAULT - 1 */
+static void FillWindow(int32_t channelId)
+{
+    for (int32_t seq = 0; seq < PENDING_WINDOW_DEFAULT; seq++) {
+        ASSERT_EQ(SOFTBUS_OK, AddPendingPacket(channelId, seq, TEST_TYPE));
+    }
+}
+
+/*
+ * @tc.name: testPendingAck001
+ * @tc.desc: an ack completes only the packet of its channel and seq, once
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingAck001, TestSize.Level1)
+{
+    for (int32_t channelId : { TEST_CHANNEL_A, TEST_CHANNEL_B }) {
+        for (int32_t seq = 1; seq <= 3; seq++) {
+            EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(channelId, seq, TEST_TYPE));
+        }
+    }
+    EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_B, 2, TEST_TYPE));
+    ASSERT_EQ(1U, Completed().size());
+    int32_t result = SOFTBUS_ERR;
+    EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_B, 2, &result));
+    EXPECT_EQ(SOFTBUS_OK, result);
+
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_B, 2, TEST_TYPE));
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_A, 4, TEST_TYPE));
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_PROBE, 1, TEST_TYPE));
+    EXPECT_EQ(1U, Completed().size());
+
+    EXPECT_EQ(SOFTBUS_OK, CancelPendingPacket(TEST_CHANNEL_A, 2, TEST_TYPE, SOFTBUS_ERR));
+    EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, 2, &result));
+    EXPECT_EQ(SOFTBUS_ERR, result);
+    for (int32_t channelId : { TEST_CHANNEL_A, TEST_CHANNEL_B }) {
+        for (int32_t seq : { 1, 3 }) {
+            EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(channelId, seq, TEST_TYPE));
+            EXPECT_EQ(1, CompleteCount(channelId, seq));
+        }
+    }
+    EXPECT_EQ(6U, Completed().size());
+};
+
+/*
+ * @tc.name: testPendingAdd002
+ * @tc.desc: a seq already in flight on a channel is refused, on another channel it is a different packet
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingAdd002, TestSize.Level1)
+{
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE));
+    EXPECT_NE(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE));
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_B, 1, TEST_TYPE));
+    EXPECT_TRUE(Completed().empty());
+
+    /* a full window does not make a duplicate wait before it is refused */
+    FillWindow(TEST_CHANNEL_B + 1);
+    Sender duplicate(TEST_CHANNEL_B + 1, 0);
+    EXPECT_EQ(SOFTBUS_ERR, duplicate.Result(BLOCKED_MS));
+    (void)DelPendingPacket(TEST_CHANNEL_B + 1, TEST_TYPE);
+
+    EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE));
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE));
+    EXPECT_NE(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_A, 1, PENDING_TYPE_BUTT));
+};
+
+/*
+ * @tc.name: testPendingWindow003
+ * @tc.desc: a sender blocks on a full window, other channels do not, and it resumes when a packet is acked
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingWindow003, TestSize.Level1)
+{
+    FillWindow(TEST_CHANNEL_A);
+    Sender sender(TEST_CHANNEL_A, PENDING_WINDOW_DEFAULT);
+    EXPECT_TRUE(sender.Blocked());
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_B, PENDING_WINDOW_DEFAULT, TEST_TYPE));
+    EXPECT_TRUE(sender.Blocked());
+
+    EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_A, 3, TEST_TYPE));
+    EXPECT_EQ(SOFTBUS_OK, sender.Result(SENDER_WAIT_MS));
+    EXPECT_EQ(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_A, PENDING_WINDOW_DEFAULT, TEST_TYPE));
+    EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, 3));
+    EXPECT_EQ(0, CompleteCount(TEST_CHANNEL_A, 0));
+};
+
+/*
+ * @tc.name: testPendingWindow004
+ * @tc.desc: a sender blocked on a full window resumes when the oldest packet expires without an ack
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingWindow004, TestSize.Level1)
+{
+    FillWindow(TEST_CHANNEL_A);
+    auto start = std::chrono::steady_clock::now();
+    Sender sender(TEST_CHANNEL_A, PENDING_WINDOW_DEFAULT);
+    EXPECT_TRUE(sender.Blocked());
+    EXPECT_EQ(SOFTBUS_OK, sender.Result(EXPIRE_WAIT_MS));
+    EXPECT_GE(std::chrono::steady_clock::now() - start, std::chrono::seconds(1));
+
+    /* the window was filled at once, so every packet in it expired together */
+    int32_t result = SOFTBUS_OK;
+    for (int32_t seq = 0; seq < PENDING_WINDOW_DEFAULT; seq++) {
+        EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, seq, &result));
+        EXPECT_EQ(SOFTBUS_TIMOUT, result);
+    }
+    EXPECT_NE(SOFTBUS_OK, SetPendingPacket(TEST_CHANNEL_A, 0, TEST_TYPE));
+};
+
+/*
+ * @tc.name: testPendingExpire005
+ * @tc.desc: the last packet of a type expires from the softbus timer, with no other pending traffic after it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingExpire005, TestSize.Level1)
+{
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE));
+    /* what HandleTimeoutFun does once a second */
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(EXPIRE_WAIT_MS);
+    while (Completed().empty() && std::chrono::steady_clock::now() < deadline) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(TIMER_TIMEOUT));
+        TimerWheelTick();
+    }
+    int32_t result = SOFTBUS_OK;
+    EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, 1, &result));
+    EXPECT_EQ(SOFTBUS_TIMOUT, result);
+};
+
+/*
+ * @tc.name: testPendingDel006
+ * @tc.desc: deleting a channel completes each of its packets as closed and wakes the senders blocked on it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingDel006, TestSize.Level1)
+{
+    FillWindow(TEST_CHANNEL_A);
+    EXPECT_EQ(SOFTBUS_OK, AddPendingPacket(TEST_CHANNEL_B, 0, TEST_TYPE));
+    std::vector<std::unique_ptr<Sender>> senders;
+    for (int32_t i = 0; i < 2; i++) {
+        senders.emplace_back(new Sender(TEST_CHANNEL_A, PENDING_WINDOW_DEFAULT + i));
+    }
+    for (auto &sender : senders) {
+        EXPECT_TRUE(sender->Blocked());
+    }
+
+    EXPECT_EQ(SOFTBUS_OK, DelPendingPacket(TEST_CHANNEL_A, TEST_TYPE));
+    for (auto &sender : senders) {
+        EXPECT_EQ(SOFTBUS_OK, sender->Result(SENDER_WAIT_MS));
+    }
+    int32_t result = SOFTBUS_OK;
+    for (int32_t seq = 0; seq < PENDING_WINDOW_DEFAULT; seq++) {
+        EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, seq, &result));
+        EXPECT_EQ(SOFTBUS_TRANS_PENDING_CHANNEL_CLOSED, result);
+    }
+    EXPECT_EQ(0, CompleteCount(TEST_CHANNEL_B, 0));
+    EXPECT_EQ(SOFTBUS_OK, DelPendingPacket(TEST_CHANNEL_PROBE, TEST_TYPE));
+};
+
+/*
+ * @tc.name: testPendingComplete007
+ * @tc.desc: the complete callback runs once per packet and without the pending lock, it may call back in
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransPendingPktTest, testPendingComplete007, TestSize.Level1)
+{
+    FillWindow(TEST_CHANNEL_A);
+    g_probeInCallback = true;
+    std::atomic<bool> finished(false);
+    std::thread worker([&finished]() {
+        (void)SetPendingPacket(TEST_CHANNEL_A, 0, TEST_TYPE);
+        (void)CancelPendingPacket(TEST_CHANNEL_A, 1, TEST_TYPE, SOFTBUS_ERR);
+        (void)DelPendingPacket(TEST_CHANNEL_A, TEST_TYPE);
+        finished = true;
+    });
+    bool done = WaitUntil(finished, SENDER_WAIT_MS);
+    EXPECT_TRUE(done) << "complete callback ran with the pending lock held";
+    if (!done) {
+        g_wedged = true;
+        worker.detach();
+        return;
+    }
+    worker.join();
+    g_probeInCallback = false;
+
+    EXPECT_EQ(static_cast<size_t>(PENDING_WINDOW_DEFAULT), Completed().size());
+    for (int32_t seq = 0; seq < PENDING_WINDOW_DEFAULT; seq++) {
+        EXPECT_EQ(1, CompleteCount(TEST_CHANNEL_A, seq));
+    }
+};
+}
@@ -0,0 +1,543 @@
+/*
+ * Copyright (c) 2021 Huawei Device Co., Ltd.
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *     http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include <securec.h>
+#include <string>
+#include <vector>
+
+#include "gtest/gtest.h"
+#include "auth_interface.h"
+#include "cJSON.h"
+#include "softbus_adapter_crypto.h"
+#include "softbus_adapter_mem.h"
+#include "softbus_errcode.h"
+#include "softbus_proxychannel_callback.h"
+#include "softbus_timer_wheel.h"
+#include "trans_pending_pkt.h"
+
+extern "C" {
+#include "softbus_proxychannel_manager.h"
+#include "softbus_proxychannel_message.h"
+#include "softbus_proxychannel_session.h"
+#include "softbus_proxychannel_transceiver.h"
+}
+
+using namespace testing::ext;
+
+namespace OHOS {
+#define TEST_CHANNEL_ID 1
+#define TEST_CONN_ID 2
+#define TEST_MSG_LEN 4096
+#define TEST_LINK_RECV_MAX 3000
+#define TEST_LINK_SEND_UNIT 1500
+
+/* wire layout of the heads in front of every slice and of every packet, see softbus_proxychannel_session.c */
+typedef struct {
+    int32_t priority;
+    int32_t sliceNum;
+    int32_t sliceSeq;
+    int32_t reserved;
+} TestSliceHead;
+
+typedef struct {
+    int32_t magicNumber;
+    int32_t seq;
+    int32_t flags;
+    int32_t dataLen;
+} TestPacketHead;
+
+static SoftBusCipherCtx *g_cipherCtx = NULL;
+static int32_t g_chanSeq = 0;
+/* what TransProxyTransSendMsgVec was given, each slice from its SliceHead on */
+static std::vector<std::string> g_slices;
+static std::vector<std::string> g_received;
+/* what ConnGetLinkLimit reports, and the peer max slice len the channel of TEST_CHANNEL_ID holds */
+static int32_t g_linkLimitRet = SOFTBUS_ERR;
+static ConnLinkLimit g_linkLimit;
+static uint32_t g_peerSliceMax = 0;
+
+extern "C" {
+SoftBusCipherCtx *TransProxyGetCipherCtxByChanId(int32_t channelId)
+{
+    (void)channelId;
+    SoftBusAcquireCipherCtx(g_cipherCtx);
+    return g_cipherCtx;
+}
+
+int32_t TransProxyGetNewChanSeq(int32_t channelId)
+{
+    (void)channelId;
+    return g_chanSeq++;
+}
+
+int32_t TransProxyGetSendMsgChanInfo(int32_t channelId, ProxyChannelDataView *chan)
+{
+    (void)memset_s(chan, sizeof(ProxyChannelDataView), 0, sizeof(ProxyChannelDataView));
+    chan->channelId = channelId;
+    chan->connId = TEST_CONN_ID;
+    chan->peerSliceMax = g_peerSliceMax;
+    chan->status = PROXY_CHANNEL_STATUS_COMPLETED;
+    return SOFTBUS_OK;
+}
+
+int32_t TransProxyTransSendMsgVec(uint32_t connectionId, const ConnIoVec *iov, int32_t iovCnt, int32_t priority)
+{
+    (void)connectionId;
+    (void)priority;
+    std::string slice;
+    for (int32_t i = 1; i < iovCnt; i++) {
+        slice.append(iov[i].base, iov[i].len);
+    }
+    g_slices.push_back(slice);
+    return SOFTBUS_OK;
+}
+
+int32_t TransProxyTransSendMsg(uint32_t connectionId, char *buf, int32_t len, int32_t priority)
+{
+    (void)connectionId;
+    (void)len;
+    (void)priority;
+    SoftBusFree(buf);
+    return SOFTBUS_OK;
+}
+
+int32_t TransProxyGetConnectOption(uint32_t connectionId, ConnectOption *info)
+{
+    (void)connectionId;
+    (void)info;
+    return SOFTBUS_ERR;
+}
+
+int32_t TransProxyGetChiperSide(int32_t channelId, int32_t *side)
+{
+    (void)channelId;
+    (void)side;
+    return SOFTBUS_ERR;
+}
+
+uint32_t AuthGetEncryptHeadLen(void)
+{
+    return 0;
+}
+
+int32_t AuthEncrypt(const ConnectOption *option, AuthSideFlag *side, uint8_t *data, uint32_t len, OutBuf *outBuf)
+{
+    (void)option;
+    (void)side;
+    (void)data;
+    (void)len;
+    (void)outBuf;
+    return SOFTBUS_ERR;
+}
+
+int32_t AuthDecrypt(const ConnectOption *option, AuthSideFlag side, uint8_t *data, uint32_t len, OutBuf *outbuf)
+{
+    (void)option;
+    (void)side;
+    (void)data;
+    (void)len;
+    (void)outbuf;
+    return SOFTBUS_ERR;
+}
+
+int32_t TransProxyOnMsgReceived(const char *pkgName, int32_t channelId, const void *data, uint32_t len, int32_t type)
+{
+    (void)pkgName;
+    (void)channelId;
+    (void)type;
+    g_received.push_back(std::string((const char *)data, len));
+    return SOFTBUS_OK;
+}
+
+uint32_t ConnGetHeadSize(void)
+{
+    return 0;
+}
+
+int32_t ConnGetLinkLimit(uint32_t connectionId, ConnLinkLimit *limit)
+{
+    (void)connectionId;
+    *limit = g_linkLimit;
+    return g_linkLimitRet;
+}
+
+int32_t ConnGetSendWindow(uint32_t connectionId, uint32_t *window)
+{
+    (void)connectionId;
+    (void)window;
+    return SOFTBUS_ERR;
+}
+
+int32_t AddPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    (void)channelId;
+    (void)seqNum;
+    (void)type;
+    return SOFTBUS_OK;
+}
+
+int32_t SetPendingPacket(int32_t channelId, int32_t seqNum, int type)
+{
+    (void)channelId;
+    (void)seqNum;
+    (void)type;
+    return SOFTBUS_OK;
+}
+
+int32_t CancelPendingPacket(int32_t channelId, int32_t seqNum, int type, int32_t reason)
+{
+    (void)channelId;
+    (void)seqNum;
+    (void)type;
+    (void)reason;
+    return SOFTBUS_OK;
+}
+}
+
+class TransProxySessionTest : public testing::Test {
+public:
+    TransProxySessionTest()
+    {}
+    ~TransProxySessionTest()
+    {}
+    static void SetUpTestCase(void);
+    static void TearDownTestCase(void);
+    void SetUp() override;
+    void TearDown() override;
+};
+
+void TransProxySessionTest::SetUpTestCase(void)
+{
+    const unsigned char key[SESSION_KEY_LENGTH] = { 1, 2, 3, 4 };
+    g_cipherCtx = SoftBusCreateCipherCtx(key, sizeof(key));
+    ASSERT_TRUE(g_cipherCtx != NULL);
+    ASSERT_EQ(SOFTBUS_OK, TransSliceManagerInit());
+}
+
+void TransProxySessionTest::TearDownTestCase(void)
+{
+    TransSliceManagerDeInit();
+    SoftBusReleaseCipherCtx(g_cipherCtx);
+    g_cipherCtx = NULL;
+}
+
+void TransProxySessionTest::SetUp()
+{
+    g_slices.clear();
+    g_received.clear();
+    g_linkLimitRet = SOFTBUS_ERR;
+    (void)memset_s(&g_linkLimit, sizeof(g_linkLimit), 0, sizeof(g_linkLimit));
+    g_peerSliceMax = 0;
+}
+
+void TransProxySessionTest::TearDown()
+{
+    (void)TransProxyDelSliceProcessorByChannelId(TEST_CHANNEL_ID);
+}
+
+static std::string TestMessage(uint32_t len)
+{
+    std::string msg;
+    for (uint32_t i = 0; i < len; i++) {
+        msg.push_back((char)(i * 7 + 1));
+    }
+    return msg;
+}
+
+static int32_t FeedSlice(const std::string &slice)
+{
+    return TransOnNormalMsgReceived("pkgName", TEST_CHANNEL_ID, slice.data(), slice.size());
+}
+
+/* the packet head travels at the start of the first slice */
+static TestPacketHead *FirstPacketHead(std::string &slice)
+{
+    return (TestPacketHead *)&slice[sizeof(TestSliceHead)];
+}
+
+/*
+ * @tc.name: testSliceReassemble001
+ * @tc.desc: slices fed in order are reassembled into the message that was posted
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testSliceReassemble001, TestSize.Level1)
+{
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    ASSERT_GT(g_slices.size(), 2U);
+    for (size_t i = 0; i < g_slices.size(); i++) {
+        EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[i]));
+    }
+    ASSERT_EQ(1U, g_received.size());
+    EXPECT_TRUE(g_received[0] == msg);
+};
+
+/*
+ * @tc.name: testSliceReassemble002
+ * @tc.desc: the short last slice arrives first and the others in reverse, it is placed once sliceLen is known
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testSliceReassemble002, TestSize.Level1)
+{
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    ASSERT_GT(g_slices.size(), 2U);
+    ASSERT_LT(g_slices.back().size(), g_slices.front().size());
+    for (size_t i = g_slices.size(); i > 0; i--) {
+        EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[i - 1]));
+        EXPECT_EQ((i == 1) ? 1U : 0U, g_received.size());
+    }
+    ASSERT_EQ(1U, g_received.size());
+    EXPECT_TRUE(g_received[0] == msg);
+};
+
+/*
+ * @tc.name: testSliceReassemble003
+ * @tc.desc: a slice seen twice restarts the message, a complete resend is still delivered exactly once
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testSliceReassemble003, TestSize.Level1)
+{
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    ASSERT_GT(g_slices.size(), 2U);
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[0]));
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[1]));
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[1]));
+    /* slice 0 went with the restart, the message cannot complete without it */
+    for (size_t i = 2; i < g_slices.size(); i++) {
+        EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[i]));
+    }
+    EXPECT_EQ(0U, g_received.size());
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[0]));
+    ASSERT_EQ(1U, g_received.size());
+    EXPECT_TRUE(g_received[0] == msg);
+};
+
+/*
+ * @tc.name: testSliceReassemble004
+ * @tc.desc: a middle slice shorter than the first one, or a last slice longer, drops the message
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testSliceReassemble004, TestSize.Level1)
+{
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    ASSERT_GT(g_slices.size(), 2U);
+    std::vector<std::string> slices = g_slices;
+
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(slices[0]));
+    std::string shortSlice = slices[1].substr(0, slices[1].size() - 1);
+    EXPECT_EQ(SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_NO_INVALID, FeedSlice(shortSlice));
+    for (size_t i = 1; i < slices.size(); i++) {
+        EXPECT_EQ(SOFTBUS_OK, FeedSlice(slices[i]));
+    }
+    EXPECT_EQ(0U, g_received.size());
+    (void)TransProxyDelSliceProcessorByChannelId(TEST_CHANNEL_ID);
+
+    EXPECT_EQ(SOFTBUS_OK, FeedSlice(slices[0]));
+    std::string longLast = slices.back() + std::string(slices[0].size(), 'x');
+    EXPECT_EQ(SOFTBUS_TRANS_PROXY_ASSEMBLE_PACK_NO_INVALID, FeedSlice(longLast));
+    EXPECT_EQ(0U, g_received.size());
+};
+
+/*
+ * @tc.name: testSliceReassemble005
+ * @tc.desc: packets shorter than their heads, or whose dataLen claims more than arrived, are refused
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testSliceReassemble005, TestSize.Level1)
+{
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), 100,
+        TRANS_SESSION_BYTES));
+    ASSERT_EQ(1U, g_slices.size());
+    std::string single = g_slices[0];
+
+    std::string truncated = single.substr(0, sizeof(TestSliceHead) + sizeof(TestPacketHead) / 2);
+    EXPECT_NE(SOFTBUS_OK, FeedSlice(truncated));
+    truncated = single.substr(0, single.size() - 1);
+    EXPECT_EQ(SOFTBUS_TRANS_INVALID_DATA_LENGTH, FeedSlice(truncated));
+    std::string forged = single;
+    FirstPacketHead(forged)->dataLen++;
+    EXPECT_EQ(SOFTBUS_TRANS_INVALID_DATA_LENGTH, FeedSlice(forged));
+    EXPECT_EQ(0U, g_received.size());
+
+    /* a forged length in a sliced message only shows once every slice is in */
+    g_slices.clear();
+    ASSERT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    ASSERT_GT(g_slices.size(), 2U);
+    FirstPacketHead(g_slices[0])->dataLen += (int32_t)g_slices[0].size();
+    for (size_t i = 0; i + 1 < g_slices.size(); i++) {
+        EXPECT_EQ(SOFTBUS_OK, FeedSlice(g_slices[i]));
+    }
+    EXPECT_EQ(SOFTBUS_TRANS_INVALID_DATA_LENGTH, FeedSlice(g_slices.back()));
+    EXPECT_EQ(0U, g_received.size());
+};
+
+/* what TransProxyGetSliceLen takes off a link write for the heads in front of the slice data */
+#define TEST_SLICE_OVERHEAD (sizeof(TestSliceHead) + sizeof(ProxyMessageHead))
+#define TEST_PEER_SLICE_MAX 2000
+#define TEST_PEER_SLICE_SMALL 1000
+
+/* a handshake or ack as this end would send it, with MAX_SLICE_LEN replaced by value, or left out for NULL */
+static std::string PackHandshake(bool ack, const char *value)
+{
+    ProxyChannelInfo *info = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
+    if (info == NULL) {
+        return "";
+    }
+    info->connId = TEST_CONN_ID;
+    info->appInfo.appType = APP_TYPE_AUTH;
+    char *buf = ack ? TransProxyPackHandshakeAckMsg(info) : TransProxyPackHandshakeMsg(info);
+    SoftBusFree(info);
+    if (buf == NULL) {
+        return "";
+    }
+    std::string msg(buf);
+    cJSON_free(buf);
+
+    std::string key = std::string("\"") + JSON_KEY_MAX_SLICE_LEN + "\":";
+    size_t start = msg.find(key);
+    if (start == std::string::npos) {
+        return "";
+    }
+    size_t end = msg.find_first_of(",}", start);
+    if (value != NULL) {
+        return msg.replace(start + key.size(), end - start - key.size(), value);
+    }
+    if (msg[end] == ',') {
+        end++;
+    } else if (start > 0 && msg[start - 1] == ',') {
+        start--;
+    }
+    return msg.erase(start, end - start);
+}
+
+/* the peer max slice len a received handshake or ack leaves on the channel */
+static uint32_t UnpackPeerSliceMax(bool ack, const std::string &msg)
+{
+    ProxyChannelInfo *chan = (ProxyChannelInfo *)SoftBusCalloc(sizeof(ProxyChannelInfo));
+    if (chan == NULL) {
+        return 0;
+    }
+    chan->connId = TEST_CONN_ID;
+    int32_t ret = ack ? TransProxyUnpackHandshakeAckMsg(msg.c_str(), chan) :
+        TransProxyUnpackHandshakeMsg(msg.c_str(), chan);
+    EXPECT_EQ(SOFTBUS_OK, ret) << msg;
+    uint32_t sliceMax = chan->peerSliceMax;
+    SoftBusFree(chan);
+    return sliceMax;
+}
+
+/* the data length of the first slice a TEST_MSG_LEN message is cut into */
+static size_t FirstSliceLen(void)
+{
+    g_slices.clear();
+    std::string msg = TestMessage(TEST_MSG_LEN);
+    EXPECT_EQ(SOFTBUS_OK, TransProxyPostSessionData(TEST_CHANNEL_ID, (const uint8_t *)msg.data(), msg.size(),
+        TRANS_SESSION_BYTES));
+    if (g_slices.size() < 2) {
+        return 0;
+    }
+    return g_slices[0].size() - sizeof(TestSliceHead);
+}
+
+/*
+ * @tc.name: testPeerSliceMax001
+ * @tc.desc: a handshake or ack carries the local max slice len, one without the key leaves the legacy 1024
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testPeerSliceMax001, TestSize.Level1)
+{
+    g_linkLimitRet = SOFTBUS_OK;
+    g_linkLimit.recvMax = TEST_LINK_RECV_MAX;
+    uint32_t localMax = TransProxyGetRecvSliceMax(TEST_CONN_ID);
+    EXPECT_GT(localMax, (uint32_t)PROXY_SLICE_LEN_LEGACY);
+    EXPECT_LT(localMax, (uint32_t)TEST_LINK_RECV_MAX);
+    for (bool ack : { false, true }) {
+        std::string msg = PackHandshake(ack, std::to_string(localMax).c_str());
+        ASSERT_FALSE(msg.empty());
+        EXPECT_EQ(localMax, UnpackPeerSliceMax(ack, msg));
+        msg = PackHandshake(ack, NULL);
+        ASSERT_FALSE(msg.empty());
+        EXPECT_EQ(std::string::npos, msg.find(JSON_KEY_MAX_SLICE_LEN));
+        EXPECT_EQ(0U, UnpackPeerSliceMax(ack, msg));
+    }
+
+    g_peerSliceMax = 0;
+    EXPECT_EQ((size_t)PROXY_SLICE_LEN_LEGACY, FirstSliceLen());
+};
+
+/*
+ * @tc.name: testPeerSliceMax002
+ * @tc.desc: a peer max below PROXY_SLICE_LEN_MIN is ignored, one above what this link takes is cut down to it
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testPeerSliceMax002, TestSize.Level1)
+{
+    const std::string tooSmall = std::to_string(PROXY_SLICE_LEN_MIN - 1);
+    const std::string tooLarge = std::to_string(TEST_LINK_RECV_MAX * 100);
+    g_linkLimitRet = SOFTBUS_OK;
+    g_linkLimit.recvMax = TEST_LINK_RECV_MAX;
+    uint32_t localMax = TransProxyGetRecvSliceMax(TEST_CONN_ID);
+    for (bool ack : { false, true }) {
+        EXPECT_EQ(0U, UnpackPeerSliceMax(ack, PackHandshake(ack, tooSmall.c_str())));
+        EXPECT_EQ(localMax, UnpackPeerSliceMax(ack, PackHandshake(ack, tooLarge.c_str())));
+    }
+
+    /* a link that does not say what it takes is held to the legacy slice len */
+    g_linkLimitRet = SOFTBUS_ERR;
+    for (bool ack : { false, true }) {
+        EXPECT_EQ((uint32_t)PROXY_SLICE_LEN_LEGACY, UnpackPeerSliceMax(ack, PackHandshake(ack, tooLarge.c_str())));
+    }
+};
+
+/*
+ * @tc.name: testPeerSliceMax003
+ * @tc.desc: messages are cut into slices of the smaller of the peer max and one write of the link
+ * @tc.type: FUNC
+ * @tc.require:
+ */
+HWTEST_F(TransProxySessionTest, testPeerSliceMax003, TestSize.Level1)
+{
+    g_linkLimitRet = SOFTBUS_OK;
+    g_linkLimit.recvMax = TEST_LINK_RECV_MAX;
+    std::string msg = PackHandshake(false, std::to_string(TEST_PEER_SLICE_MAX).c_str());
+    g_peerSliceMax = UnpackPeerSliceMax(false, msg);
+    EXPECT_EQ((uint32_t)TEST_PEER_SLICE_MAX, g_peerSliceMax);
+
+    /* a stream link writes any length in one go */
+    g_linkLimit.sendUnit = 0;
+    EXPECT_EQ((size_t)TEST_PEER_SLICE_MAX, FirstSliceLen());
+    g_linkLimit.sendUnit = TEST_LINK_SEND_UNIT;
+    EXPECT_EQ(TEST_LINK_SEND_UNIT - TEST_SLICE_OVERHEAD, FirstSliceLen());
+
+    g_peerSliceMax = UnpackPeerSliceMax(false, PackHandshake(false, std::to_string(TEST_PEER_SLICE_SMALL).c_str()));
+    EXPECT_EQ((size_t)TEST_PEER_SLICE_SMALL, FirstSliceLen());
+};
+}
@@ -20,6 +20,8 @@ extern "C" {
 #endif
 
 void TestMessageHandler();
+void TestMessageHandlerGroup();
+void TestLooperStats();
 void BrConnectionTest();
 void TestMain();
 